@@ -77,28 +77,41 @@
 
 #define SCHED_TASK(func, rate_hz, max_time_micros) SCHED_TASK_CLASS(Copter, &copter, func, rate_hz, max_time_micros)
 
+/*
+  tasks that can change the motors, the rate PIDs or the servo outputs
+  (arming, mode changes, failsafes, servos) run holding the rate thread's
+  output lock. The others run without it so the rate thread is never held
+  up by logging, telemetry or navigation
+ */
+#define SCHED_TASK_LOCKED(func, _rate_hz, _max_time_micros) { \
+    .function = FUNCTOR_BIND(&copter, &Copter::rate_thread_locked<&Copter::func>, void),\
+    AP_SCHEDULER_NAME_INITIALIZER(func)\
+    .rate_hz = _rate_hz,\
+    .max_time_micros = _max_time_micros\
+}
+
 /*
   scheduler table for fast CPUs - all regular tasks apart from the fast_loop()
   should be listed here, along with how often they should be called (in hz)
   and the maximum time they are expected to take (in microseconds)
  */
 const AP_Scheduler::Task Copter::scheduler_tasks[] = {
-    SCHED_TASK(rc_loop,              100,    130),
-    SCHED_TASK(throttle_loop,         50,     75),
+    SCHED_TASK_LOCKED(rc_loop,       100,    130),
+    SCHED_TASK_LOCKED(throttle_loop,  50,     75),
     SCHED_TASK(update_GPS,            50,    200),
 #if OPTFLOW == ENABLED
     SCHED_TASK(update_optical_flow,  200,    160),
 #endif
-    SCHED_TASK(update_batt_compass,   10,    120),
-    SCHED_TASK(read_aux_switches,     10,     50),
-    SCHED_TASK(arm_motors_check,      10,     50),
-    SCHED_TASK(auto_disarm_check,     10,     50),
+    SCHED_TASK_LOCKED(update_batt_compass, 10,    120),
+    SCHED_TASK_LOCKED(read_aux_switches, 10,     50),
+    SCHED_TASK_LOCKED(arm_motors_check, 10,     50),
+    SCHED_TASK_LOCKED(auto_disarm_check, 10,     50),
     SCHED_TASK(auto_trim,             10,     75),
     SCHED_TASK(read_rangefinder,      20,    100),
     SCHED_TASK(update_altitude,       10,    100),
-    SCHED_TASK(run_nav_updates,       50,    100),
-    SCHED_TASK(update_throttle_hover,100,     90),
-    SCHED_TASK(three_hz_loop,          3,     75),
+    SCHED_TASK_LOCKED(run_nav_updates, 50,    100),
+    SCHED_TASK_LOCKED(update_throttle_hover,100,     90),
+    SCHED_TASK_LOCKED(three_hz_loop,   3,     75),
     SCHED_TASK(compass_accumulate,   100,    100),
     SCHED_TASK(barometer_accumulate,  50,     90),
 #if PRECISION_LANDING == ENABLED
@@ -108,16 +121,16 @@ const AP_Scheduler::Task Copter::scheduler_tasks[] = {
     SCHED_TASK(check_dynamic_flight,  50,     75),
 #endif
     SCHED_TASK(update_notify,         50,     90),
-    SCHED_TASK(one_hz_loop,            1,    100),
-    SCHED_TASK(ekf_check,             10,     75),
-    SCHED_TASK(landinggear_update,    10,     75),
+    SCHED_TASK_LOCKED(one_hz_loop,     1,    100),
+    SCHED_TASK_LOCKED(ekf_check,      10,     75),
+    SCHED_TASK_LOCKED(landinggear_update, 10,     75),
     SCHED_TASK(lost_vehicle_check,    10,     50),
-    SCHED_TASK(gcs_check_input,      400,    180),
+    SCHED_TASK_LOCKED(gcs_check_input, 400,    180),
     SCHED_TASK(gcs_send_heartbeat,     1,    110),
     SCHED_TASK(gcs_send_deferred,     50,    550),
     SCHED_TASK(gcs_data_stream_send,  50,    550),
-    SCHED_TASK(update_mount,          50,     75),
-    SCHED_TASK(update_trigger,        50,     75),
+    SCHED_TASK_LOCKED(update_mount,   50,     75),
+    SCHED_TASK_LOCKED(update_trigger, 50,     75),
     SCHED_TASK(ten_hz_logging_loop,   10,    350),
     SCHED_TASK(twentyfive_hz_logging, 25,    110),
     SCHED_TASK(dataflash_periodic,    400,    300),
@@ -127,14 +140,14 @@ const AP_Scheduler::Task Copter::scheduler_tasks[] = {
     SCHED_TASK(compass_cal_update,   100,    100),
     SCHED_TASK(accel_cal_update,      10,    100),
 #if ADSB_ENABLED == ENABLED
-    SCHED_TASK(avoidance_adsb_update, 10,    100),
+    SCHED_TASK_LOCKED(avoidance_adsb_update, 10,    100),
 #endif
 #if ADVANCED_FAILSAFE == ENABLED
-    SCHED_TASK(afs_fs_check,          10,    100),
+    SCHED_TASK_LOCKED(afs_fs_check,   10,    100),
 #endif
     SCHED_TASK(terrain_update,        10,    100),
 #if EPM_ENABLED == ENABLED
-    SCHED_TASK(epm_update,            10,     75),
+    SCHED_TASK_LOCKED(epm_update,     10,     75),
 #endif
 #ifdef USERHOOK_FASTLOOP
     SCHED_TASK(userhook_FastLoop,    100,     75),
@@ -250,8 +263,15 @@ void Copter::fast_loop()
     // --------------------
     read_AHRS();
 
+    rate_thread_lock();
+
     // run low level rate controllers that only require IMU data
-    attitude_control.rate_controller_run();
+    if (rate_thread_running()) {
+        // the rate PIDs run on the rate thread, once per gyro sample
+        attitude_control.rate_controller_run_slow();
+    } else {
+        attitude_control.rate_controller_run();
+    }
     
 #if FRAME_CONFIG == HELI_FRAME
     update_heli_control_dynamics();
@@ -260,6 +280,8 @@ void Copter::fast_loop()
     // send outputs to the motors library
     motors_output();
 
+    rate_thread_unlock();
+
     // Inertial Nav
     // --------------------
     read_inertia();
@@ -267,6 +289,8 @@ void Copter::fast_loop()
     // check if ekf has reset target heading
     check_ekf_yaw_reset();
 
+    rate_thread_lock();
+
     // run the attitude controllers
     update_flight_mode();
 
@@ -276,6 +300,8 @@ void Copter::fast_loop()
     // check if we've landed or crashed
     update_land_and_crash_detectors();
 
+    rate_thread_unlock();
+
 #if MOUNT == ENABLED
     // camera mount's fast update
     camera_mount.update_fast();
@@ -56,6 +56,7 @@
 #include <AC_PID/AC_P.h>               // P library
 #include <AC_AttitudeControl/AC_AttitudeControl_Multi.h> // Attitude control library
 #include <AC_AttitudeControl/AC_AttitudeControl_Heli.h> // Attitude control library for traditional helicopter
+#include <AC_AttitudeControl/AC_AttitudeControl_RateThread.h> // rate controller thread (Linux only)
 #include <AC_AttitudeControl/AC_PosControl.h>      // Position control library
 #include <RC_Channel/RC_Channel.h>         // RC Channel Library
 #include <AP_Motors/AP_Motors.h>          // AP Motors library
@@ -502,6 +503,9 @@ private:
     AC_AttitudeControl_Heli attitude_control;
 #else
     AC_AttitudeControl_Multi attitude_control;
+#endif
+#if RATE_THREAD == ENABLED
+    AC_AttitudeControl_RateThread rate_thread;
 #endif
     AC_PosControl pos_control;
     AC_Avoid avoid;
@@ -989,6 +993,18 @@ private:
     bool arm_checks(bool display_failure, bool arming_from_gcs);
     void init_disarm_motors();
     void motors_output();
+    void rate_thread_init();
+    bool rate_thread_running();
+    void rate_thread_publish(bool output_enabled);
+    void rate_thread_lock();
+    void rate_thread_unlock();
+    bool rate_thread_failsafe(enum RateThreadFailsafe state);
+    template <void (Copter::*task)(void)>
+    void rate_thread_locked(void) {
+        rate_thread_lock();
+        (this->*task)();
+        rate_thread_unlock();
+    }
     void lost_vehicle_check();
     void run_nav_updates(void);
     void calc_distance_and_bearing();
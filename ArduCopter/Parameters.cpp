@@ -1007,7 +1007,17 @@ const AP_Param::GroupInfo ParametersG2::var_info[] = {
     // @Bitmask: 0:ADSBMavlinkProcessing
     // @User: Advanced
     AP_GROUPINFO("DEV_OPTIONS", 7, ParametersG2, dev_options, 0),
-    
+
+#if RATE_THREAD == ENABLED
+    // @Param: RATE_THREAD
+    // @DisplayName: Rate controller thread
+    // @Description: When enabled the rate controller and motor output run on their own high priority thread, once for every new sample from the primary gyro, instead of once per main loop. This lowers the delay from gyro to motors. The attitude and position controllers still run in the main loop. Only has an effect if the gyro is sampled faster than the main loop rate
+    // @Values: 0:Disabled,1:Enabled
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("RATE_THREAD", 8, ParametersG2, rate_thread_enable, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -565,6 +565,11 @@ public:
 
     // developer options
     AP_Int32 dev_options;
+
+#if RATE_THREAD == ENABLED
+    // run the rate controller on its own thread
+    AP_Int8 rate_thread_enable;
+#endif
 };
 
 extern const AP_Param::Info        var_info[];
@@ -672,3 +672,12 @@
 #ifndef ADVANCED_FAILSAFE
 # define ADVANCED_FAILSAFE DISABLED
 #endif
+
+// run the rate controller and motor output on their own thread at the gyro rate
+#ifndef RATE_THREAD
+ #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX && FRAME_CONFIG != HELI_FRAME
+  # define RATE_THREAD ENABLED
+ #else
+  # define RATE_THREAD DISABLED
+ #endif
+#endif
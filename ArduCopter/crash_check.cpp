@@ -46,6 +46,8 @@ void Copter::crash_check()
     if (crash_counter >= (CRASH_CHECK_TRIGGER_SEC * scheduler.get_loop_rate_hz())) {
         // log an error in the dataflash
         Log_Write_Error(ERROR_SUBSYSTEM_CRASH_CHECK, ERROR_CODE_CRASH_CHECK_CRASH);
+        // save what led up to it
+        DataFlash.blackbox_trigger();
         // send message to gcs
         gcs_send_text(MAV_SEVERITY_EMERGENCY,"Crash: Disarming");
         // disarm motors
@@ -129,6 +131,7 @@ void Copter::parachute_check()
         control_loss_count = 0;
         // log an error in the dataflash
         Log_Write_Error(ERROR_SUBSYSTEM_CRASH_CHECK, ERROR_CODE_CRASH_CHECK_LOSS_OF_CONTROL);
+        DataFlash.blackbox_trigger();
         // release parachute
         parachute_release();
     }
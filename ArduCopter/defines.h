@@ -277,6 +277,14 @@ enum LandStateType {
     LandStateType_Descending = 1
 };
 
+// main loop failsafe states handed to the rate thread, matching
+// AC_AttitudeControl_RateThread::failsafe_state
+enum RateThreadFailsafe {
+    RATE_THREAD_FAILSAFE_NONE = 0,
+    RATE_THREAD_FAILSAFE_MIN = 1,
+    RATE_THREAD_FAILSAFE_DISARM = 2
+};
+
 // bit options for DEV_OPTIONS parameter
 enum DevOptions {
     DevOptionADSBMAVLink = 1,
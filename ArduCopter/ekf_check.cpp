@@ -136,6 +136,7 @@ void Copter::failsafe_ekf_event()
     // EKF failsafe event has occurred
     failsafe.ekf = true;
     Log_Write_Error(ERROR_SUBSYSTEM_FAILSAFE_EKFINAV, ERROR_CODE_FAILSAFE_OCCURRED);
+    DataFlash.blackbox_trigger();
 
     // take action based on fs_ekf_action parameter
     switch (g.fs_ekf_action) {
@@ -44,6 +44,7 @@ void Copter::failsafe_check()
         failsafe_last_timestamp = tnow;
         if (in_failsafe) {
             in_failsafe = false;
+            rate_thread_failsafe(RATE_THREAD_FAILSAFE_NONE);
             Log_Write_Error(ERROR_SUBSYSTEM_CPU,ERROR_CODE_FAILSAFE_RESOLVED);
         }
         return;
@@ -55,17 +56,20 @@ void Copter::failsafe_check()
         // disarm the motors.
         in_failsafe = true;
         // reduce motors to minimum (we do not immediately disarm because we want to log the failure)
-        if (motors.armed()) {
+        if (!rate_thread_failsafe(RATE_THREAD_FAILSAFE_MIN) && motors.armed()) {
             motors.output_min();
         }
         // log an error
         Log_Write_Error(ERROR_SUBSYSTEM_CPU,ERROR_CODE_FAILSAFE_OCCURRED);
+        // the main loop is stuck, so the black box is written out by
+        // the IO thread with what the main loop last logged
+        DataFlash.blackbox_trigger();
     }
 
     if (failsafe_enabled && in_failsafe && tnow - failsafe_last_timestamp > 1000000) {
         // disarm motors every second
         failsafe_last_timestamp = tnow;
-        if(motors.armed()) {
+        if(!rate_thread_failsafe(RATE_THREAD_FAILSAFE_DISARM) && motors.armed()) {
             motors.armed(false);
             motors.output();
         }
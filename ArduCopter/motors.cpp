@@ -272,6 +272,7 @@ void Copter::motors_output()
     // the vehicle. Only used in extreme circumstances to meet the
     // OBC rules
     if (g2.afs.should_crash_vehicle()) {
+        rate_thread_publish(false);
         g2.afs.terminate_vehicle();
         return;
     }
@@ -284,6 +285,7 @@ void Copter::motors_output()
 
     // check if we are performing the motor test
     if (ap.motor_test) {
+        rate_thread_publish(false);
         motor_test_output();
     } else {
         bool interlock = motors.armed() && !ap.in_arming_delay && (!ap.using_interlock || ap.motor_interlock_switch) && !ap.motor_emergency_stop;
@@ -295,8 +297,13 @@ void Copter::motors_output()
             Log_Write_Event(DATA_MOTORS_INTERLOCK_DISABLED);
         }
 
-        // send output signals to motors
-        motors.output();
+        // send output signals to motors, or let the rate thread do
+        // it with the new targets
+        if (rate_thread_running()) {
+            rate_thread_publish(true);
+        } else {
+            motors.output();
+        }
     }
 }
 
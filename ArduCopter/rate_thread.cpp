@@ -0,0 +1,80 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+#include "Copter.h"
+
+//
+// functions to support running the rate controller on its own thread
+//
+
+// start the rate controller thread if enabled, must be called after the INS is initialised
+void Copter::rate_thread_init()
+{
+#if RATE_THREAD == ENABLED
+    if (g2.rate_thread_enable == 0) {
+        return;
+    }
+    if (!rate_thread.start(scheduler.get_loop_rate_hz())) {
+        gcs_send_text(MAV_SEVERITY_WARNING, "Rate thread: gyro not faster than loop");
+        return;
+    }
+    // motors are now updated at the rate thread rate
+    motors.set_loop_rate(rate_thread.get_rate_hz());
+    gcs_send_text_fmt(MAV_SEVERITY_INFO, "Rate thread running at %uHz", (unsigned)rate_thread.get_rate_hz());
+#endif
+}
+
+// true if the rate PIDs and motor output are run by the rate thread
+bool Copter::rate_thread_running()
+{
+#if RATE_THREAD == ENABLED
+    return rate_thread.running();
+#else
+    return false;
+#endif
+}
+
+// the main loop holds the rate thread's output lock around the code that
+// changes the motors, rate PIDs or servo outputs, so they are never
+// changed under the rate thread
+void Copter::rate_thread_lock()
+{
+#if RATE_THREAD == ENABLED
+    if (rate_thread.running()) {
+        rate_thread.output_lock();
+    }
+#endif
+}
+
+void Copter::rate_thread_unlock()
+{
+#if RATE_THREAD == ENABLED
+    if (rate_thread.running()) {
+        rate_thread.output_unlock();
+    }
+#endif
+}
+
+// called from the main loop failsafe. While the rate thread is running
+// it makes the failsafe motor output itself, so the failsafe must not
+// touch the motors when this returns true
+bool Copter::rate_thread_failsafe(enum RateThreadFailsafe state)
+{
+#if RATE_THREAD == ENABLED
+    if (rate_thread.running()) {
+        rate_thread.set_failsafe((enum AC_AttitudeControl_RateThread::failsafe_state)state);
+        return true;
+    }
+#endif
+    return false;
+}
+
+// hand the latest rate targets to the rate thread
+void Copter::rate_thread_publish(bool output_enabled)
+{
+#if RATE_THREAD == ENABLED
+    if (!rate_thread.running()) {
+        return;
+    }
+    rate_thread.publish(attitude_control.rate_bf_targets(), ahrs.get_gyro() - ins.get_gyro(), output_enabled);
+#endif
+}
@@ -271,6 +271,9 @@ void Copter::init_ardupilot()
 
     startup_INS_ground();
 
+    // optionally move the rate controller onto its own thread
+    rate_thread_init();
+
     // set landed flags
     set_land_complete(true);
     set_land_complete_maybe(true);
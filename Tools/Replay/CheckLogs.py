@@ -11,6 +11,7 @@ parser.add_option("--create-checked-logs", action='store_true', default=False, h
 parser.add_option("--tolerance-euler", type=float, default=3, help="tolerance for euler angles in degrees");
 parser.add_option("--tolerance-pos", type=float, default=2, help="tolerance for position angles in meters");
 parser.add_option("--tolerance-vel", type=float, default=2, help="tolerance for velocity in meters/second");
+parser.add_option("--perf-report", type='string', default=None, help="write EKF timing and memory use over all logs to this JSON file");
 
 opts, args = parser.parse_args()
 
@@ -27,14 +28,61 @@ def run_cmd(cmd, dir=".", show=False, output=False, checkfail=True):
         return call(cmd, shell=True, cwd=dir)
 
 def run_replay(logfile):
-    '''run Replay on one logfile'''
+    '''run Replay on one logfile, returning its perf report if asked for one'''
     print("Processing %s" % logfile)
     cmd = "./Replay.elf -- --check %s --tolerance-euler=%f --tolerance-pos=%f --tolerance-vel=%f " % (
         logfile,
         opts.tolerance_euler,
         opts.tolerance_pos,
         opts.tolerance_vel)
+    if opts.perf_report:
+        perf_file = "replay_perf_log.json"
+        try:
+            os.unlink(perf_file)
+        except OSError:
+            pass
+        cmd += "--perf-report=%s " % perf_file
     run_cmd(cmd, checkfail=False)
+    if not opts.perf_report:
+        return None
+    import json
+    try:
+        with open(perf_file) as f:
+            return json.load(f)
+    except (IOError, ValueError) as ex:
+        print("No perf report for %s: %s" % (logfile, ex))
+        return None
+
+def summarise_perf(reports):
+    '''combine the counters of the same name over all cores and logs'''
+    summary = {}
+    for report in reports:
+        for c in report['counters']:
+            if 'avg' not in c or c['count'] == 0:
+                continue
+            s = summary.setdefault(c['name'], {'count': 0, 'total': 0, 'max': 0, 'p99': 0})
+            s['count'] += c['count']
+            s['total'] += c['avg'] * c['count']
+            s['max'] = max(s['max'], c['max'])
+            # worst case over the logs, percentiles can't be merged exactly
+            s['p99'] = max(s['p99'], c['p99'])
+    for s in summary.values():
+        s['avg'] = s['total'] // s['count']
+        del s['total']
+    return summary
+
+def write_perf_report(reports):
+    '''write the perf reports of all logs with a summary'''
+    import json
+    git_version = run_cmd('git rev-parse HEAD', output=True).decode().strip()
+    result = {
+        'git_version': git_version,
+        'logs': reports,
+        'summary': summarise_perf(reports),
+    }
+    with open(opts.perf_report, "w") as f:
+        json.dump(result, f, indent=2, sort_keys=True)
+    print("Wrote perf report for %u logs to %s" % (len(reports), opts.perf_report))
 
 def get_log_list():
     '''get a list of log files to process'''
@@ -150,11 +198,17 @@ def check_logs():
         print(ex)
         pass
 
+    perf_reports = []
     for logfile in log_list:
-        run_replay(logfile)
+        report = run_replay(logfile)
+        if report is not None:
+            perf_reports.append(report)
 
     create_html_results()
 
+    if opts.perf_report:
+        write_perf_report(perf_reports)
+
 def create_checked_logs():
     '''create a set of CHEK logs'''
     import glob, os, sys
@@ -163,8 +163,8 @@ void LR_MsgHandler_GPS_Base::update_from_msg_gps(uint8_t gps_offset, uint8_t *ms
         ! field_value(msg, "numSV", nsats)) {
         field_not_found(msg, "NSats");
     }
-    uint16_t GWk;
-    uint32_t GMS;
+    uint16_t GWk = 0;
+    uint32_t GMS = 0;
     if (! field_value(msg, "GWk", GWk)) {
         field_not_found(msg, "GWk");
     }
@@ -64,7 +64,7 @@ struct MsgHandler::format_field_info *MsgHandler::find_field_info(const char *la
     return NULL;
 }
 
-MsgHandler::MsgHandler(const struct log_Format &_f) : next_field(0), f(_f)
+MsgHandler::MsgHandler(const struct log_Format &_f) : next_field(0), warned_field_not_found(false), f(_f)
 {
     init_field_types();
     parse_format_fields();
@@ -115,8 +115,7 @@ bool MsgHandler::field_value(uint8_t *msg, const char *label, char *ret, uint8_t
 {
     struct format_field_info *info = find_field_info(label);
     if (info == NULL) {
-      ::printf("No info for (%s)\n",label);
-      exit(1);
+        return false;
     }
 
     uint8_t offset = info->offset;
@@ -135,8 +134,10 @@ bool MsgHandler::field_value(uint8_t *msg, const char *label, char *ret, uint8_t
 bool MsgHandler::field_value(uint8_t *msg, const char *label, Vector3f &ret)
 {
     const char *axes = "XYZ";
-    uint8_t i;
-    for(i=0; i<next_field; i++) {
+    bool found = false;
+    // axes trimmed from the message by LOG_FLTn_MASK read as zero
+    ret.zero();
+    for(uint8_t i=0; i<next_field; i++) {
 	if (!strncmp(field_info[i].label, label, strlen(label)) &&
 	    strlen(field_info[i].label) == strlen(label)+1) {
 	    for (uint8_t j=0; j<3; j++) {
@@ -145,16 +146,14 @@ bool MsgHandler::field_value(uint8_t *msg, const char *label, Vector3f &ret)
                                                    field_info[i].type,
                                                    field_info[i].offset,
                                                    ret[j]);
+                    found = true;
                     break; // break from finding-label loop
                 }
             }
         }
-        if (i == next_field) {
-            return 0; // not found
-        }
     }
 
-    return true;
+    return found;
 }
 
 
@@ -245,18 +244,25 @@ void MsgHandler::attitude_from_msg(uint8_t *msg,
 
 void MsgHandler::field_not_found(uint8_t *msg, const char *label)
 {
+    // the message was logged with fewer fields, e.g. through
+    // LOG_FLTn_MASK. Only warn once per message type as this is
+    // called for every message
+    if (warned_field_not_found) {
+        return;
+    }
+    warned_field_not_found = true;
     char all_labels[256];
     uint8_t type = msg[2];
     string_for_labels(all_labels, 256);
-    ::printf("Field (%s) not found for id=%d; options are (%s)\n",
+    ::printf("Field (%s) not found for id=%d; options are (%s); using defaults\n",
              label, type, all_labels);
-    abort();
 }
 
 void MsgHandler::require_field(uint8_t *msg, const char *label, char *buffer, uint8_t bufferlen)
 {
     if (! field_value(msg, label, buffer, bufferlen)) {
         field_not_found(msg,label);
+        memset(buffer, '\0', bufferlen);
     }
 }
 
@@ -26,11 +26,16 @@ public:
     bool field_value(uint8_t *msg, const char *label,
 		     char *buffer, uint8_t bufferlen);
     
+    // require_field - retrieve the value of a field the handler
+    // needs. Fields can be left out of a message by LOG_FLTn_MASK, in
+    // which case the FMT for the message has no such field, a warning
+    // is printed and ret is set to its default value
     template <typename R>
     void require_field(uint8_t *msg, const char *label, R &ret)
         {   
             if (! field_value(msg, label, ret)) {
                 field_not_found(msg, label);
+                ret = R();
             }
         }
     void require_field(uint8_t *msg, const char *label, char *buffer, uint8_t bufferlen);
@@ -58,6 +63,7 @@ private:
     struct format_field_info field_info[LOGREADER_MAX_FIELDS];
 
     uint8_t next_field;
+    bool warned_field_not_found;
     size_t size_for_type_table[52]; // maps field type (e.g. 'f') to e.g 4 bytes
 
     struct format_field_info *find_field_info(const char *label);
@@ -85,7 +91,7 @@ protected:
 			   const char *label_roll,
 			   const char *label_pitch,
 			   const char *label_yaw);
-    [[noreturn]] void field_not_found(uint8_t *msg, const char *label);
+    void field_not_found(uint8_t *msg, const char *label);
 };
 
 template<typename R>
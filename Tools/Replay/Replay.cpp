@@ -28,6 +28,8 @@
 #include "DataFlashFileReader.h"
 #include "Replay.h"
 
+#include <AP_NavEKF2/AP_NavEKF2_core.h>
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include <SITL/SITL.h>
 #endif
@@ -154,6 +156,7 @@ void Replay::usage(void)
     ::printf("\t--logmatch         match logging rate to source\n");
     ::printf("\t--no-params        don't use parameters from the log\n");
     ::printf("\t--no-fpe           do not generate floating point exceptions\n");
+    ::printf("\t--perf-report FILE write EKF timing and memory use to FILE as JSON\n");
 }
 
 
@@ -169,6 +172,7 @@ enum {
     OPT_NOPARAMS,
     OPT_PARAM_FILE,
     OPT_NO_FPE,
+    OPT_PERF_REPORT,
 };
 
 void Replay::flush_dataflash(void) {
@@ -225,6 +229,7 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"logmatch",        false,  0, OPT_LOGMATCH},
         {"no-params",       false,  0, OPT_NOPARAMS},
         {"no-fpe",          false,  0, OPT_NO_FPE},
+        {"perf-report",     true,   0, OPT_PERF_REPORT},
         {0, false, 0, 0}
     };
 
@@ -308,6 +313,10 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             generate_fpe = false;
             break;
 
+        case OPT_PERF_REPORT:
+            perf_report_file = gopt.optarg;
+            break;
+
         case 'h':
         default:
             usage();
@@ -1017,6 +1026,10 @@ void Replay::loop()
 
     flush_dataflash();
 
+    if (perf_report_file) {
+        write_perf_report();
+    }
+
     if (check_solution) {
         report_checks();
     }
@@ -1068,6 +1081,85 @@ void Replay::report_checks(void)
     }
 }
 
+/*
+  write a JSON string, escaping the characters JSON requires
+ */
+static void json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', f);
+            fputc(*s, f);
+        } else if ((uint8_t)*s < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned)*s);
+        } else {
+            fputc(*s, f);
+        }
+    }
+    fputc('"', f);
+}
+
+/*
+  write the results of --perf-report: the perf counters, which give the
+  time spent in UpdateFilter() and in each fusion step, and the memory
+  used by the EKF2 cores. Times are in nanoseconds
+ */
+void Replay::write_perf_report(void)
+{
+    FILE *f = fopen(perf_report_file, "w");
+    if (f == NULL) {
+        perror(perf_report_file);
+        exit(1);
+    }
+
+    const NavEKF2 &ekf2 = _vehicle.EKF2;
+
+    fprintf(f, "{\n  \"log\": ");
+    json_string(f, log_filename);
+    fprintf(f, ",\n  \"ekf2_cores\": %u,\n", (unsigned)ekf2.activeCores());
+    fprintf(f, "  \"ekf2_core_size\": %u,\n", (unsigned)sizeof(NavEKF2_core));
+    fprintf(f, "  \"ekf2_memory_used\": %u,\n", (unsigned)ekf2.get_memory_used());
+    fprintf(f, "  \"counters\": [");
+
+    AP_HAL::Util::perf_counter_stats stats;
+    for (uint16_t i = 0; hal.util->perf_get_stats(i, stats); i++) {
+        fprintf(f, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+        if (strncmp(stats.name, "EK2_", 4) == 0) {
+            // every EKF2 core allocates the same counters when the cores
+            // are constructed, so earlier counters of the same name belong
+            // to the cores before this one
+            unsigned core = 0;
+            AP_HAL::Util::perf_counter_stats other;
+            for (uint16_t j = 0; j < i && hal.util->perf_get_stats(j, other); j++) {
+                if (strcmp(other.name, stats.name) == 0) {
+                    core++;
+                }
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "%s[%u]", stats.name, core);
+            json_string(f, name);
+        } else {
+            json_string(f, stats.name);
+        }
+        fprintf(f, ", \"count\": %llu", (unsigned long long)stats.count);
+        if (stats.type == AP_HAL::Util::PC_ELAPSED) {
+            fprintf(f, ", \"avg\": %llu, \"min\": %llu, \"max\": %llu"
+                    ", \"p50\": %llu, \"p99\": %llu, \"p999\": %llu",
+                    (unsigned long long)stats.avg,
+                    (unsigned long long)stats.min,
+                    (unsigned long long)stats.max,
+                    (unsigned long long)stats.p50,
+                    (unsigned long long)stats.p99,
+                    (unsigned long long)stats.p999);
+        }
+        fprintf(f, "}");
+    }
+
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+}
+
 /*
   parse a parameter file line
  */
@@ -143,6 +143,7 @@ private:
     uint16_t downsample = 0;
     bool logmatch = false;
     uint32_t output_counter = 0;
+    const char *perf_report_file = NULL;
 
     struct {
         float max_roll_error;
@@ -172,6 +173,7 @@ private:
     void log_check_solution();
     bool show_error(const char *text, float max_error, float tolerance);
     void report_checks();
+    void write_perf_report(void);
     bool find_log_info(struct log_information &info);
     const char **parse_list_from_string(const char *str);
     bool parse_param_line(char *line, char **vname, float &value);
@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+
+# run the Google Benchmark programs of a board build and gather their
+# results into a single JSON file, tagged with the git revision, so
+# timings can be tracked from one commit to the next.
+#
+# typical use from the top of the tree:
+#   ./waf configure --board sitl --enable-benchmarks
+#   ./waf benchmarks
+#   Tools/scripts/run_benchmarks.py --out benchmarks-$(git rev-parse --short HEAD).json
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import subprocess
+import sys
+
+topdir = os.path.join(os.path.dirname(os.path.realpath(__file__)), '../..')
+
+
+def git_revision():
+    try:
+        with open(os.devnull, 'w') as devnull:
+            return subprocess.check_output(['git', 'rev-parse', 'HEAD'],
+                                           cwd=topdir, stderr=devnull).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def find_benchmarks(board):
+    bindir = os.path.join(topdir, 'build', board, 'benchmarks')
+    if not os.path.isdir(bindir):
+        print("No benchmarks in %s; build them with './waf benchmarks'" % bindir,
+              file=sys.stderr)
+        sys.exit(1)
+    names = sorted(os.listdir(bindir))
+    return [os.path.join(bindir, n) for n in names
+            if os.access(os.path.join(bindir, n), os.X_OK)]
+
+
+def run_benchmark(path, opts):
+    cmd = [path, '--benchmark_format=json']
+    if opts.filter:
+        cmd.append('--benchmark_filter=%s' % opts.filter)
+    if opts.repetitions:
+        cmd.append('--benchmark_repetitions=%u' % opts.repetitions)
+    print("Running %s" % os.path.basename(path), file=sys.stderr)
+    try:
+        out = subprocess.check_output(cmd)
+    except subprocess.CalledProcessError as e:
+        print("%s failed with status %d" % (path, e.returncode), file=sys.stderr)
+        return None
+    out = out.decode().strip()
+    if not out:
+        # nothing matched the filter
+        return {}
+    return json.loads(out)
+
+
+if __name__ == '__main__':
+    parser = optparse.OptionParser("run_benchmarks.py [options]")
+    parser.add_option("--board", type='string', default='sitl',
+                      help='board whose build directory holds the benchmarks')
+    parser.add_option("--out", type='string', default=None,
+                      help='file to write the results to (default stdout)')
+    parser.add_option("--filter", type='string', default=None,
+                      help='only run benchmarks matching this regex')
+    parser.add_option("--repetitions", type='int', default=0,
+                      help='number of times each benchmark is repeated')
+    opts, args = parser.parse_args()
+
+    results = {
+        'git_revision': git_revision(),
+        'board': opts.board,
+        'programs': {},
+    }
+    failed = False
+    for path in find_benchmarks(opts.board):
+        result = run_benchmark(path, opts)
+        if result is None:
+            failed = True
+            continue
+        if not result:
+            continue
+        results['programs'][os.path.basename(path)] = result
+
+    if opts.out is None:
+        json.dump(results, sys.stdout, indent=2, sort_keys=True)
+        print()
+    else:
+        with open(opts.out, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    sys.exit(1 if failed else 0)
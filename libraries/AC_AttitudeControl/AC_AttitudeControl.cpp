@@ -588,9 +588,8 @@ Vector3f AC_AttitudeControl::update_ang_vel_target_from_att_error(Vector3f attit
 }
 
 // Run the roll angular velocity PID controller and return the output
-float AC_AttitudeControl::rate_target_to_motor_roll(float rate_target_rads)
+float AC_AttitudeControl::rate_target_to_motor_roll(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().x;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // pass error to PID controller
@@ -612,9 +611,8 @@ float AC_AttitudeControl::rate_target_to_motor_roll(float rate_target_rads)
 }
 
 // Run the pitch angular velocity PID controller and return the output
-float AC_AttitudeControl::rate_target_to_motor_pitch(float rate_target_rads)
+float AC_AttitudeControl::rate_target_to_motor_pitch(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().y;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // pass error to PID controller
@@ -636,9 +634,8 @@ float AC_AttitudeControl::rate_target_to_motor_pitch(float rate_target_rads)
 }
 
 // Run the yaw angular velocity PID controller and return the output
-float AC_AttitudeControl::rate_target_to_motor_yaw(float rate_target_rads)
+float AC_AttitudeControl::rate_target_to_motor_yaw(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().z;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // pass error to PID controller
@@ -240,7 +240,7 @@ void AC_AttitudeControl_Heli::rate_controller_run()
     if (_flags_heli.tail_passthrough) {
         _motors.set_yaw(_passthrough_yaw/4500.0f);
     } else {
-        _motors.set_yaw(rate_target_to_motor_yaw(_rate_target_ang_vel.z));
+        _motors.set_yaw(rate_target_to_motor_yaw(_rate_target_ang_vel.z, _ahrs.get_gyro().z));
     }
 }
 
@@ -358,17 +358,12 @@ void AC_AttitudeControl_Heli::rate_bf_to_motor_roll_pitch(float rate_roll_target
 }
 
 // rate_bf_to_motor_yaw - ask the rate controller to calculate the motor outputs to achieve the target rate in radians/second
-float AC_AttitudeControl_Heli::rate_target_to_motor_yaw(float rate_target_rads)
+float AC_AttitudeControl_Heli::rate_target_to_motor_yaw(float rate_target_rads, float current_rate_rads)
 {
     float pd,i,vff;     // used to capture pid values for logging
-    float current_rate_rads;     // this iteration's rate
     float rate_error_rads;       // simply target_rate - current_rate
     float yaw_out;
 
-    // get current rate
-    // To-Do: make getting gyro rates more efficient?
-    current_rate_rads = _ahrs.get_gyro().z;
-
     // calculate error and call pid controller
     rate_error_rads  = rate_target_rads - current_rate_rads;
 
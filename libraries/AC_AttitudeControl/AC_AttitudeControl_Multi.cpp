@@ -222,17 +222,33 @@ void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
 }
 
 void AC_AttitudeControl_Multi::rate_controller_run()
+{
+    rate_controller_run_pids(_rate_target_ang_vel, _ahrs.get_gyro());
+    rate_controller_run_slow();
+}
+
+void AC_AttitudeControl_Multi::rate_controller_run_pids(const Vector3f &rate_target_ang_vel, const Vector3f &gyro)
+{
+    _motors.set_roll(rate_target_to_motor_roll(rate_target_ang_vel.x, gyro.x));
+    _motors.set_pitch(rate_target_to_motor_pitch(rate_target_ang_vel.y, gyro.y));
+    _motors.set_yaw(rate_target_to_motor_yaw(rate_target_ang_vel.z, gyro.z));
+}
+
+void AC_AttitudeControl_Multi::rate_controller_run_slow()
 {
     // move throttle vs attitude mixing towards desired (called from here because this is conveniently called on every iteration)
     update_throttle_rpy_mix();
 
-    _motors.set_roll(rate_target_to_motor_roll(_rate_target_ang_vel.x));
-    _motors.set_pitch(rate_target_to_motor_pitch(_rate_target_ang_vel.y));
-    _motors.set_yaw(rate_target_to_motor_yaw(_rate_target_ang_vel.z));
-
     control_monitor_update();
 }
 
+void AC_AttitudeControl_Multi::set_rate_pid_dt(float dt)
+{
+    _pid_rate_roll.set_dt(dt);
+    _pid_rate_pitch.set_dt(dt);
+    _pid_rate_yaw.set_dt(dt);
+}
+
 // sanity check parameters.  should be called once before takeoff
 void AC_AttitudeControl_Multi::parameter_sanity_check()
 {
@@ -74,6 +74,18 @@ public:
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run();
 
+    // run only the body-frame rate PIDs against the given rate targets and
+    // body rates in radians/second, setting the motor roll, pitch and yaw.
+    // Used when the rate controller runs on its own thread, with
+    // rate_controller_run_slow() left in the main loop
+    void rate_controller_run_pids(const Vector3f &rate_target_ang_vel, const Vector3f &gyro);
+
+    // the parts of rate_controller_run() that stay at the main loop rate
+    void rate_controller_run_slow();
+
+    // set the time step of the rate PIDs in seconds
+    void set_rate_pid_dt(float dt);
+
     // sanity check parameters.  should be called once before take-off
     void parameter_sanity_check();
 
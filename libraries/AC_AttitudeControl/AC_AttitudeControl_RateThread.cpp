@@ -0,0 +1,178 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include "AC_AttitudeControl_RateThread.h"
+
+#include <errno.h>
+#include <time.h>
+
+#include <AP_HAL_Linux/Scheduler.h>
+
+extern const AP_HAL::HAL& hal;
+
+AC_AttitudeControl_RateThread::AC_AttitudeControl_RateThread(AP_InertialSensor &ins,
+                                                             AC_AttitudeControl_Multi &attitude_control,
+                                                             AP_MotorsMulticopter &motors)
+    : _ins(ins)
+    , _attitude_control(attitude_control)
+    , _motors(motors)
+    , _thread(FUNCTOR_BIND_MEMBER(&AC_AttitudeControl_RateThread::_run, void))
+    , _rate_hz(0)
+    , _dt(0)
+    , _dt_min(0)
+    , _dt_max(0)
+{
+    sem_init(&_sample_sem, 0, 0);
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_init(&_output_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+bool AC_AttitudeControl_RateThread::start(uint16_t main_loop_rate_hz)
+{
+    if (running()) {
+        return false;
+    }
+
+    uint16_t gyro_rate_hz = _ins.get_gyro_raw_sample_rate(_ins.get_primary_gyro());
+    if (main_loop_rate_hz == 0 || gyro_rate_hz <= main_loop_rate_hz) {
+        return false;
+    }
+
+    _rate_hz = gyro_rate_hz;
+    _dt = 1.0f / gyro_rate_hz;
+
+    // sensors that deliver their samples in blocks wake us less often
+    // than their sample rate, so the time step is measured, but never
+    // allowed past the main loop time step
+    _dt_min = 0.5f * _dt;
+    _dt_max = 1.0f / main_loop_rate_hz;
+
+    _attitude_control.set_rate_pid_dt(_dt);
+
+    if (!_thread.start("rate_control", SCHED_FIFO, AP_LINUX_RATE_CONTROL_SCHED_PRIO)) {
+        return false;
+    }
+
+    _ins.register_gyro_sample_cb(FUNCTOR_BIND_MEMBER(&AC_AttitudeControl_RateThread::_gyro_sample, void, const Vector3f &));
+
+    return true;
+}
+
+void AC_AttitudeControl_RateThread::publish(const Vector3f &rate_target_ang_vel,
+                                            const Vector3f &gyro_correction,
+                                            bool output_enabled)
+{
+    struct targets t;
+    t.rate_target_ang_vel = rate_target_ang_vel;
+    t.gyro_correction = gyro_correction;
+    t.time_us = AP_HAL::micros64();
+    t.output_enabled = output_enabled;
+    _targets.write(t);
+}
+
+void AC_AttitudeControl_RateThread::_gyro_sample(const Vector3f &gyro)
+{
+    _gyro.write(gyro);
+    sem_post(&_sample_sem);
+}
+
+bool AC_AttitudeControl_RateThread::_output_lock_unless_failsafe()
+{
+    while (true) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += AC_RATE_THREAD_LOCK_POLL_US * 1000UL;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        if (pthread_mutex_timedlock(&_output_mutex, &ts) == 0) {
+            return true;
+        }
+        if (_failsafe.load() != FAILSAFE_NONE) {
+            return false;
+        }
+    }
+}
+
+void AC_AttitudeControl_RateThread::_run()
+{
+    uint64_t last_run_us = 0;
+
+    while (true) {
+        if (sem_wait(&_sample_sem) != 0) {
+            // interrupted by a signal
+            continue;
+        }
+
+        // if we fell behind, only the latest sample matters
+        while (sem_trywait(&_sample_sem) == 0) {
+        }
+
+        // the targets are read under the lock, so once the main loop
+        // has cleared output_enabled no further output is made
+        bool locked = _output_lock_unless_failsafe();
+
+        // the main loop has stopped, so the failsafe output is ours
+        switch (_failsafe.load()) {
+        case FAILSAFE_MIN:
+            if (_motors.armed()) {
+                _motors.output_min();
+            }
+            if (locked) {
+                output_unlock();
+            }
+            continue;
+        case FAILSAFE_DISARM:
+            if (_motors.armed()) {
+                _motors.armed(false);
+                _motors.output();
+            }
+            if (locked) {
+                output_unlock();
+            }
+            continue;
+        default:
+            break;
+        }
+        if (!locked) {
+            // the failsafe was cleared while we waited
+            continue;
+        }
+
+        Vector3f gyro;
+        _gyro.read(gyro);
+
+        struct targets t;
+        _targets.read(t);
+
+        uint64_t now = AP_HAL::micros64();
+        if (last_run_us != 0) {
+            float dt = constrain_float((now - last_run_us) * 1.0e-6f, _dt_min, _dt_max);
+            _dt += (dt - _dt) * 0.01f;
+        }
+        last_run_us = now;
+
+        // if the main loop stops publishing, leave the motors to its
+        // failsafe rather than flying on stale targets
+        if (!t.output_enabled || now - t.time_us > AC_RATE_THREAD_TARGET_TIMEOUT_US) {
+            output_unlock();
+            continue;
+        }
+
+        _attitude_control.set_rate_pid_dt(_dt);
+        _attitude_control.rate_controller_run_pids(t.rate_target_ang_vel, gyro + t.gyro_correction);
+        _motors.output();
+
+        output_unlock();
+    }
+}
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_LINUX
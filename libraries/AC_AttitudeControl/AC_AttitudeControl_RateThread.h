@@ -0,0 +1,149 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/// @file    AC_AttitudeControl_RateThread.h
+/// @brief   runs the multicopter rate controller on its own thread at the gyro rate
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <AP_HAL_Linux/Thread.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_Motors/AP_MotorsMulticopter.h>
+#include "AC_AttitudeControl_Multi.h"
+
+#define AC_RATE_THREAD_TARGET_TIMEOUT_US    50000   // stop driving the motors if the main loop has not published targets for this long
+#define AC_RATE_THREAD_LOCK_POLL_US         1000    // how often the failsafe state is checked while waiting for the output lock
+
+/*
+  runs the body-frame rate PIDs and the motor output on a dedicated
+  SCHED_FIFO thread, once for every new filtered sample from the primary
+  gyro, instead of once per main loop.
+
+  The main loop keeps running the attitude and position controllers and
+  hands over its rate targets with publish(). Gyro samples come from the
+  sensor thread through the INS gyro sample callback. Both handoffs are
+  sequence locks with a single writer, so neither side ever waits for
+  the other.
+
+  The main loop still sets the throttle and spool state, resets the PID
+  integrators, runs the motor test and writes the aux servos, all of
+  which share the motor objects and the RCOutput driver with the rate
+  thread. So the rate thread only touches them while holding the output
+  lock, and the main loop holds it only around the code that does,
+  leaving the rate thread free to run through the EKF update, logging and
+  telemetry. The lock inherits priority, so the rate thread waiting for
+  it boosts the main loop for the short time it is held.
+
+  If the main loop stops, the failsafe tells the rate thread to drop the
+  motors to minimum and then disarm them with set_failsafe(), and the
+  rate thread does the output itself. It stops waiting for the output
+  lock once the failsafe is set, as the stuck main loop may be holding it.
+ */
+class AC_AttitudeControl_RateThread {
+public:
+    enum failsafe_state {
+        FAILSAFE_NONE   = 0,
+        FAILSAFE_MIN    = 1,    // motors held at minimum output
+        FAILSAFE_DISARM = 2,    // motors disarmed
+    };
+
+    AC_AttitudeControl_RateThread(AP_InertialSensor &ins,
+                                  AC_AttitudeControl_Multi &attitude_control,
+                                  AP_MotorsMulticopter &motors);
+
+    /* Do not allow copies */
+    AC_AttitudeControl_RateThread(const AC_AttitudeControl_RateThread &other) = delete;
+    AC_AttitudeControl_RateThread &operator=(const AC_AttitudeControl_RateThread&) = delete;
+
+    // start the thread. Fails if the primary gyro is not sampled faster
+    // than the main loop runs, as there would be nothing to gain
+    bool start(uint16_t main_loop_rate_hz);
+
+    // true once the thread is running the rate controller
+    bool running() const { return _thread.is_started(); }
+
+    // nominal rate the rate controller runs at in Hz
+    uint16_t get_rate_hz() const { return _rate_hz; }
+
+    // called by the main loop in place of the rate PIDs and
+    // motors.output(). gyro_correction is added to each gyro sample to
+    // get the body rates the AHRS would report, i.e. it removes the gyro
+    // bias estimate. Motors are only driven while output_enabled is set
+    void publish(const Vector3f &rate_target_ang_vel, const Vector3f &gyro_correction, bool output_enabled);
+
+    // output lock, held by any other thread using the motors, the rate
+    // PIDs or hal.rcout while the rate thread is running
+    void output_lock() { pthread_mutex_lock(&_output_mutex); }
+    void output_unlock() { pthread_mutex_unlock(&_output_mutex); }
+
+    // called by the main loop failsafe in place of writing to the motors
+    void set_failsafe(enum failsafe_state state) { _failsafe.store(state); }
+
+private:
+    // single writer sequence lock holding the latest value of T
+    template <typename T>
+    class seqlock {
+    public:
+        void write(const T &value) {
+            uint32_t seq = _seq.load(std::memory_order_relaxed);
+            _seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            _value = value;
+            _seq.store(seq + 2, std::memory_order_release);
+        }
+
+        void read(T &value) const {
+            uint32_t seq;
+            do {
+                seq = _seq.load(std::memory_order_acquire);
+                value = _value;
+                std::atomic_thread_fence(std::memory_order_acquire);
+            } while ((seq & 1) || seq != _seq.load(std::memory_order_relaxed));
+        }
+
+    private:
+        std::atomic<uint32_t> _seq{0};
+        T _value {};
+    };
+
+    struct targets {
+        Vector3f rate_target_ang_vel;
+        Vector3f gyro_correction;
+        uint64_t time_us;
+        bool output_enabled;
+    };
+
+    // INS gyro sample callback, runs on the sensor thread
+    void _gyro_sample(const Vector3f &gyro);
+
+    // take the output lock, giving up if the failsafe is set
+    bool _output_lock_unless_failsafe();
+
+    // thread body
+    void _run();
+
+    AP_InertialSensor &_ins;
+    AC_AttitudeControl_Multi &_attitude_control;
+    AP_MotorsMulticopter &_motors;
+
+    Linux::Thread _thread;
+    sem_t _sample_sem;
+    pthread_mutex_t _output_mutex;
+
+    seqlock<Vector3f> _gyro;
+    seqlock<struct targets> _targets;
+    std::atomic<uint8_t> _failsafe{FAILSAFE_NONE};
+
+    uint16_t _rate_hz;
+    float _dt;
+    float _dt_min;
+    float _dt_max;
+};
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_LINUX
@@ -0,0 +1,120 @@
+#include <AP_gbenchmark.h>
+
+#include <AC_AttitudeControl/AC_AttitudeControl_Multi.h>
+#include <AC_AttitudeControl/AC_PosControl.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Baro/AP_Baro.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_InertialNav/AP_InertialNav.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_Motors/AP_Motors.h>
+#include <AP_NavEKF/AP_NavEKF.h>
+#include <AP_NavEKF2/AP_NavEKF2.h>
+#include <AP_RangeFinder/AP_RangeFinder.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define LOOP_SECONDS 0.0025f
+
+/*
+ * the copter attitude and position controllers wired up as in ArduCopter,
+ * with the default gains. No sensors are started, so the AHRS reports a
+ * level, stationary vehicle and the controllers see the full error to
+ * their targets on every iteration.
+ */
+class Controllers {
+public:
+    Controllers()
+    {
+        aparm.angle_max.set(4500);
+        motors.setup_motors();
+        motors.armed(true);
+        pos_control.set_dt(LOOP_SECONDS);
+    }
+
+    AP_InertialSensor ins;
+    AP_Baro barometer;
+    AP_GPS gps;
+    AP_SerialManager serial_manager;
+    RangeFinder rangefinder {serial_manager};
+    NavEKF EKF {&ahrs, barometer, rangefinder};
+    NavEKF2 EKF2 {&ahrs, barometer, rangefinder};
+    AP_AHRS_NavEKF ahrs {ins, barometer, gps, rangefinder, EKF, EKF2,
+                         AP_AHRS_NavEKF::FLAG_ALWAYS_USE_EKF};
+    AP_InertialNav_NavEKF inertial_nav {ahrs};
+
+    AP_MotorsQuad motors {400};
+    AP_Vehicle::MultiCopter aparm;
+    AC_AttitudeControl_Multi attitude_control {ahrs, aparm, motors, LOOP_SECONDS};
+
+    AC_P p_alt_hold {1.0f};
+    AC_P p_vel_z {5.0f};
+    AC_PID pid_accel_z {0.5f, 1.0f, 0.0f, 800, 20.0f, LOOP_SECONDS};
+    AC_P p_pos_xy {1.0f};
+    AC_PI_2D pi_vel_xy {1.0f, 0.5f, 1000, 5.0f, 0.02f};
+    AC_PosControl pos_control {ahrs, inertial_nav, motors, attitude_control,
+                               p_alt_hold, p_vel_z, pid_accel_z,
+                               p_pos_xy, pi_vel_xy};
+};
+
+static Controllers &controllers()
+{
+    static Controllers c;
+    return c;
+}
+
+static void BM_AttitudeControlAngleInput(benchmark::State& state)
+{
+    AC_AttitudeControl_Multi &attitude_control = controllers().attitude_control;
+
+    while (state.KeepRunning()) {
+        attitude_control.input_euler_angle_roll_pitch_euler_rate_yaw(1500, -1000, 2000, 1.0f);
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_AttitudeControlAngleInput);
+
+static void BM_AttitudeControlRateController(benchmark::State& state)
+{
+    AC_AttitudeControl_Multi &attitude_control = controllers().attitude_control;
+    attitude_control.input_euler_angle_roll_pitch_euler_rate_yaw(1500, -1000, 2000, 1.0f);
+
+    while (state.KeepRunning()) {
+        attitude_control.rate_controller_run();
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_AttitudeControlRateController);
+
+static void BM_PosControlZ(benchmark::State& state)
+{
+    AC_PosControl &pos_control = controllers().pos_control;
+    pos_control.set_alt_target(1000);
+
+    while (state.KeepRunning()) {
+        pos_control.update_z_controller();
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_PosControlZ);
+
+static void BM_PosControlXY(benchmark::State& state)
+{
+    AC_PosControl &pos_control = controllers().pos_control;
+    pos_control.init_xy_controller();
+    pos_control.set_xy_target(1000, 500);
+
+    while (state.KeepRunning()) {
+        pos_control.update_xy_controller(AC_PosControl::XY_MODE_POS_ONLY, 1.0f, false);
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_PosControlXY);
+
+BENCHMARK_MAIN()
@@ -325,6 +325,10 @@ private:
     bool _cal_complete_requires_reboot;
     bool _cal_has_run;
 
+    // calibration fit steps run on the IO thread
+    bool _cal_fit_registered;
+    void _calibration_fit_io(void);
+
     // backend objects
     AP_Compass_Backend *_backends[COMPASS_MAX_BACKEND];
     uint8_t     _backend_count;
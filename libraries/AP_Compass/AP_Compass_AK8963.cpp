@@ -118,6 +118,12 @@ AP_Compass_Backend *AP_Compass_AK8963::probe_mpu9250(Compass &compass, uint8_t m
 
 bool AP_Compass_AK8963::init()
 {
+    _accum_sem = hal.util->new_semaphore();
+    if (!_accum_sem) {
+        hal.console->printf("AK8963: Unable to create semaphore\n");
+        return false;
+    }
+
     hal.scheduler->suspend_timer_procs();
     AP_HAL::Semaphore *bus_sem = _bus->get_semaphore();
 
@@ -157,12 +163,23 @@ bool AP_Compass_AK8963::init()
     _compass_instance = register_compass();
     set_dev_id(_compass_instance, _dev_id);
 
-    /* timer needs to be called every 10ms so set the freq_div to 10 */
-    _timesliced = hal.scheduler->register_timer_process(FUNCTOR_BIND_MEMBER(&AP_Compass_AK8963::_update, void), 10);
-
     bus_sem->give();
     hal.scheduler->resume_timer_procs();
 
+    /*
+     * Prefer reading samples from the thread of the bus the sensor is
+     * attached to, which is the MPU9250's bus when it is behind its
+     * auxiliary bus. Fallback to the timer process on HALs that don't
+     * provide it.
+     */
+    if (_bus->register_periodic_callback(10000,
+            FUNCTOR_BIND_MEMBER(&AP_Compass_AK8963::_update_periodic, bool)) != nullptr) {
+        return true;
+    }
+
+    /* timer needs to be called every 10ms so set the freq_div to 10 */
+    _timesliced = hal.scheduler->register_timer_process(FUNCTOR_BIND_MEMBER(&AP_Compass_AK8963::_update, void), 10);
+
     return true;
 
 fail:
@@ -179,16 +196,20 @@ void AP_Compass_AK8963::read()
         return;
     }
 
+    if (!_accum_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return;
+    }
+
     if (_accum_count == 0) {
         /* We're not ready to publish*/
+        _accum_sem->give();
         return;
     }
 
-    hal.scheduler->suspend_timer_procs();
     auto field = _get_filtered_field();
 
     _reset_filter();
-    hal.scheduler->resume_timer_procs();
+    _accum_sem->give();
     publish_filtered_field(field, _compass_instance);
 }
 
@@ -222,33 +243,43 @@ void AP_Compass_AK8963::_make_factory_sensitivity_adjustment(Vector3f& field) co
 
 void AP_Compass_AK8963::_update()
 {
-    struct sample_regs regs;
-    Vector3f raw_field;
-    uint32_t time_us = AP_HAL::micros();
-
     if (!_timesliced &&
         AP_HAL::micros() - _last_update_timestamp < 10000) {
-        goto end;
+        return;
     }
 
     if (!_bus->get_semaphore()->take_nonblocking()) {
-        goto end;
+        return;
     }
 
+    _update_periodic();
+
+    _bus->get_semaphore()->give();
+}
+
+/*
+ * Periodic callback from the bus thread: the bus semaphore is already held.
+ */
+bool AP_Compass_AK8963::_update_periodic()
+{
+    struct sample_regs regs;
+    Vector3f raw_field;
+    uint32_t time_us = AP_HAL::micros();
+
     if (!_bus->block_read(AK8963_HXL, (uint8_t *) &regs, sizeof(regs))) {
-        goto fail;
+        return true;
     }
 
     /* Check for overflow. See AK8963's datasheet, section
      * 6.4.3.6 - Magnetic Sensor Overflow. */
     if ((regs.st2 & 0x08)) {
-        goto fail;
+        return true;
     }
 
     raw_field = Vector3f(regs.val[0], regs.val[1], regs.val[2]);
 
     if (is_zero(raw_field.x) && is_zero(raw_field.y) && is_zero(raw_field.z)) {
-        goto fail;
+        return true;
     }
 
     _make_factory_sensitivity_adjustment(raw_field);
@@ -264,23 +295,23 @@ void AP_Compass_AK8963::_update()
     // correct raw_field for known errors
     correct_field(raw_field, _compass_instance);
 
-    _mag_x_accum += raw_field.x;
-    _mag_y_accum += raw_field.y;
-    _mag_z_accum += raw_field.z;
-    _accum_count++;
-    if (_accum_count == 10) {
-        _mag_x_accum /= 2;
-        _mag_y_accum /= 2;
-        _mag_z_accum /= 2;
-        _accum_count = 5;
+    if (_accum_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        _mag_x_accum += raw_field.x;
+        _mag_y_accum += raw_field.y;
+        _mag_z_accum += raw_field.z;
+        _accum_count++;
+        if (_accum_count == 10) {
+            _mag_x_accum /= 2;
+            _mag_y_accum /= 2;
+            _mag_z_accum /= 2;
+            _accum_count = 5;
+        }
+        _accum_sem->give();
     }
 
     _last_update_timestamp = AP_HAL::micros();
 
-fail:
-    _bus->get_semaphore()->give();
-end:
-    return;
+    return true;
 }
 
 bool AP_Compass_AK8963::_check_id()
@@ -351,6 +382,12 @@ AP_HAL::Semaphore *AP_AK8963_BusDriver_HALDevice::get_semaphore()
     return _dev->get_semaphore();
 }
 
+AP_HAL::Device::PeriodicHandle AP_AK8963_BusDriver_HALDevice::register_periodic_callback(uint32_t period_usec,
+                                                                                         AP_HAL::Device::PeriodicCb cb)
+{
+    return _dev->register_periodic_callback(period_usec, cb);
+}
+
 /* AK8963 on an auxiliary bus of IMU driver */
 AP_AK8963_BusDriver_Auxiliary::AP_AK8963_BusDriver_Auxiliary(AP_InertialSensor &ins, uint8_t backend_id,
                                                              uint8_t backend_instance, uint8_t addr)
@@ -408,6 +445,12 @@ AP_HAL::Semaphore *AP_AK8963_BusDriver_Auxiliary::get_semaphore()
     return _bus ? _bus->get_semaphore() : nullptr;
 }
 
+AP_HAL::Device::PeriodicHandle AP_AK8963_BusDriver_Auxiliary::register_periodic_callback(uint32_t period_usec,
+                                                                                         AP_HAL::Device::PeriodicCb cb)
+{
+    return _bus ? _bus->register_periodic_callback(period_usec, cb) : nullptr;
+}
+
 bool AP_AK8963_BusDriver_Auxiliary::configure()
 {
     if (!_bus || !_slave) {
@@ -51,10 +51,14 @@ private:
     bool _calibrate();
 
     void _update();
+    /* Read a sample with the bus semaphore already taken */
+    bool _update_periodic();
 
     AP_AK8963_BusDriver *_bus;
 
     float _magnetometer_ASA[3] {0, 0, 0};
+    /* the accumulators are written from the bus thread */
+    AP_HAL::Semaphore *_accum_sem;
     float _mag_x_accum;
     float _mag_y_accum;
     float _mag_z_accum;
@@ -78,6 +82,14 @@ public:
 
     virtual AP_HAL::Semaphore  *get_semaphore() = 0;
 
+    /* Run cb from the bus thread with the semaphore taken. Returns
+     * nullptr if the bus doesn't support it */
+    virtual AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec,
+                                                                      AP_HAL::Device::PeriodicCb cb)
+    {
+        return nullptr;
+    }
+
     virtual bool configure() { return true; }
     virtual bool start_measurements() { return true; }
 };
@@ -93,6 +105,9 @@ public:
 
     virtual AP_HAL::Semaphore  *get_semaphore() override;
 
+    AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec,
+                                                              AP_HAL::Device::PeriodicCb cb) override;
+
 private:
     AP_HAL::OwnPtr<AP_HAL::I2CDevice> _dev;
 };
@@ -110,6 +125,9 @@ public:
 
     AP_HAL::Semaphore  *get_semaphore() override;
 
+    AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec,
+                                                              AP_HAL::Device::PeriodicCb cb) override;
+
     bool configure();
     bool start_measurements();
 
@@ -7,6 +7,11 @@
 
 extern AP_HAL::HAL& hal;
 
+// time the IO thread spends on calibration fit steps per call. The IO
+// thread may run at a lower rate than the fits need, so several steps
+// are run per call up to this budget
+#define COMPASS_CAL_FIT_IO_BUDGET_US 2000
+
 void
 Compass::compass_cal_update()
 {
@@ -40,6 +45,28 @@ Compass::compass_cal_update()
     }
 }
 
+/*
+  run the calibration fits from the IO thread, so they don't hold up
+  the main loop. Each round runs one step per calibrator, and rounds
+  are repeated until no fit is running or the time budget is used
+ */
+void
+Compass::_calibration_fit_io(void)
+{
+    const uint32_t start_us = AP_HAL::micros();
+    do {
+        bool stepped = false;
+        for (uint8_t i=0; i<COMPASS_MAX_INSTANCES; i++) {
+            if (_calibrator[i].update_fit()) {
+                stepped = true;
+            }
+        }
+        if (!stepped) {
+            break;
+        }
+    } while (AP_HAL::micros() - start_us < COMPASS_CAL_FIT_IO_BUDGET_US);
+}
+
 bool
 Compass::start_calibration(uint8_t i, bool retry, bool autosave, float delay, bool autoreboot)
 {
@@ -58,6 +85,10 @@ Compass::start_calibration(uint8_t i, bool retry, bool autosave, float delay, bo
         // lot noisier
         _calibrator[i].set_tolerance(_calibration_threshold*2);
     }
+    if (!_cal_fit_registered) {
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&Compass::_calibration_fit_io, void));
+        _cal_fit_registered = true;
+    }
     _calibrator[i].start(retry, autosave, delay);
     _compass_cal_autoreboot = autoreboot;
 
@@ -153,6 +153,7 @@ extern const AP_HAL::HAL &hal;
 
 #define LSM303D_MAG_DEFAULT_RANGE_GA          2
 #define LSM303D_MAG_DEFAULT_RATE            100
+#define LSM303D_MAG_SAMPLE_PERIOD_USEC      10000
 
 AP_Compass_LSM303D::AP_Compass_LSM303D(Compass &compass, AP_HAL::OwnPtr<AP_HAL::Device> dev)
     : AP_Compass_Backend(compass)
@@ -262,6 +263,12 @@ bool AP_Compass_LSM303D::init()
     _drdy_pin_m = hal.gpio->channel(LSM303D_DRDY_M_PIN);
     _drdy_pin_m->mode(HAL_GPIO_INPUT);
 
+    _accum_sem = hal.util->new_semaphore();
+    if (!_accum_sem) {
+        hal.console->printf("LSM303D: Unable to create semaphore\n");
+        return false;
+    }
+
     hal.scheduler->suspend_timer_procs();
     bool success = _hardware_init();
     hal.scheduler->resume_timer_procs();
@@ -281,6 +288,16 @@ bool AP_Compass_LSM303D::init()
     set_external(_compass_instance, false);
 #endif
 
+    /*
+     * Prefer reading samples from the thread of the bus the sensor is
+     * attached to so it doesn't compete with the other sensors in the timer
+     * thread. Fallback to the timer process on HALs that don't provide it.
+     */
+    if (_dev->register_periodic_callback(LSM303D_MAG_SAMPLE_PERIOD_USEC,
+            FUNCTOR_BIND_MEMBER(&AP_Compass_LSM303D::_update_periodic, bool)) != nullptr) {
+        return true;
+    }
+
     hal.scheduler->register_timer_process(FUNCTOR_BIND_MEMBER(&AP_Compass_LSM303D::_update, void));
 
     return true;
@@ -342,10 +359,7 @@ fail_whoami:
 
 void AP_Compass_LSM303D::_update()
 {
-    uint32_t time_us = AP_HAL::micros();
-    Vector3f raw_field;
-
-    if (AP_HAL::micros() - _last_update_timestamp < 10000) {
+    if (AP_HAL::micros() - _last_update_timestamp < LSM303D_MAG_SAMPLE_PERIOD_USEC) {
         return;
     }
 
@@ -353,8 +367,21 @@ void AP_Compass_LSM303D::_update()
         return;
     }
 
+    _update_periodic();
+
+    _dev->get_semaphore()->give();
+}
+
+/*
+ * Periodic callback from the bus thread: the bus semaphore is already held.
+ */
+bool AP_Compass_LSM303D::_update_periodic()
+{
+    uint32_t time_us = AP_HAL::micros();
+    Vector3f raw_field;
+
     if (!_read_sample()) {
-        goto fail;
+        return true;
     }
 
     raw_field = Vector3f(_mag_x, _mag_y, _mag_z) * _mag_range_scale;
@@ -368,21 +395,23 @@ void AP_Compass_LSM303D::_update()
     // correct raw_field for known errors
     correct_field(raw_field, _compass_instance);
 
-    _mag_x_accum += raw_field.x;
-    _mag_y_accum += raw_field.y;
-    _mag_z_accum += raw_field.z;
-    _accum_count++;
-    if (_accum_count == 10) {
-        _mag_x_accum /= 2;
-        _mag_y_accum /= 2;
-        _mag_z_accum /= 2;
-        _accum_count = 5;
+    if (_accum_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        _mag_x_accum += raw_field.x;
+        _mag_y_accum += raw_field.y;
+        _mag_z_accum += raw_field.z;
+        _accum_count++;
+        if (_accum_count == 10) {
+            _mag_x_accum /= 2;
+            _mag_y_accum /= 2;
+            _mag_z_accum /= 2;
+            _accum_count = 5;
+        }
+        _accum_sem->give();
     }
 
     _last_update_timestamp = AP_HAL::micros();
 
-fail:
-    _dev->get_semaphore()->give();
+    return true;
 }
 
 // Read Sensor data
@@ -392,18 +421,22 @@ void AP_Compass_LSM303D::read()
         return;
     }
 
+    if (!_accum_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return;
+    }
+
     if (_accum_count == 0) {
         /* We're not ready to publish*/
+        _accum_sem->give();
         return;
     }
 
-    hal.scheduler->suspend_timer_procs();
     Vector3f field(_mag_x_accum, _mag_y_accum, _mag_z_accum);
     field /= _accum_count;
 
     _accum_count = 0;
     _mag_x_accum = _mag_y_accum = _mag_z_accum = 0;
-    hal.scheduler->resume_timer_procs();
+    _accum_sem->give();
 
     publish_filtered_field(field, _compass_instance);
 }
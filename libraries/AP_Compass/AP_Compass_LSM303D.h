@@ -35,6 +35,8 @@ private:
     bool _data_ready();
     bool _hardware_init();
     void _update();
+    /* Read a sample with the bus semaphore already taken */
+    bool _update_periodic();
     void _disable_i2c();
     bool _mag_set_range(uint8_t max_ga);
     bool _mag_set_samplerate(uint16_t frequency);
@@ -43,6 +45,8 @@ private:
     AP_HAL::OwnPtr<AP_HAL::Device> _dev;
 
     float _mag_range_scale;
+    /* the accumulators are written from the bus thread */
+    AP_HAL::Semaphore *_accum_sem;
     float _mag_x_accum;
     float _mag_y_accum;
     float _mag_z_accum;
@@ -56,6 +56,13 @@
  *
  * The fitting algorithm used is Levenberg-Marquardt. See also:
  * http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm
+ *
+ * The fit steps are run from the IO thread via update_fit() so that they
+ * don't eat into the main loop. Samples are only added to the buffer while
+ * it isn't full and the fit only runs once it is, so the two sides never
+ * work on the buffer at the same time; _sem covers the hand-over points
+ * (thinning, status changes and freeing the buffer). On boards that can't
+ * provide a semaphore update() runs the fit steps as before.
  */
 
 #include "CompassCalibrator.h"
@@ -78,25 +85,46 @@ extern const AP_HAL::HAL& hal;
 
 CompassCalibrator::CompassCalibrator():
 _tolerance(COMPASS_CAL_DEFAULT_TOLERANCE),
-_sample_buffer(NULL)
+_sample_buffer(NULL),
+_sem(NULL),
+_fit_failed(false)
 {
     clear();
 }
 
 void CompassCalibrator::clear() {
+    if (_sem != NULL && !_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return;
+    }
     set_status(COMPASS_CAL_NOT_STARTED);
+    _fit_failed = false;
+    if (_sem != NULL) {
+        _sem->give();
+    }
 }
 
 void CompassCalibrator::start(bool retry, bool autosave, float delay) {
     if(running()) {
         return;
     }
+    if (_sem == NULL) {
+        // can't be done in the constructor as calibrators are created
+        // before the HAL is up
+        _sem = hal.util->new_semaphore();
+    }
+    if (_sem != NULL && !_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return;
+    }
     _autosave = autosave;
     _attempt = 1;
     _retry = retry;
     _delay_start_sec = delay;
     _start_time_ms = AP_HAL::millis();
+    _fit_failed = false;
     set_status(COMPASS_CAL_WAITING_TO_START);
+    if (_sem != NULL) {
+        _sem->give();
+    }
 }
 
 void CompassCalibrator::get_calibration(Vector3f &offsets, Vector3f &diagonals, Vector3f &offdiagonals) {
@@ -158,17 +186,34 @@ CompassCalibrator::completion_mask_t& CompassCalibrator::get_completion_mask()
 
 bool CompassCalibrator::check_for_timeout() {
     uint32_t tnow = AP_HAL::millis();
-    if(running() && tnow - _last_sample_ms > 1000) {
+    if(!running() || tnow - _last_sample_ms <= 1000) {
+        return false;
+    }
+    // a fit step is in progress; check again on the next call
+    if (_sem != NULL && !_sem->take_nonblocking()) {
+        return false;
+    }
+    // the fit may have finished since running() was checked
+    const bool timed_out = running();
+    if (timed_out) {
         _retry = false;
         set_status(COMPASS_CAL_FAILED);
-        return true;
     }
-    return false;
+    if (_sem != NULL) {
+        _sem->give();
+    }
+    return timed_out;
 }
 
 void CompassCalibrator::new_sample(const Vector3f& sample) {
     _last_sample_ms = AP_HAL::millis();
 
+    // drop the sample rather than wait for the fitting thread, which also
+    // changes _status
+    if (_sem != NULL && !_sem->take_nonblocking()) {
+        return;
+    }
+
     if(_status == COMPASS_CAL_WAITING_TO_START) {
         set_status(COMPASS_CAL_RUNNING_STEP_ONE);
     }
@@ -178,13 +223,44 @@ void CompassCalibrator::new_sample(const Vector3f& sample) {
         _sample_buffer[_samples_collected].set(sample);
         _samples_collected++;
     }
+
+    if (_sem != NULL) {
+        _sem->give();
+    }
 }
 
 void CompassCalibrator::update(bool &failure) {
-    failure = false;
+    if (_sem == NULL && run_fit_step()) {
+        _fit_failed = true;
+    }
+
+    failure = _fit_failed;
+    _fit_failed = false;
+}
+
+bool CompassCalibrator::update_fit() {
+    if(_sem == NULL || !fitting()) {
+        return false;
+    }
+
+    if (!_sem->take_nonblocking()) {
+        return false;
+    }
+    if (run_fit_step()) {
+        _fit_failed = true;
+    }
+    _sem->give();
+    return true;
+}
+
+/////////////////////////////////////////////////////////////
+////////////////////// PRIVATE METHODS //////////////////////
+/////////////////////////////////////////////////////////////
+bool CompassCalibrator::run_fit_step() {
+    bool failure = false;
 
     if(!fitting()) {
-        return;
+        return false;
     }
 
     if(_status == COMPASS_CAL_RUNNING_STEP_ONE) {
@@ -217,11 +293,10 @@ void CompassCalibrator::update(bool &failure) {
             _fit_step++;
         }
     }
+
+    return failure;
 }
 
-/////////////////////////////////////////////////////////////
-////////////////////// PRIVATE METHODS //////////////////////
-/////////////////////////////////////////////////////////////
 bool CompassCalibrator::running() const {
     return _status == COMPASS_CAL_RUNNING_STEP_ONE || _status == COMPASS_CAL_RUNNING_STEP_TWO;
 }
@@ -450,37 +525,44 @@ float CompassCalibrator::calc_mean_squared_residuals(const param_t& params) cons
     if(_sample_buffer == NULL || _samples_collected == 0) {
         return 1.0e30f;
     }
+    // build the correction once rather than per sample
+    const Matrix3f softiron(
+        params.diag.x    , params.offdiag.x , params.offdiag.y,
+        params.offdiag.x , params.diag.y    , params.offdiag.z,
+        params.offdiag.y , params.offdiag.z , params.diag.z
+    );
     float sum = 0.0f;
     for(uint16_t i=0; i < _samples_collected; i++){
-        Vector3f sample = _sample_buffer[i].get();
-        float resid = calc_residual(sample, params);
+        const Vector3f sample = _sample_buffer[i].get();
+        float resid = params.radius - (softiron*(sample+params.offset)).length();
         sum += sq(resid);
     }
     sum /= _samples_collected;
     return sum;
 }
 
-void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
+float CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
+    const Vector3f s = sample + offset;
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    // A, B and C are the components of the corrected sample, so its length
+    // comes for free
+    float A =  (diag.x    * s.x) + (offdiag.x * s.y) + (offdiag.y * s.z);
+    float B =  (offdiag.x * s.x) + (diag.y    * s.y) + (offdiag.z * s.z);
+    float C =  (offdiag.y * s.x) + (offdiag.z * s.y) + (diag.z    * s.z);
+    float length = norm(A, B, C);
+    float inv_length = 1.0f / length;
 
     // 0: partial derivative (radius wrt fitness fn) fn operated on sample
     ret[0] = 1.0f;
     // 1-3: partial derivative (offsets wrt fitness fn) fn operated on sample
-    ret[1] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[2] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    ret[1] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * inv_length);
+    ret[2] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * inv_length);
+    ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * inv_length);
+
+    return params.radius - length;
 }
 
 void CompassCalibrator::calc_initial_offset()
@@ -511,26 +593,34 @@ void CompassCalibrator::run_sphere_fit()
     float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
     memset(&JTJ,0,sizeof(JTJ));
-    memset(&JTJ2,0,sizeof(JTJ2));
     memset(&JTFI,0,sizeof(JTFI));
     // Gauss Newton Part common for all kind of extensions including LM
+    // JTJ is symmetric: accumulate the upper triangle only and mirror it
+    // afterwards. The residual comes out of the Jacobian calculation.
     for(uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
+        const Vector3f sample = _sample_buffer[k].get();
 
         float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
-        calc_sphere_jacob(sample, fit1_params, sphere_jacob);
+        const float residual = calc_sphere_jacob(sample, fit1_params, sphere_jacob);
 
         for(uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
             // compute JTJ
-            for(uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
+            const float ji = sphere_jacob[i];
+            for(uint8_t j = i; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
+                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += ji * sphere_jacob[j];
             }
             // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += ji * residual;
+        }
+    }
+    for(uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
+        for(uint8_t j = 0; j < i; j++) {
+            JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] = JTJ[j*COMPASS_CAL_NUM_SPHERE_PARAMS+i];
         }
     }
+    // a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
@@ -578,33 +668,32 @@ void CompassCalibrator::run_sphere_fit()
 
 
 
-void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
+float CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
+    const Vector3f s = sample + offset;
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    float A =  (diag.x    * s.x) + (offdiag.x * s.y) + (offdiag.y * s.z);
+    float B =  (offdiag.x * s.x) + (diag.y    * s.y) + (offdiag.z * s.z);
+    float C =  (offdiag.y * s.x) + (offdiag.z * s.y) + (diag.z    * s.z);
+    float length = norm(A, B, C);
+    float inv_length = 1.0f / length;
 
     // 0-2: partial derivative (offset wrt fitness fn) fn operated on sample
-    ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[1] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[2] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * inv_length);
+    ret[1] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * inv_length);
+    ret[2] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * inv_length);
     // 3-5: partial derivative (diag offset wrt fitness fn) fn operated on sample
-    ret[3] = -1.0f * ((sample.x + offset.x) * A)/length;
-    ret[4] = -1.0f * ((sample.y + offset.y) * B)/length;
-    ret[5] = -1.0f * ((sample.z + offset.z) * C)/length;
+    ret[3] = -1.0f * (s.x * A) * inv_length;
+    ret[4] = -1.0f * (s.y * B) * inv_length;
+    ret[5] = -1.0f * (s.z * C) * inv_length;
     // 6-8: partial derivative (off-diag offset wrt fitness fn) fn operated on sample
-    ret[6] = -1.0f * (((sample.y + offset.y) * A) + ((sample.x + offset.x) * B))/length;
-    ret[7] = -1.0f * (((sample.z + offset.z) * A) + ((sample.x + offset.x) * C))/length;
-    ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
+    ret[6] = -1.0f * ((s.y * A) + (s.x * B)) * inv_length;
+    ret[7] = -1.0f * ((s.z * A) + (s.x * C)) * inv_length;
+    ret[8] = -1.0f * ((s.z * B) + (s.y * C)) * inv_length;
+
+    return params.radius - length;
 }
 
 void CompassCalibrator::run_ellipsoid_fit()
@@ -627,27 +716,34 @@ void CompassCalibrator::run_ellipsoid_fit()
     float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
 
     memset(&JTJ,0,sizeof(JTJ));
-    memset(&JTJ2,0,sizeof(JTJ2));
     memset(&JTFI,0,sizeof(JTFI));
     // Gauss Newton Part common for all kind of extensions including LM
+    // JTJ is symmetric: accumulate the upper triangle only and mirror it
+    // afterwards. The residual comes out of the Jacobian calculation.
     for(uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
+        const Vector3f sample = _sample_buffer[k].get();
 
         float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
 
-        calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
+        const float residual = calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
 
         for(uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
             // compute JTJ
-            for(uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
+            const float ji = ellipsoid_jacob[i];
+            for(uint8_t j = i; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
+                JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ji * ellipsoid_jacob[j];
             }
             // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += ji * residual;
         }
     }
-
+    for(uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
+        for(uint8_t j = 0; j < i; j++) {
+            JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] = JTJ[j*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i];
+        }
+    }
+    // a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
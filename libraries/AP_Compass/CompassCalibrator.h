@@ -1,3 +1,4 @@
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 
 #define COMPASS_CAL_NUM_SPHERE_PARAMS 4
@@ -25,7 +26,14 @@ public:
     void start(bool retry=false, bool autosave=false, float delay=0.0f);
     void clear();
 
+    // called from the main loop: reports fit failures and, on boards
+    // without semaphores, runs the fit steps itself
     void update(bool &failure);
+
+    // called from the IO thread: runs one fit step if the sample buffer
+    // is full. Returns true if a step was run
+    bool update_fit();
+
     void new_sample(const Vector3f &sample);
 
     bool check_for_timeout();
@@ -98,8 +106,18 @@ private:
     uint16_t _samples_collected;
     uint16_t _samples_thinned;
 
+    // protects the sample buffer and status transitions between the
+    // sampling, main and fitting threads
+    AP_HAL::Semaphore *_sem;
+
+    // set by the fitting thread, consumed by update()
+    volatile bool _fit_failed;
+
     bool set_status(compass_cal_status_t status);
 
+    // runs one fit step, returns true if the fit failed
+    bool run_fit_step();
+
     // returns true if sample should be added to buffer
     bool accept_sample(const Vector3f &sample);
     bool accept_sample(const CompassSample &sample);
@@ -120,10 +138,11 @@ private:
     float calc_mean_squared_residuals() const;
 
     void calc_initial_offset();
-    void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
+    // fills ret with the Jacobian for sample and returns its residual
+    float calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_sphere_fit();
 
-    void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
+    float calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_ellipsoid_fit();
 
     /**
@@ -3,6 +3,18 @@
 
 #include <inttypes.h>
 
+// declination grid: 5 degree spacing over the whole globe
+#define AP_DECLINATION_DEC_RES          5
+#define AP_DECLINATION_DEC_ROWS         37
+#define AP_DECLINATION_DEC_COLS         73
+
+// inclination and intensity grid: 10 degree spacing, +-60 degrees latitude
+#define AP_DECLINATION_FIELD_RES        10
+#define AP_DECLINATION_FIELD_MIN_LAT    -60
+#define AP_DECLINATION_FIELD_MAX_LAT    60
+#define AP_DECLINATION_FIELD_ROWS       13
+#define AP_DECLINATION_FIELD_COLS       37
+
 /*
  *	Adam M Rivera
  *	With direction from: Andrew Tridgell, Jason Short, Justin Beech
@@ -15,7 +27,24 @@
 class AP_Declination
 {
 public:
+    // declination in degrees, latitude and longitude in degrees
     static float            get_declination(float lat, float lon);
+
+    /*
+     * Calculates the magnetic intensity, declination and inclination at a
+     * given WGS-84 latitude and longitude, assuming a height of zero.
+     * Latitude, longitude, declination and inclination are in degrees,
+     * intensity is in Gauss.
+     * Returns false if the position is outside the +-60 degrees latitude
+     * covered by the intensity and inclination tables, in which case those
+     * come from the nearest edge of the table.
+     */
+    static bool             get_mag_field_ef(float latitude_deg, float longitude_deg,
+                                             float &intensity_gauss, float &declination_deg,
+                                             float &inclination_deg);
+
 private:
-    static int16_t          get_lookup_value(uint8_t x, uint8_t y);
+    static float            interpolate(const int16_t *table, uint8_t columns,
+                                        uint8_t row, uint8_t col,
+                                        float frac_row, float frac_col);
 };
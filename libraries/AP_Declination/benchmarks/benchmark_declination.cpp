@@ -0,0 +1,53 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Declination/AP_Declination.h>
+
+static void BM_GetDeclination(benchmark::State& state)
+{
+    float lat = -35.36f;
+    float lon = 149.17f;
+
+    while (state.KeepRunning()) {
+        float dec = AP_Declination::get_declination(lat, lon);
+        gbenchmark_escape(&dec);
+        // walk over the grid so every kind of row gets looked up
+        lat += 7.3f;
+        if (lat > 90) {
+            lat -= 180;
+        }
+        lon += 11.1f;
+        if (lon > 180) {
+            lon -= 360;
+        }
+    }
+}
+
+BENCHMARK(BM_GetDeclination);
+
+static void BM_GetMagField(benchmark::State& state)
+{
+    float lat = -35.36f;
+    float lon = 149.17f;
+
+    while (state.KeepRunning()) {
+        float intensity, declination, inclination;
+        bool r = AP_Declination::get_mag_field_ef(lat, lon, intensity,
+                                                  declination, inclination);
+        gbenchmark_escape(&r);
+        gbenchmark_escape(&intensity);
+        gbenchmark_escape(&declination);
+        gbenchmark_escape(&inclination);
+        lat += 7.3f;
+        if (lat > 60) {
+            lat -= 120;
+        }
+        lon += 11.1f;
+        if (lon > 180) {
+            lon -= 360;
+        }
+    }
+}
+
+BENCHMARK(BM_GetMagField);
+
+BENCHMARK_MAIN()
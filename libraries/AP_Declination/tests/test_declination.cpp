@@ -0,0 +1,96 @@
+#include <AP_gtest.h>
+
+#include <cmath>
+
+#include <AP_Declination/AP_Declination.h>
+
+/*
+ * Reference declinations from the run-length encoded table this library
+ * used before switching to a plain grid.
+ */
+static const float declination_ref[][3] = {
+    {-35.36f, 149.17f, 11.8120f},
+    {37.62f, -122.38f, 13.5240f},
+    {51.47f, -0.45f, -1.1165f},
+    {-33.94f, 18.60f, -24.4394f},
+    {64.13f, -21.94f, -14.7485f},
+    {-54.80f, -68.30f, 12.5200f},
+    {35.55f, 139.78f, -6.2592f},
+    {19.43f, -99.13f, 4.6520f},
+    {-12.05f, -77.04f, -0.9560f},
+    {1.35f, 103.99f, 0.0000f},
+    {78.22f, 15.65f, 6.1640f},
+    {-77.85f, 166.67f, 141.0648f},
+    {0.00f, 0.00f, -5.0000f},
+    {-89.00f, -170.00f, 138.2000f},
+    {45.00f, -179.90f, 4.0400f},
+    {-22.50f, 47.50f, -19.5000f},
+    {12.34f, -56.78f, -15.9866f},
+    {60.00f, 100.00f, 0.0000f},
+    {-60.00f, -100.00f, 33.0000f},
+    {87.50f, 2.50f, -6.0000f},
+};
+
+/*
+ * Reference intensity (Gauss) and inclination (degrees) interpolated from
+ * the floating point tables SITL used before they moved here.
+ */
+static const float field_ref[][4] = {
+    {-35.36f, 149.17f, 0.58019f, -65.688f},
+    {37.62f, -122.38f, 0.48271f, 60.958f},
+    {51.47f, -0.45f, 0.48667f, 66.271f},
+    {-33.94f, 18.60f, 0.25955f, -65.197f},
+    {-54.80f, -68.30f, 0.32119f, -50.945f},
+    {35.55f, 139.78f, 0.46511f, 48.933f},
+    {19.43f, -99.13f, 0.40493f, 47.046f},
+    {-12.05f, -77.04f, 0.25316f, -0.772f},
+    {1.35f, 103.99f, 0.42227f, -13.897f},
+    {0.00f, 0.00f, 0.31919f, -29.919f},
+    {-22.50f, 47.50f, 0.34716f, -55.340f},
+    {12.34f, -56.78f, 0.32579f, 29.456f},
+};
+
+TEST(DeclinationTest, MatchesPreviousTable)
+{
+    for (const auto &r : declination_ref) {
+        EXPECT_NEAR(r[2], AP_Declination::get_declination(r[0], r[1]), 1.0e-3f)
+            << "lat=" << r[0] << " lon=" << r[1];
+    }
+}
+
+TEST(DeclinationTest, Edges)
+{
+    // the corners of the grid must not index past the end of the table
+    EXPECT_TRUE(std::isfinite(AP_Declination::get_declination(90, 180)));
+    EXPECT_TRUE(std::isfinite(AP_Declination::get_declination(-90, -180)));
+    EXPECT_FLOAT_EQ(AP_Declination::get_declination(90, 180),
+                    AP_Declination::get_declination(100, 200));
+}
+
+TEST(DeclinationTest, MagField)
+{
+    for (const auto &r : field_ref) {
+        float intensity, declination, inclination;
+        EXPECT_TRUE(AP_Declination::get_mag_field_ef(r[0], r[1], intensity,
+                                                     declination, inclination));
+        // intensity is stored in 0.1 mGauss, inclination in centi-degrees
+        EXPECT_NEAR(r[2], intensity, 1.0e-4f) << "lat=" << r[0] << " lon=" << r[1];
+        EXPECT_NEAR(r[3], inclination, 1.0e-2f) << "lat=" << r[0] << " lon=" << r[1];
+        EXPECT_FLOAT_EQ(AP_Declination::get_declination(r[0], r[1]), declination);
+    }
+}
+
+TEST(DeclinationTest, MagFieldOutOfRange)
+{
+    float intensity, declination, inclination;
+    float intensity_edge, declination_edge, inclination_edge;
+
+    EXPECT_FALSE(AP_Declination::get_mag_field_ef(75, 10, intensity,
+                                                  declination, inclination));
+    EXPECT_TRUE(AP_Declination::get_mag_field_ef(60, 10, intensity_edge,
+                                                 declination_edge, inclination_edge));
+    EXPECT_FLOAT_EQ(intensity_edge, intensity);
+    EXPECT_FLOAT_EQ(inclination_edge, inclination);
+}
+
+AP_GTEST_MAIN()
@@ -112,24 +112,34 @@ AP_GPS_NMEA::AP_GPS_NMEA(AP_GPS &_gps, AP_GPS::GPS_State &_state, AP_HAL::UARTDr
 
 bool AP_GPS_NMEA::read(void)
 {
-    int16_t numc;
+    uint8_t buf[64];
+    uint32_t numc;
     bool parsed = false;
 
     numc = port->available();
-    while (numc--) {
-        char c = port->read();
+    while (numc > 0) {
+        // decode the received bytes a contiguous run at a time
+        const uint8_t *data;
+        uint32_t n = port->read_span(data, buf, MIN(numc, sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
 #ifdef NMEA_LOG_PATH
         static FILE *logf = NULL;
         if (logf == NULL) {
             logf = fopen(NMEA_LOG_PATH, "wb");
         }
         if (logf != NULL) {
-            ::fwrite(&c, 1, 1, logf);
+            ::fwrite(data, 1, n, logf);
         }
 #endif
-        if (_decode(c)) {
-            parsed = true;
+        for (uint32_t i = 0; i < n; i++) {
+            if (_decode(data[i])) {
+                parsed = true;
+            }
         }
+        port->release_span();
+        numc -= n;
     }
     return parsed;
 }
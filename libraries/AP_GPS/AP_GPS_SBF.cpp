@@ -70,14 +70,55 @@ AP_GPS_SBF::read(void)
     }
 
     bool ret = false;
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
-        ret |= parse(temp);
+    uint8_t buf[64];
+    uint32_t numc = port->available();
+    while (numc > 0) {
+        // parse the received bytes a contiguous run at a time
+        const uint8_t *data;
+        uint32_t n = port->read_span(data, buf, MIN(numc, sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (sbf_msg.sbf_state == sbf_msg_parser_t::DATA) {
+                // copy all but the last byte of the block in one go,
+                // parse() then sees the last byte and checks the crc
+                uint32_t count = MIN(n - i, parse_data_run());
+                if (count > 0) {
+                    memcpy(&sbf_msg.data.bytes[sbf_msg.read], &data[i], count);
+                    sbf_msg.read += count;
+                    i += count;
+                    if (i == n) {
+                        break;
+                    }
+                }
+            }
+            ret |= parse(data[i]);
+        }
+        port->release_span();
+        numc -= n;
     }
 
     return ret;
 }
 
+/*
+  number of bytes of the current block that can be copied without
+  going through parse(), which must still see the last one
+ */
+uint32_t
+AP_GPS_SBF::parse_data_run(void) const
+{
+    if (sbf_msg.length <= 8) {
+        return 0;
+    }
+    uint32_t block_len = MIN((uint32_t)(sbf_msg.length - 8), sizeof(sbf_msg.data));
+    if (sbf_msg.read + 1 >= block_len) {
+        return 0;
+    }
+    return block_len - 1 - sbf_msg.read;
+}
+
 bool
 AP_GPS_SBF::parse(uint8_t temp)
 {
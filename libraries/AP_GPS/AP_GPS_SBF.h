@@ -40,6 +40,7 @@ public:
 private:
 
     bool parse(uint8_t temp);
+    uint32_t parse_data_run(void) const;
     bool process_message();
 
     static const uint8_t SBF_PREAMBLE1 = '$';
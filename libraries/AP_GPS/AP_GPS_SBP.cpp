@@ -102,9 +102,45 @@ AP_GPS_SBP::inject_data(uint8_t *data, uint8_t len)
 void
 AP_GPS_SBP::_sbp_process() 
 {
+    uint8_t buf[64];
+    uint32_t numc = port->available();
+
+    while (numc > 0) {
+        // parse the received bytes a contiguous run at a time
+        const uint8_t *data;
+        uint32_t n = port->read_span(data, buf, MIN(numc, sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
+        _sbp_process_span(data, n);
+        port->release_span();
+        numc -= n;
+    }
+}
+
+void
+AP_GPS_SBP::_sbp_process_span(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (parser_state.state == sbp_parser_state_t::WAITING) {
+            // skip straight to the next possible start of a message
+            const uint8_t *p = (const uint8_t *)memchr(&data[i], SBP_PREAMBLE, len - i);
+            if (p == nullptr) {
+                break;
+            }
+            i = p - data;
+        } else if (parser_state.state == sbp_parser_state_t::GET_MSG &&
+                   parser_state.msg_len > parser_state.n_read + 1) {
+            // copy all but the last byte of the payload in one go, the
+            // state machine then sees the last byte and moves on
+            uint32_t count = MIN(len - i, (uint32_t)(parser_state.msg_len - parser_state.n_read - 1));
+            memcpy(&parser_state.msg_buff[parser_state.n_read], &data[i], count);
+            parser_state.n_read += count;
+            i += count - 1;
+            continue;
+        }
 
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
+        uint8_t temp = data[i];
         uint16_t crc;
 
 
@@ -134,6 +134,7 @@ private:
     };
 
     void _sbp_process();
+    void _sbp_process_span(const uint8_t *data, uint32_t len);
     void _sbp_process_message();
     bool _attempt_state_update();
 
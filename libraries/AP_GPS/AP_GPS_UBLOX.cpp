@@ -326,8 +326,8 @@ AP_GPS_UBLOX::_request_port(void)
 bool
 AP_GPS_UBLOX::read(void)
 {
-    uint8_t data;
-    int16_t numc;
+    uint8_t buf[64];
+    uint32_t numc;
     bool parsed = false;
     uint32_t millis_now = AP_HAL::millis();
 
@@ -357,10 +357,56 @@ AP_GPS_UBLOX::read(void)
     }
 
     numc = port->available();
-    for (int16_t i = 0; i < numc; i++) {        // Process bytes received
+    while (numc > 0) {
+        // scan the received bytes a contiguous run at a time
+        const uint8_t *data;
+        uint32_t n = port->read_span(data, buf, MIN(numc, sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
+        if (_parse_span(data, n)) {
+            parsed = true;
+        }
+        port->release_span();
+        numc -= n;
+    }
+    return parsed;
+}
+
+/*
+  run the message state machine over a run of received bytes. The
+  preamble search and the payload are handled a block at a time, the
+  rest of the message a byte at a time
+ */
+bool
+AP_GPS_UBLOX::_parse_span(const uint8_t *data, uint32_t len)
+{
+    bool parsed = false;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (_step == 0) {
+            // skip straight to the next possible start of a message
+            const uint8_t *p = (const uint8_t *)memchr(&data[i], PREAMBLE1, len - i);
+            if (p == nullptr) {
+                break;
+            }
+            i = p - data;
+        } else if (_step == 6 && _payload_counter < _payload_length) {
+            // gather as much of the payload as this run holds
+            uint32_t n = MIN(len - i, (uint32_t)(_payload_length - _payload_counter));
+            memcpy(&_buffer[_payload_counter], &data[i], n);
+            for (uint32_t j = 0; j < n; j++) {
+                _ck_b += (_ck_a += data[i+j]);
+            }
+            _payload_counter += n;
+            if (_payload_counter == _payload_length) {
+                _step++;
+            }
+            i += n - 1;
+            continue;
+        }
 
-        // read the next byte
-        data = port->read();
+        uint8_t c = data[i];
 
 	reset:
         switch(_step) {
@@ -375,7 +421,7 @@ AP_GPS_UBLOX::read(void)
         // as data in some other message.
         //
         case 1:
-            if (PREAMBLE2 == data) {
+            if (PREAMBLE2 == c) {
                 _step++;
                 break;
             }
@@ -383,7 +429,7 @@ AP_GPS_UBLOX::read(void)
             Debug("reset %u", __LINE__);
             /* no break */
         case 0:
-            if(PREAMBLE1 == data)
+            if(PREAMBLE1 == c)
                 _step++;
             break;
 
@@ -398,24 +444,24 @@ AP_GPS_UBLOX::read(void)
         //
         case 2:
             _step++;
-            _class = data;
-            _ck_b = _ck_a = data;                               // reset the checksum accumulators
+            _class = c;
+            _ck_b = _ck_a = c;                                  // reset the checksum accumulators
             break;
         case 3:
             _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
-            _msg_id = data;
+            _ck_b += (_ck_a += c);                      // checksum byte
+            _msg_id = c;
             break;
         case 4:
             _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
-            _payload_length = data;                             // payload length low byte
+            _ck_b += (_ck_a += c);                      // checksum byte
+            _payload_length = c;                                // payload length low byte
             break;
         case 5:
             _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
+            _ck_b += (_ck_a += c);                      // checksum byte
 
-            _payload_length += (uint16_t)(data<<8);
+            _payload_length += (uint16_t)(c<<8);
             if (_payload_length > sizeof(_buffer)) {
                 Debug("large payload %u", (unsigned)_payload_length);
                 // assume any payload bigger then what we know about is noise
@@ -429,9 +475,9 @@ AP_GPS_UBLOX::read(void)
         // Receive message data
         //
         case 6:
-            _ck_b += (_ck_a += data);                   // checksum byte
+            _ck_b += (_ck_a += c);                      // checksum byte
             if (_payload_counter < sizeof(_buffer)) {
-                _buffer[_payload_counter] = data;
+                _buffer[_payload_counter] = c;
             }
             if (++_payload_counter == _payload_length)
                 _step++;
@@ -441,16 +487,16 @@ AP_GPS_UBLOX::read(void)
         //
         case 7:
             _step++;
-            if (_ck_a != data) {
-                Debug("bad cka %x should be %x", data, _ck_a);
+            if (_ck_a != c) {
+                Debug("bad cka %x should be %x", c, _ck_a);
                 _step = 0;
 				goto reset;
             }
             break;
         case 8:
             _step = 0;
-            if (_ck_b != data) {
-                Debug("bad ckb %x should be %x", data, _ck_b);
+            if (_ck_b != c) {
+                Debug("bad ckb %x should be %x", c, _ck_b);
                 break;                                                  // bad checksum
             }
 
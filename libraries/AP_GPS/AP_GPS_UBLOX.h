@@ -503,6 +503,7 @@ private:
 
     // Buffer parse & GPS state update
     bool        _parse_gps();
+    bool        _parse_span(const uint8_t *data, uint32_t len);
 
     // used to update fix between status and position packets
     AP_GPS::GPS_Status next_fix;
@@ -37,3 +37,46 @@ void AP_HAL::UARTDriver::vprintf(const char *fmt, va_list ap)
 {
     print_vprintf(this, fmt, ap);
 }
+
+/*
+  generic bulk read, for ports without a receive buffer of their own
+ */
+uint32_t AP_HAL::UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; i++) {
+        int16_t c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[i] = c;
+    }
+    return i;
+}
+
+void AP_HAL::UARTDriver::consume(uint32_t count)
+{
+    while (count-- > 0 && read() >= 0) {
+    }
+}
+
+uint32_t AP_HAL::UARTDriver::read_span(const uint8_t *&data, uint8_t *buf, uint32_t count)
+{
+    uint32_t n = count;
+    data = peek_span(n);
+    if (data != nullptr) {
+        _span_peeked = n;
+        return n;
+    }
+    _span_peeked = 0;
+    data = buf;
+    return read(buf, count);
+}
+
+void AP_HAL::UARTDriver::release_span(void)
+{
+    if (_span_peeked > 0) {
+        consume(_span_peeked);
+        _span_peeked = 0;
+    }
+}
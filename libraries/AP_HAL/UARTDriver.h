@@ -45,10 +45,45 @@ public:
     virtual void set_flow_control(enum flow_control flow_control_setting) {};
     virtual enum flow_control get_flow_control(void) { return FLOW_CONTROL_DISABLE; }
 
+    using AP_HAL::Stream::read;
+
+    /*
+      read up to count bytes into buffer, returning the number of bytes
+      read. The generic version calls read() once per byte, ports with a
+      receive ring buffer override it with a block copy
+     */
+    virtual uint32_t read(uint8_t *buffer, uint32_t count);
+
+    /*
+      zero copy access to received bytes. peek_span() returns the next
+      contiguous run of received bytes, at most count long, without
+      consuming them and sets count to its length. The bytes stay valid
+      until they are consumed with consume(). Ports that can't expose
+      their receive buffer return nullptr
+     */
+    virtual const uint8_t *peek_span(uint32_t &count) { count = 0; return nullptr; }
+    virtual void consume(uint32_t count);
+
+    /*
+      get the next run of at most count received bytes for a protocol
+      parser to scan. The bytes come straight from the port's receive
+      buffer when it can expose it, otherwise they are copied into buf,
+      which must hold count bytes. Returns the number of bytes in the
+      run, which must be handed back with release_span() once scanned
+      and before the next call
+     */
+    uint32_t read_span(const uint8_t *&data, uint8_t *buf, uint32_t count);
+    void release_span(void);
+
     /* Implementations of BetterStream virtual methods. These are
      * provided by AP_HAL to ensure consistency between ports to
      * different boards
      */
     void printf(const char *s, ...) FMT_PRINTF(2, 3);
     void vprintf(const char *s, va_list ap);
+
+private:
+    // length of the run handed out by read_span() from the receive
+    // buffer, zero if it was copied
+    uint32_t _span_peeked = 0;
 };
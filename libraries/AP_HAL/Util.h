@@ -108,6 +108,24 @@ public:
     virtual void perf_end(perf_counter_t h) {}
     virtual void perf_count(perf_counter_t h) {}
 
+    /*
+      summary of a performance counter; times are in nanoseconds and
+      percentiles are only available on HALs keeping histograms
+     */
+    struct perf_counter_stats {
+        const char *name;
+        perf_counter_type type;
+        uint64_t count;
+        uint64_t min;
+        uint64_t max;
+        uint64_t avg;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+    };
+    // get the stats of the idx-th allocated counter, false if there is none
+    virtual bool perf_get_stats(uint16_t idx, perf_counter_stats &stats) { return false; }
+
     // create a new semaphore
     virtual Semaphore *new_semaphore(void) { return nullptr; }
 
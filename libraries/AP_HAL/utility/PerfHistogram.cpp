@@ -0,0 +1,59 @@
+#include <math.h>
+
+#include <AP_Math/AP_Math.h>
+
+#include "PerfHistogram.h"
+
+unsigned int PerfHistogram::bucket(uint64_t elapsed)
+{
+    const unsigned int sub_buckets = 1U << AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT;
+
+    if (elapsed < sub_buckets) {
+        return elapsed;
+    }
+
+    /* index of most significant bit, >= AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT */
+    const unsigned int msb = 63 - __builtin_clzll(elapsed);
+    const unsigned int shift = msb - AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT;
+    const unsigned int sub = (elapsed >> shift) & (sub_buckets - 1);
+    const unsigned int bucket = (shift + 1) * sub_buckets + sub;
+
+    return MIN(bucket, AP_PERF_HISTOGRAM_BUCKETS - 1);
+}
+
+uint64_t PerfHistogram::bucket_max(unsigned int bucket)
+{
+    const unsigned int sub_buckets = 1U << AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT;
+
+    if (bucket < sub_buckets) {
+        return bucket;
+    }
+
+    if (bucket >= AP_PERF_HISTOGRAM_BUCKETS - 1) {
+        return UINT64_MAX;
+    }
+
+    const unsigned int shift = bucket / sub_buckets - 1;
+    const uint64_t sub = bucket % sub_buckets;
+
+    return ((sub_buckets + sub + 1) << shift) - 1;
+}
+
+uint64_t PerfHistogram::percentile(const uint32_t buckets[AP_PERF_HISTOGRAM_BUCKETS],
+                                   uint64_t count, float fraction, uint64_t max)
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    const uint64_t target = (uint64_t)ceilf(fraction * count);
+    uint64_t acc = 0;
+    for (unsigned int i = 0; i < AP_PERF_HISTOGRAM_BUCKETS; i++) {
+        acc += buckets[i];
+        if (acc >= target) {
+            return MIN(bucket_max(i), max);
+        }
+    }
+
+    return max;
+}
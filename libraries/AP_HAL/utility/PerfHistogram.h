@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * log-scaled histogram of elapsed times shared by the HALs keeping perf
+ * counter histograms: 4 buckets per power of 2, i.e. a resolution better
+ * than 25%. Values below 4 have a bucket each and the last bucket
+ * collects everything above ~1100s in nanoseconds.
+ */
+#define AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT 2
+#define AP_PERF_HISTOGRAM_BUCKETS 160
+
+class PerfHistogram {
+public:
+    /* bucket an elapsed time is counted in */
+    static unsigned int bucket(uint64_t elapsed);
+
+    /* largest elapsed time counted in a bucket */
+    static uint64_t bucket_max(unsigned int bucket);
+
+    /*
+     * smallest elapsed time greater than @fraction of the @count samples
+     * in @buckets, never more than the largest sample @max
+     */
+    static uint64_t percentile(const uint32_t buckets[AP_PERF_HISTOGRAM_BUCKETS],
+                               uint64_t count, float fraction, uint64_t max);
+};
@@ -82,6 +82,14 @@ void DigitalSource_Sysfs::toggle()
 
 void GPIO_Sysfs::init()
 {
+    if (_value_fds != nullptr) {
+        return;
+    }
+
+    _value_fds = new int[n_pins];
+    for (uint8_t i = 0; i < n_pins; i++) {
+        _value_fds[i] = -1;
+    }
 }
 
 void GPIO_Sysfs::pinMode(uint8_t vpin, uint8_t output)
@@ -121,12 +129,24 @@ int GPIO_Sysfs::_open_pin_value(unsigned int pin, int flags)
     return fd;
 }
 
+int GPIO_Sysfs::_get_value_fd(uint8_t vpin)
+{
+    if (_value_fds == nullptr) {
+        init();
+    }
+
+    if (_value_fds[vpin] < 0 && _export_pin(vpin)) {
+        _value_fds[vpin] = _open_pin_value(pin_table[vpin], O_RDWR);
+    }
+
+    return _value_fds[vpin];
+}
+
 uint8_t GPIO_Sysfs::read(uint8_t vpin)
 {
     assert_vpin(vpin, n_pins, LOW);
 
-    const unsigned pin = pin_table[vpin];
-    int fd = _open_pin_value(pin, O_RDONLY);
+    int fd = _get_value_fd(vpin);
 
     if (fd < 0) {
         goto error;
@@ -137,8 +157,6 @@ uint8_t GPIO_Sysfs::read(uint8_t vpin)
         goto error;
     }
 
-    close(fd);
-
     return char_value - '0';
 
 error:
@@ -150,8 +168,7 @@ void GPIO_Sysfs::write(uint8_t vpin, uint8_t value)
 {
     assert_vpin(vpin, n_pins);
 
-    const unsigned pin = pin_table[vpin];
-    int fd = _open_pin_value(pin, O_WRONLY);
+    int fd = _get_value_fd(vpin);
 
     if (fd < 0) {
         goto error;
@@ -161,7 +178,6 @@ void GPIO_Sysfs::write(uint8_t vpin, uint8_t value)
         goto error;
     }
 
-    close(fd);
     return;
 
 error:
@@ -68,6 +68,15 @@ protected:
     void _pinMode(unsigned int pin, uint8_t output);
     int _open_pin_value(unsigned int pin, int flags);
 
+    /*
+     * Return the cached value file descriptor of @vpin, opening and
+     * exporting it on first use. Returns -1 on failure.
+     */
+    int _get_value_fd(uint8_t vpin);
+
+    /* Value file descriptors indexed by vpin, opened on demand */
+    int *_value_fds = nullptr;
+
     /*
      * Make pin available for use. This function should be called before
      * calling functions that use the pin number as parameter.
@@ -43,6 +43,7 @@
 #include "SPIDevice.h"
 #include "SPIUARTDriver.h"
 #include "Scheduler.h"
+#include "Perf.h"
 #include "Storage.h"
 #include "UARTDriver.h"
 #include "Util.h"
@@ -261,6 +262,9 @@ void _usage(void)
     printf("\tmodule support:\n");
     printf("\t                   --module-directory %s\n", AP_MODULE_DEFAULT_DIRECTORY);
     printf("\t                   -M %s\n", AP_MODULE_DEFAULT_DIRECTORY);
+    printf("\ttrace of perf counters (written on SIGUSR1 and exit):\n");
+    printf("\t                   --trace /var/APM/logs/trace.json\n");
+    printf("\t                   -T /var/APM/logs/trace.json\n");
 }
 
 void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
@@ -284,11 +288,12 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"log-directory",       true,  0, 'l'},
         {"terrain-directory",   true,  0, 't'},
         {"module-directory",    true,  0, 'M'},
+        {"trace",               true,  0, 'T'},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:l:t:he:SM:",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:l:t:he:SM:T:",
                     options);
 
     /*
@@ -331,6 +336,12 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         case 'M':
             module_path = gopt.optarg;
             break;
+        case 'T':
+            if (!Perf::get_instance()->enable_trace(gopt.optarg)) {
+                printf("Failed to enable trace\n");
+                exit(1);
+            }
+            break;
         case 'h':
             _usage();
             exit(0);
@@ -95,6 +95,10 @@ public:
     int fd = -1;
     uint8_t bus;
     uint8_t ref;
+
+    /* bus utilization: time spent in transfers and failed transfers */
+    AP_HAL::Util::perf_counter_t perf_transfer;
+    AP_HAL::Util::perf_counter_t perf_error;
 };
 
 I2CBus::~I2CBus()
@@ -135,6 +139,15 @@ int I2CBus::open(uint8_t n)
 
     bus = n;
 
+    /* Perf counters keep a reference to their name and are never freed */
+    char *name;
+    if (asprintf(&name, "i2c-%u", n) > 0) {
+        perf_transfer = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, name);
+    }
+    if (asprintf(&name, "i2c-%u_errors", n) > 0) {
+        perf_error = hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, name);
+    }
+
     return fd;
 }
 
@@ -180,11 +193,18 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
 
     int r;
     unsigned retries = _retries;
+    hal.util->perf_begin(_bus.perf_transfer);
     do {
         r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
     } while (r == -1 && retries-- > 0);
+    hal.util->perf_end(_bus.perf_transfer);
 
-    return r != -1;
+    if (r == -1) {
+        hal.util->perf_count(_bus.perf_error);
+        return false;
+    }
+
+    return true;
 }
 
 bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
@@ -219,11 +239,14 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
 
         int r;
         unsigned retries = _retries;
+        hal.util->perf_begin(_bus.perf_transfer);
         do {
             r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
         } while (r == -1 && retries-- > 0);
+        hal.util->perf_end(_bus.perf_transfer);
 
         if (r == -1) {
+            hal.util->perf_count(_bus.perf_error);
             return false;
         }
 
@@ -120,12 +120,27 @@ uint32_t PWM_Sysfs_Base::get_freq()
 
 bool PWM_Sysfs_Base::set_duty_cycle(uint32_t nsec_duty_cycle)
 {
+    if (_duty_cycle_written && nsec_duty_cycle == _nsec_duty_cycle_value) {
+        return true;
+    }
+
+    /* Format the value by hand from the end of the buffer: this is called
+     * for every channel on every loop, so avoid going through stdio */
+    char buf[sizeof("4294967295")];
+    char *p = buf + sizeof(buf);
+    uint32_t v = nsec_duty_cycle;
+    do {
+        *--p = '0' + v % 10;
+        v /= 10;
+    } while (v);
+
     /* Don't log fails since this could spam the console */
-    if (dprintf(_duty_cycle_fd, "%u", nsec_duty_cycle) < 0) {
+    if (::pwrite(_duty_cycle_fd, p, buf + sizeof(buf) - p, 0) < 0) {
         return false;
     }
 
     _nsec_duty_cycle_value = nsec_duty_cycle;
+    _duty_cycle_written = true;
     return true;
 }
 
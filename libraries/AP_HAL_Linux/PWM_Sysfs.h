@@ -27,6 +27,10 @@ public:
      * This is the main method, to be called on hot path. It doesn't log any
      * failure so not to risk flooding the log. If logging is necessary, check
      * the return value.
+     *
+     * The value is written with a single pwrite() on a file descriptor kept
+     * open for the lifetime of the object and nothing is written if it's
+     * the same as the last successfully written value.
      */
     bool set_duty_cycle(uint32_t nsec_duty_cycle);
 
@@ -45,6 +49,7 @@ protected:
                    char *period_path, uint8_t channel);
 private:
     uint32_t _nsec_duty_cycle_value = 0;
+    bool _duty_cycle_written = false;
     int _duty_cycle_fd = -1;
     char *_export_path = NULL;
     char *_polarity_path = NULL;
@@ -15,10 +15,13 @@
  * You should have received a copy of the GNU General Public License along
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include <vector>
+#include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
@@ -32,11 +35,49 @@
 #define PRIu64 "llu"
 #endif
 
+/*
+ * Counters are periodically exported in binary form to this file; it can be
+ * disabled by defining it to nullptr.
+ */
+#ifndef HAL_LINUX_PERF_DUMP_FILE
+#define HAL_LINUX_PERF_DUMP_FILE HAL_BOARD_LOG_DIRECTORY "/perf.bin"
+#endif
+
+#define PERF_EXPORT_PERIOD_MS 10000
+
 using namespace Linux;
 
 static const AP_HAL::HAL &hal = AP_HAL::get_HAL();
 
 Perf *Perf::_instance;
+thread_local uint64_t Perf::_start[PERF_MAX_COUNTERS];
+volatile sig_atomic_t Perf::_trace_dump_requested;
+
+/*
+ * Binary dump: a header followed by one record per counter, all in host
+ * byte order.
+ */
+#define PERF_DUMP_MAGIC "APPF"
+#define PERF_DUMP_VERSION 1
+
+struct PACKED perf_dump_header {
+    char magic[4];
+    uint16_t version;
+    uint16_t n_counters;
+    uint16_t n_buckets;
+    uint16_t sub_buckets_shift;
+    uint64_t time_usec;
+};
+
+struct PACKED perf_dump_record {
+    char name[32];
+    uint8_t type;
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint32_t histogram[AP_PERF_HISTOGRAM_BUCKETS];
+};
 
 static inline uint64_t now_nsec()
 {
@@ -45,6 +86,38 @@ static inline uint64_t now_nsec()
     return ts.tv_nsec + (ts.tv_sec * NSEC_PER_SEC);
 }
 
+void Perf_Counter::add_sample(uint64_t elapsed)
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(elapsed, std::memory_order_relaxed);
+    histogram[PerfHistogram::bucket(elapsed)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t cur = min.load(std::memory_order_relaxed);
+    while (elapsed < cur &&
+           !min.compare_exchange_weak(cur, elapsed, std::memory_order_relaxed)) {
+    }
+
+    cur = max.load(std::memory_order_relaxed);
+    while (elapsed > cur &&
+           !max.compare_exchange_weak(cur, elapsed, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Perf_Counter::percentile(float fraction) const
+{
+    uint64_t n = 0;
+    uint32_t snapshot[AP_PERF_HISTOGRAM_BUCKETS];
+
+    /* buckets may be updated while we read them: use a consistent total */
+    for (unsigned int i = 0; i < AP_PERF_HISTOGRAM_BUCKETS; i++) {
+        snapshot[i] = histogram[i].load(std::memory_order_relaxed);
+        n += snapshot[i];
+    }
+
+    return PerfHistogram::percentile(snapshot, n, fraction,
+                                     max.load(std::memory_order_relaxed));
+}
+
 Perf *Perf::get_instance()
 {
     if (!_instance) {
@@ -62,16 +135,8 @@ void Perf::_debug_counters()
         return;
     }
 
-    pthread_rwlock_rdlock(&_perf_counters_lock);
-    unsigned int uc = _update_count;
-    auto v = _perf_counters;
-    pthread_rwlock_unlock(&_perf_counters_lock);
-
-    if (uc != _update_count) {
-        fprintf(stderr, "WARNING!! potentially wrong counters!!!");
-    }
-
-    for (auto &c : v) {
+    AP_HAL::Util::perf_counter_stats c;
+    for (uint16_t i = 0; get_stats(i, c); i++) {
         if (!c.count) {
             fprintf(stderr, "%-30s\t"
                     "(no events)\n", c.name);
@@ -80,9 +145,11 @@ void Perf::_debug_counters()
                     "count: %" PRIu64 "\t"
                     "min: %" PRIu64 "\t"
                     "max: %" PRIu64 "\t"
-                    "avg: %.4f\t"
-                    "stddev: %.4f\n",
-                    c.name, c.count, c.min, c.max, c.avg, sqrt(c.m2));
+                    "avg: %" PRIu64 "\t"
+                    "p50: %" PRIu64 "\t"
+                    "p99: %" PRIu64 "\t"
+                    "p99.9: %" PRIu64 "\n",
+                    c.name, c.count, c.min, c.max, c.avg, c.p50, c.p99, c.p999);
         } else {
             fprintf(stderr, "%-30s\t"
                     "count: %" PRIu64 "\n",
@@ -93,120 +160,168 @@ void Perf::_debug_counters()
     _last_debug_msec = now;
 }
 
+void Perf::_export_counters()
+{
+    if (_trace_dump_requested) {
+        _trace_dump_requested = 0;
+        if (!_trace.dump(_trace_path)) {
+            hal.console->printf("Perf: failed to write trace to %s\n", _trace_path);
+        }
+    }
+
+    uint64_t now = AP_HAL::millis64();
+
+    if (now - _last_export_msec < PERF_EXPORT_PERIOD_MS) {
+        return;
+    }
+
+    _last_export_msec = now;
+
+    const char *path = HAL_LINUX_PERF_DUMP_FILE;
+    if (path) {
+        dump(path);
+    }
+}
+
 Perf::Perf()
 {
-    if (pthread_rwlock_init(&_perf_counters_lock, nullptr) != 0) {
-        AP_HAL::panic("Perf: fail to initialize rw lock");
+    if (pthread_mutex_init(&_perf_counters_lock, nullptr) != 0) {
+        AP_HAL::panic("Perf: fail to initialize lock");
     }
 
-    /* TODO: this number should come from vehicle code - just estimate the
-     * number of perf counters for now; if we grow more, it will just
-     * reallocate the memory pool */
-    _perf_counters.reserve(50);
+    _perf_counters_count = 0;
+}
+
+void Perf::init()
+{
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&Perf::_export_counters, void));
 
 #ifdef DEBUG_PERF
     hal.scheduler->register_timer_process(FUNCTOR_BIND_MEMBER(&Perf::_debug_counters, void));
 #endif
 }
 
-void Perf::begin(Util::perf_counter_t pc)
+void Perf::_trace_signal_handler(int signum)
+{
+    _trace_dump_requested = 1;
+}
+
+void Perf::_dump_trace_at_exit()
+{
+    Perf *perf = get_instance();
+
+    perf->_trace.dump(perf->_trace_path);
+}
+
+bool Perf::enable_trace(const char *path)
+{
+    if (!_trace.enable()) {
+        return false;
+    }
+
+    _trace_path = path;
+
+    struct sigaction sa = {};
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = _trace_signal_handler;
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR1, &sa, nullptr) < 0) {
+        return false;
+    }
+
+    atexit(_dump_trace_at_exit);
+
+    return true;
+}
+
+Perf_Counter *Perf::_get_counter(Util::perf_counter_t pc)
 {
     uintptr_t idx = (uintptr_t)pc;
 
-    if (idx >= _perf_counters.size()) {
+    if (idx >= _perf_counters_count.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    return _perf_counters[idx];
+}
+
+void Perf::begin(Util::perf_counter_t pc)
+{
+    Perf_Counter *perf = _get_counter(pc);
+    if (!perf) {
         return;
     }
 
-    Perf_Counter &perf = _perf_counters[idx];
-    if (perf.type != Util::PC_ELAPSED) {
+    if (perf->type != Util::PC_ELAPSED) {
         hal.console->printf("perf_begin() called on perf_counter_t(%s) that"
                             " is not of PC_ELAPSED type.\n",
-                            perf.name);
+                            perf->name);
         return;
     }
 
-    if (perf.start != 0) {
+    uint64_t &start = _start[(uintptr_t)pc];
+    if (start != 0) {
         hal.console->printf("perf_begin() called twice on perf_counter_t(%s)\n",
-                            perf.name);
+                            perf->name);
         return;
     }
 
-    _update_count++;
-
-    perf.start = now_nsec();
+    start = now_nsec();
 
-    perf.lttng.begin(perf.name);
+    perf->lttng.begin(perf->name);
+    _trace.begin(perf->name, start);
 }
 
 void Perf::end(Util::perf_counter_t pc)
 {
-    uintptr_t idx = (uintptr_t)pc;
-
-    if (idx >= _perf_counters.size()) {
+    Perf_Counter *perf = _get_counter(pc);
+    if (!perf) {
         return;
     }
 
-    Perf_Counter &perf = _perf_counters[idx];
-    if (perf.type != Util::PC_ELAPSED) {
-        hal.console->printf("perf_begin() called on perf_counter_t(%s) that"
+    if (perf->type != Util::PC_ELAPSED) {
+        hal.console->printf("perf_end() called on perf_counter_t(%s) that"
                             " is not of PC_ELAPSED type.\n",
-                            perf.name);
+                            perf->name);
         return;
     }
 
-    if (perf.start == 0) {
-        hal.console->printf("perf_begin() called before begin() on perf_counter_t(%s)\n",
-                            perf.name);
+    uint64_t &start = _start[(uintptr_t)pc];
+    if (start == 0) {
+        hal.console->printf("perf_end() called before begin() on perf_counter_t(%s)\n",
+                            perf->name);
         return;
     }
 
-    _update_count++;
+    const uint64_t now = now_nsec();
 
-    const uint64_t elapsed = now_nsec() - perf.start;
-    perf.count++;
-    perf.total += elapsed;
+    perf->add_sample(now - start);
+    start = 0;
 
-    if (perf.min > elapsed) {
-        perf.min = elapsed;
-    }
-
-    if (perf.max < elapsed) {
-        perf.max = elapsed;
-    }
-
-    /*
-     * Maintain avg and variance of interval in nanoseconds
-     * Knuth/Welford recursive avg and variance of update intervals (via Wikipedia)
-     * Same implementation of PX4.
-     */
-    const double delta_intvl = elapsed - perf.avg;
-    perf.avg += (delta_intvl / perf.count);
-    perf.m2 += (delta_intvl * (elapsed - perf.avg));
-    perf.start = 0;
-
-    perf.lttng.end(perf.name);
+    perf->lttng.end(perf->name);
+    _trace.end(perf->name, now);
 }
 
 void Perf::count(Util::perf_counter_t pc)
 {
-    uintptr_t idx = (uintptr_t)pc;
-
-    if (idx >= _perf_counters.size()) {
+    Perf_Counter *perf = _get_counter(pc);
+    if (!perf) {
         return;
     }
 
-    Perf_Counter &perf = _perf_counters[idx];
-    if (perf.type != Util::PC_COUNT) {
-        hal.console->printf("perf_begin() called on perf_counter_t(%s) that"
+    if (perf->type != Util::PC_COUNT) {
+        hal.console->printf("perf_count() called on perf_counter_t(%s) that"
                             " is not of PC_COUNT type.\n",
-                            perf.name);
+                            perf->name);
         return;
     }
 
-    _update_count++;
-    perf.count++;
+    uint64_t count = perf->count.fetch_add(1, std::memory_order_relaxed) + 1;
 
-    perf.lttng.count(perf.name, perf.count);
+    perf->lttng.count(perf->name, count);
+    if (_trace.enabled()) {
+        _trace.count(perf->name, now_nsec(), count);
+    }
 }
 
 Util::perf_counter_t Perf::add(Util::perf_counter_type type, const char *name)
@@ -219,10 +334,102 @@ Util::perf_counter_t Perf::add(Util::perf_counter_type type, const char *name)
         return (Util::perf_counter_t)(uintptr_t) -1;
     }
 
-    pthread_rwlock_wrlock(&_perf_counters_lock);
-    Util::perf_counter_t pc = (Util::perf_counter_t) _perf_counters.size();
-    _perf_counters.emplace_back(type, name);
-    pthread_rwlock_unlock(&_perf_counters_lock);
+    pthread_mutex_lock(&_perf_counters_lock);
+
+    unsigned int idx = _perf_counters_count.load(std::memory_order_relaxed);
+    if (idx >= PERF_MAX_COUNTERS) {
+        pthread_mutex_unlock(&_perf_counters_lock);
+        hal.console->printf("Perf: no space for counter %s\n", name);
+        return (Util::perf_counter_t)(uintptr_t) -1;
+    }
+
+    _perf_counters[idx] = new Perf_Counter(type, name);
+
+    /* publish the counter only after it's completely initialized */
+    _perf_counters_count.store(idx + 1, std::memory_order_release);
+
+    pthread_mutex_unlock(&_perf_counters_lock);
+
+    return (Util::perf_counter_t)(uintptr_t) idx;
+}
+
+bool Perf::get_stats(uint16_t idx, AP_HAL::Util::perf_counter_stats &stats)
+{
+    Perf_Counter *perf = _get_counter((Util::perf_counter_t)(uintptr_t) idx);
+    if (!perf) {
+        return false;
+    }
+
+    stats.name = perf->name;
+    stats.type = perf->type;
+    stats.count = perf->count.load(std::memory_order_relaxed);
+
+    if (perf->type != Util::PC_ELAPSED || stats.count == 0) {
+        stats.min = stats.max = stats.avg = 0;
+        stats.p50 = stats.p99 = stats.p999 = 0;
+        return true;
+    }
+
+    stats.min = perf->min.load(std::memory_order_relaxed);
+    stats.max = perf->max.load(std::memory_order_relaxed);
+    stats.avg = perf->total.load(std::memory_order_relaxed) / stats.count;
+    stats.p50 = perf->percentile(0.5f);
+    stats.p99 = perf->percentile(0.99f);
+    stats.p999 = perf->percentile(0.999f);
+
+    return true;
+}
+
+bool Perf::dump(const char *path)
+{
+    char tmp_path[PATH_MAX];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        return false;
+    }
+
+    int fd = ::open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    const unsigned int n = _perf_counters_count.load(std::memory_order_acquire);
+
+    struct perf_dump_header header;
+    memcpy(header.magic, PERF_DUMP_MAGIC, sizeof(header.magic));
+    header.version = PERF_DUMP_VERSION;
+    header.n_counters = n;
+    header.n_buckets = AP_PERF_HISTOGRAM_BUCKETS;
+    header.sub_buckets_shift = AP_PERF_HISTOGRAM_SUB_BUCKETS_SHIFT;
+    header.time_usec = AP_HAL::micros64();
+
+    bool ret = ::write(fd, &header, sizeof(header)) == sizeof(header);
+
+    for (unsigned int i = 0; ret && i < n; i++) {
+        const Perf_Counter *perf = _perf_counters[i];
+        struct perf_dump_record r;
+
+        strncpy(r.name, perf->name, sizeof(r.name));
+        r.name[sizeof(r.name) - 1] = '\0';
+        r.type = perf->type;
+        r.count = perf->count.load(std::memory_order_relaxed);
+        r.total = perf->total.load(std::memory_order_relaxed);
+        r.min = perf->min.load(std::memory_order_relaxed);
+        r.max = perf->max.load(std::memory_order_relaxed);
+        for (unsigned int j = 0; j < AP_PERF_HISTOGRAM_BUCKETS; j++) {
+            r.histogram[j] = perf->histogram[j].load(std::memory_order_relaxed);
+        }
+
+        ret = ::write(fd, &r, sizeof(r)) == sizeof(r);
+    }
+
+    if (::close(fd) < 0) {
+        ret = false;
+    }
+
+    if (!ret || ::rename(tmp_path, path) < 0) {
+        ::unlink(tmp_path);
+        return false;
+    }
 
-    return pc;
+    return true;
 }
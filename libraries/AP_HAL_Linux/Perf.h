@@ -20,13 +20,19 @@
 #include <atomic>
 #include <limits.h>
 #include <pthread.h>
-#include <vector>
+#include <signal.h>
+
+#include <AP_HAL/utility/PerfHistogram.h>
 
 #include "AP_HAL_Linux.h"
 #include "Perf_Lttng.h"
+#include "Perf_Trace.h"
 #include "Thread.h"
 #include "Util.h"
 
+/* Maximum number of perf counters that can be allocated */
+#define PERF_MAX_COUNTERS 128
+
 namespace Linux {
 
 class Perf_Counter {
@@ -37,27 +43,43 @@ public:
     Perf_Counter(perf_counter_type type_, const char *name_)
         : name{name_}
         , type{type_}
+        , count{0}
+        , total{0}
         , min{ULONG_MAX}
+        , max{0}
     {
+        for (auto &b : histogram) {
+            b = 0;
+        }
     }
 
+    /* Add an elapsed time sample; safe to call from any thread */
+    void add_sample(uint64_t elapsed);
+
+    /* Return the smallest elapsed time greater than @fraction of samples */
+    uint64_t percentile(float fraction) const;
+
     const char *name;
     Perf_Lttng lttng;
 
-    perf_counter_type type;
+    const perf_counter_type type;
 
-    uint64_t count;
+    std::atomic<uint64_t> count;
 
     /* Everything below is in nanoseconds */
-    uint64_t start;
-    uint64_t total;
-    uint64_t min;
-    uint64_t max;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
 
-    double avg;
-    double m2;
+    std::atomic<uint32_t> histogram[AP_PERF_HISTOGRAM_BUCKETS];
 };
 
+/*
+ * Perf counters are allocated once and never freed, so they are accessed
+ * without locks: updates use relaxed atomic operations and the start time of
+ * PC_ELAPSED counters is kept per thread so the same counter can be used
+ * from several threads at the same time.
+ */
 class Perf {
     using perf_counter_type = AP_HAL::Util::perf_counter_type;
     using perf_counter_t = AP_HAL::Util::perf_counter_t;
@@ -67,30 +89,60 @@ public:
 
     static Perf *get_instance();
 
+    /* Start the periodic export of counters, after the scheduler is ready */
+    void init();
+
     perf_counter_t add(perf_counter_type type, const char *name);
 
     void begin(perf_counter_t pc);
     void end(perf_counter_t pc);
     void count(perf_counter_t pc);
 
-    unsigned int get_update_count() { return _update_count; }
+    bool get_stats(uint16_t idx, AP_HAL::Util::perf_counter_stats &stats);
+
+    /*
+     * Write all the counters, including their histograms, to the file in
+     * @path. The file is replaced atomically so readers always see a
+     * complete dump.
+     */
+    bool dump(const char *path);
+
+    /*
+     * Record a trace of all perf counter events, written as Chrome
+     * trace-event JSON to @path on SIGUSR1 and when the process exits.
+     */
+    bool enable_trace(const char *path);
 
 private:
     static Perf *_instance;
 
     Perf();
 
+    Perf_Counter *_get_counter(perf_counter_t pc);
+
     void _debug_counters();
+    void _export_counters();
 
-    uint64_t _last_debug_msec;
+    static void _trace_signal_handler(int signum);
+    static void _dump_trace_at_exit();
 
-    std::vector<Perf_Counter> _perf_counters;
+    uint64_t _last_debug_msec = 0;
+    uint64_t _last_export_msec = 0;
+
+    Perf_Counter *_perf_counters[PERF_MAX_COUNTERS];
+
+    /* number of perf counters published in _perf_counters */
+    std::atomic<unsigned int> _perf_counters_count;
 
     /* synchronize addition of new perf counters */
-    pthread_rwlock_t _perf_counters_lock;
+    pthread_mutex_t _perf_counters_lock;
+
+    /* start of PC_ELAPSED counters for the calling thread */
+    static thread_local uint64_t _start[PERF_MAX_COUNTERS];
 
-    /* allow to check if memory pool has changed */
-    std::atomic<unsigned int> _update_count;
+    Perf_Trace _trace;
+    const char *_trace_path = nullptr;
+    static volatile sig_atomic_t _trace_dump_requested;
 };
 
 }
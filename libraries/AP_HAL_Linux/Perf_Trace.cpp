@@ -0,0 +1,190 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+
+#include "Perf_Trace.h"
+
+using namespace Linux;
+
+bool Perf_Trace::enable(uint32_t n_events)
+{
+    if (_events) {
+        return true;
+    }
+
+    /* round down to a power of 2 so the index can be masked */
+    uint32_t n = 1;
+    while (n * 2 <= n_events) {
+        n *= 2;
+    }
+
+    event *events = new event[n];
+    if (!events) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        events[i].seq = 0;
+    }
+
+    for (auto &t : _threads) {
+        t.tid = 0;
+    }
+
+    _mask = n - 1;
+    _events = events;
+
+    return true;
+}
+
+pid_t Perf_Trace::_register_thread()
+{
+    pid_t tid = syscall(SYS_gettid);
+
+    unsigned int idx = _n_threads.fetch_add(1, std::memory_order_relaxed);
+    if (idx < PERF_TRACE_MAX_THREADS) {
+        thread_info &t = _threads[idx];
+        if (pthread_getname_np(pthread_self(), t.name, sizeof(t.name)) != 0) {
+            t.name[0] = '\0';
+        }
+        t.tid.store(tid, std::memory_order_release);
+    }
+
+    return tid;
+}
+
+void Perf_Trace::_record(char phase, const char *name, uint64_t ts_nsec, uint64_t val)
+{
+    static thread_local pid_t tid;
+
+    if (!_events) {
+        return;
+    }
+
+    if (!tid) {
+        tid = _register_thread();
+    }
+
+    const uint64_t idx = _next.fetch_add(1, std::memory_order_relaxed);
+    event &e = _events[idx & _mask];
+
+    e.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    e.ts_nsec = ts_nsec;
+    e.name = name;
+    e.val = val;
+    e.tid = tid;
+    e.phase = phase;
+
+    e.seq.store(idx + 1, std::memory_order_release);
+}
+
+/* perf counter names are plain identifiers, but don't produce invalid JSON */
+static void write_json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', f);
+        }
+        if ((unsigned char)*s >= 0x20) {
+            fputc(*s, f);
+        }
+    }
+    fputc('"', f);
+}
+
+bool Perf_Trace::dump(const char *path)
+{
+    if (!_events) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "we");
+    if (!f) {
+        return false;
+    }
+
+    const pid_t pid = getpid();
+    const uint64_t size = (uint64_t)_mask + 1;
+    const uint64_t next = _next.load(std::memory_order_acquire);
+    const uint64_t first = next > size ? next - size : 0;
+    bool comma = false;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    const unsigned int n_threads = MIN(_n_threads.load(std::memory_order_relaxed),
+                                       (unsigned int)PERF_TRACE_MAX_THREADS);
+    for (unsigned int i = 0; i < n_threads; i++) {
+        const pid_t tid = _threads[i].tid.load(std::memory_order_acquire);
+        if (!tid) {
+            continue;
+        }
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                "\"args\":{\"name\":", comma ? ",\n" : "", pid, tid);
+        write_json_string(f, _threads[i].name);
+        fprintf(f, "}}");
+        comma = true;
+    }
+
+    for (uint64_t idx = first; idx < next; idx++) {
+        const event &e = _events[idx & _mask];
+
+        if (e.seq.load(std::memory_order_acquire) != idx + 1) {
+            /* being written or already overwritten */
+            continue;
+        }
+
+        const char phase = e.phase;
+        const char *name = e.name;
+        const uint64_t ts_nsec = e.ts_nsec;
+        const uint64_t val = e.val;
+        const pid_t tid = e.tid;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) != idx + 1) {
+            continue;
+        }
+
+        fprintf(f, "%s{\"name\":", comma ? ",\n" : "");
+        write_json_string(f, name);
+        fprintf(f, ",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03u,\"pid\":%d,\"tid\":%d",
+                phase, ts_nsec / 1000, (unsigned int)(ts_nsec % 1000), pid, tid);
+        if (phase == 'C') {
+            fprintf(f, ",\"args\":{\"count\":%" PRIu64 "}", val);
+        }
+        fprintf(f, "}");
+        comma = true;
+    }
+
+    fprintf(f, "\n]}\n");
+
+    bool ret = !ferror(f);
+    if (fclose(f) != 0) {
+        ret = false;
+    }
+
+    return ret;
+}
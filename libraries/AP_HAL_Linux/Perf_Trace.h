@@ -0,0 +1,80 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <inttypes.h>
+#include <sys/types.h>
+
+#include "AP_HAL_Linux.h"
+
+/* Default number of events kept: the most recent ones overwrite the oldest */
+#define PERF_TRACE_DEFAULT_EVENTS (32 * 1024)
+
+/* Maximum number of threads whose names are reported in the trace */
+#define PERF_TRACE_MAX_THREADS 32
+
+namespace Linux {
+
+/*
+ * Flight recorder of perf counter events, i.e. scheduler tasks, timer and IO
+ * processes and bus transfers, kept in memory without taking any lock and
+ * exported as Chrome trace-event JSON that can be loaded in
+ * chrome://tracing or Perfetto. This is the same information emitted as
+ * LTTng tracepoints by Perf_Lttng, but doesn't need LTTng to be installed
+ * on the board.
+ */
+class Perf_Trace {
+public:
+    /* Start recording; events are allocated once here */
+    bool enable(uint32_t n_events = PERF_TRACE_DEFAULT_EVENTS);
+
+    bool enabled() const { return _events != nullptr; }
+
+    void begin(const char *name, uint64_t ts_nsec) { _record('B', name, ts_nsec, 0); }
+    void end(const char *name, uint64_t ts_nsec) { _record('E', name, ts_nsec, 0); }
+    void count(const char *name, uint64_t ts_nsec, uint64_t val) { _record('C', name, ts_nsec, val); }
+
+    /* Write the events currently in the buffer to @path */
+    bool dump(const char *path);
+
+private:
+    struct event {
+        /* index + 1 of the event in the stream, 0 while being written */
+        std::atomic<uint64_t> seq;
+        uint64_t ts_nsec;
+        const char *name;
+        uint64_t val;
+        pid_t tid;
+        char phase;
+    };
+
+    struct thread_info {
+        std::atomic<pid_t> tid;
+        char name[16];
+    };
+
+    void _record(char phase, const char *name, uint64_t ts_nsec, uint64_t val);
+    pid_t _register_thread();
+
+    event *_events = nullptr;
+    uint32_t _mask;
+    std::atomic<uint64_t> _next{0};
+
+    thread_info _threads[PERF_TRACE_MAX_THREADS];
+    std::atomic<unsigned int> _n_threads{0};
+};
+
+}
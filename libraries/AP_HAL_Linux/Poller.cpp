@@ -19,6 +19,7 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -57,14 +58,14 @@ void Poller::unregister_pollable(const Pollable *p)
     }
 }
 
-int Poller::poll() const
+int Poller::poll(int timeout_ms) const
 {
     const int max_events = 16;
     epoll_event events[max_events];
     int r;
 
     do {
-        r = epoll_wait(_epfd, events, max_events, -1);
+        r = epoll_wait(_epfd, events, max_events, timeout_ms);
     } while (r < 0 && errno == EINTR);
 
     if (r < 0) {
@@ -104,4 +105,30 @@ Pollable::~Pollable()
     }
 }
 
+EventPollable::EventPollable(event_cb_t cb)
+    : Pollable(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    , _cb(cb)
+{
+}
+
+bool EventPollable::signal()
+{
+    uint64_t val = 1;
+
+    return ::write(_fd, &val, sizeof(val)) == sizeof(val);
+}
+
+void EventPollable::on_can_read()
+{
+    uint64_t val;
+
+    if (::read(_fd, &val, sizeof(val)) != sizeof(val)) {
+        return;
+    }
+
+    if (_cb) {
+        _cb();
+    }
+}
+
 }
@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include "AP_HAL/utility/RingBuffer.h"
+#include "AP_HAL/utility/functor.h"
 #include "Semaphores.h"
 
 namespace Linux {
@@ -46,6 +47,26 @@ protected:
     int _fd;
 };
 
+/*
+ * Pollable backed by an eventfd, used to wake up a thread blocked in
+ * Poller::poll() from another thread. The callback is called on the polling
+ * thread, once for any number of signal() calls made since the last time it
+ * ran.
+ */
+class EventPollable : public Pollable {
+public:
+    FUNCTOR_TYPEDEF(event_cb_t, void);
+
+    EventPollable(event_cb_t cb);
+
+    bool signal();
+
+    void on_can_read() override;
+
+private:
+    event_cb_t _cb;
+};
+
 class Poller {
 public:
     Poller() : _epfd(epoll_create1(EPOLL_CLOEXEC)) { }
@@ -54,7 +75,12 @@ public:
     bool register_pollable(Pollable*, uint32_t events);
     void unregister_pollable(const Pollable*);
 
-    int poll() const;
+    /*
+     * Wait for events on the registered Pollables and dispatch them. Returns
+     * the number of events, 0 on timeout or a negative errno on failure. A
+     * negative @timeout_ms waits forever.
+     */
+    int poll(int timeout_ms = -1) const;
 
 private:
     int _epfd;
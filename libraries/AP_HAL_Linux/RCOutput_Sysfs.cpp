@@ -28,6 +28,7 @@ RCOutput_Sysfs::RCOutput_Sysfs(uint8_t chip, uint8_t channel_base, uint8_t chann
     , _channel_base(channel_base)
     , _channel_count(channel_count)
     , _pwm_channels(new PWM_Sysfs_Base *[_channel_count])
+    , _pending(new uint16_t[_channel_count])
 {
 }
 
@@ -37,7 +38,8 @@ RCOutput_Sysfs::~RCOutput_Sysfs()
         delete _pwm_channels[i];
     }
 
-    delete _pwm_channels;
+    delete [] _pwm_channels;
+    delete [] _pending;
 }
 
 void RCOutput_Sysfs::init()
@@ -102,7 +104,31 @@ void RCOutput_Sysfs::write(uint8_t ch, uint16_t period_us)
         return;
     }
 
-    _pwm_channels[ch]->set_duty_cycle(usec_to_nsec(period_us));
+    _pending[ch] = period_us;
+    _pending_mask |= (1U << ch);
+
+    if (!_corked) {
+        push();
+    }
+}
+
+void RCOutput_Sysfs::cork()
+{
+    _corked = true;
+}
+
+void RCOutput_Sysfs::push()
+{
+    _corked = false;
+
+    /* Each channel is a separate sysfs file, so the best we can do is to
+     * delay all the writes of a frame to the same point in time */
+    for (uint8_t i = 0; _pending_mask != 0 && i < _channel_count; i++) {
+        if (_pending_mask & (1U << i)) {
+            _pwm_channels[i]->set_duty_cycle(usec_to_nsec(_pending[i]));
+            _pending_mask &= ~(1U << i);
+        }
+    }
 }
 
 uint16_t RCOutput_Sysfs::read(uint8_t ch)
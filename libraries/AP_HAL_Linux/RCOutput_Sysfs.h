@@ -21,6 +21,8 @@ public:
     void enable_ch(uint8_t ch);
     void disable_ch(uint8_t ch);
     void write(uint8_t ch, uint16_t period_us);
+    void cork() override;
+    void push() override;
     uint16_t read(uint8_t ch);
     void read(uint16_t *period_us, uint8_t len);
 
@@ -29,6 +31,11 @@ private:
     const uint8_t _channel_base;
     const uint8_t _channel_count;
     PWM_Sysfs_Base **_pwm_channels;
+
+    // for handling cork()/push()
+    bool _corked = false;
+    uint16_t *_pending;
+    uint32_t _pending_mask = 0;
 };
 
 }
@@ -163,6 +163,10 @@ public:
     uint16_t kernel_cs;
     uint8_t ref;
     int16_t last_mode = -1;
+
+    /* bus utilization: time spent in transfers and failed transfers */
+    AP_HAL::Util::perf_counter_t perf_transfer;
+    AP_HAL::Util::perf_counter_t perf_error;
 };
 
 SPIBus::~SPIBus()
@@ -201,6 +205,15 @@ int SPIBus::open(uint16_t bus_, uint16_t kernel_cs_)
     bus = bus_;
     kernel_cs = kernel_cs_;
 
+    /* Perf counters keep a reference to their name and are never freed */
+    char *name;
+    if (asprintf(&name, "spi-%u.%u", bus, kernel_cs) > 0) {
+        perf_transfer = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, name);
+    }
+    if (asprintf(&name, "spi-%u.%u_errors", bus, kernel_cs) > 0) {
+        perf_error = hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, name);
+    }
+
     return fd;
 }
 
@@ -307,11 +320,14 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
         _bus.last_mode = _desc.mode;
     }
 
+    hal.util->perf_begin(_bus.perf_transfer);
     _cs_assert();
     r = ioctl(_bus.fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
     _cs_release();
+    hal.util->perf_end(_bus.perf_transfer);
 
     if (r == -1) {
+        hal.util->perf_count(_bus.perf_error);
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
                             _bus.fd, strerror(errno));
         return false;
@@ -346,11 +362,14 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
         return false;
     }
 
+    hal.util->perf_begin(_bus.perf_transfer);
     _cs_assert();
     r = ioctl(_bus.fd, SPI_IOC_MESSAGE(1), &msgs);
     _cs_release();
+    hal.util->perf_end(_bus.perf_transfer);
 
     if (r == -1) {
+        hal.util->perf_count(_bus.perf_error);
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
                             _bus.fd, strerror(errno));
         return false;
@@ -37,7 +37,17 @@ extern const AP_HAL::HAL& hal;
 #define APM_LINUX_IO_PRIORITY           10
 
 #define APM_LINUX_TIMER_RATE            1000
+#if HAL_LINUX_UARTS_ON_TIMER_THREAD
 #define APM_LINUX_UART_RATE             100
+#else
+/* The uart thread blocks on _uart_poller by itself, see _uart_task() */
+#define APM_LINUX_UART_RATE             0
+#endif
+/*
+ * Maximum time the uart thread sleeps while there are UARTs that can't be
+ * polled or bytes waiting for the device to accept them
+ */
+#define APM_LINUX_UART_POLL_TIMEOUT_MS  10
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_NAVIO ||    \
     CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_ERLEBRAIN2 || \
     CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BH || \
@@ -88,6 +98,14 @@ void Scheduler::init()
     struct sched_param param = { .sched_priority = APM_LINUX_MAIN_PRIORITY };
     sched_setscheduler(0, SCHED_FIFO, &param);
 
+#if !HAL_LINUX_UARTS_ON_TIMER_THREAD
+    _setup_uart_poller();
+#endif
+
+    _perf_timers = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "APM_timers");
+    _perf_io_timers = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "APM_IO_timers");
+    _perf_uarts = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "APM_uarts");
+
     /* set barrier to N + 1 threads: worker threads + main */
     unsigned n_threads = ARRAY_SIZE(sched_table) + 1;
     pthread_barrier_init(&_initialized_barrier, nullptr, n_threads);
@@ -290,6 +308,9 @@ void Scheduler::_timer_task()
     if (!_timer_semaphore.take(0)) {
         printf("Failed to take timer semaphore in %s\n", __PRETTY_FUNCTION__);
     }
+
+    hal.util->perf_begin(_perf_timers);
+
     // now call the timer based drivers
     for (i = 0; i < _num_timer_procs; i++) {
         if (_timer_proc[i]) {
@@ -318,6 +339,8 @@ void Scheduler::_timer_task()
         }
     }
 
+    hal.util->perf_end(_perf_timers);
+
     _timer_semaphore.give();
 
     // and the failsafe, if one is setup
@@ -344,6 +367,8 @@ void Scheduler::_run_io(void)
         return;
     }
 
+    hal.util->perf_begin(_perf_io_timers);
+
     // now call the IO based drivers
     for (int i = 0; i < _num_io_procs; i++) {
         if (_io_proc[i]) {
@@ -351,6 +376,8 @@ void Scheduler::_run_io(void)
         }
     }
 
+    hal.util->perf_end(_perf_io_timers);
+
     _io_semaphore.give();
 }
 
@@ -359,6 +386,9 @@ void Scheduler::_run_io(void)
  */
 void Scheduler::_run_uarts()
 {
+    hal.util->perf_begin(_perf_uarts);
+    _last_uart_run_ms = AP_HAL::millis();
+
     // process any pending serial bytes
     UARTDriver::from(hal.uartA)->_timer_tick();
     UARTDriver::from(hal.uartB)->_timer_tick();
@@ -372,6 +402,27 @@ void Scheduler::_run_uarts()
 #endif
     UARTDriver::from(hal.uartE)->_timer_tick();
     UARTDriver::from(hal.uartF)->_timer_tick();
+
+    hal.util->perf_end(_perf_uarts);
+}
+
+void Scheduler::_setup_uart_poller()
+{
+    if (!_uart_poller.register_pollable(&_uart_wakeup, EPOLLIN)) {
+        AP_HAL::panic("Failed to setup uart poller");
+    }
+
+    UARTDriver::from(hal.uartA)->set_poller(&_uart_poller, &_uart_wakeup);
+    UARTDriver::from(hal.uartB)->set_poller(&_uart_poller, &_uart_wakeup);
+    /*
+     * on RASPILOT uartC is an RPIOUARTDriver. It only registers with the
+     * poller when it is an external tty, which is serviced by the generic
+     * UARTDriver code; the RaspilotIO SPI UART never has a file descriptor
+     * to register and stays serviced periodically
+     */
+    UARTDriver::from(hal.uartC)->set_poller(&_uart_poller, &_uart_wakeup);
+    UARTDriver::from(hal.uartE)->set_poller(&_uart_poller, &_uart_wakeup);
+    UARTDriver::from(hal.uartF)->set_poller(&_uart_poller, &_uart_wakeup);
 }
 
 void Scheduler::_rcin_task()
@@ -384,7 +435,23 @@ void Scheduler::_rcin_task()
 void Scheduler::_uart_task()
 {
 #if !HAL_LINUX_UARTS_ON_TIMER_THREAD
-    _run_uarts();
+    /*
+     * UARTs registered with the poller are serviced as soon as their device
+     * is ready and all of them when a write is queued on an empty buffer.
+     * All of them are also serviced at least every
+     * APM_LINUX_UART_POLL_TIMEOUT_MS, keeping the old periodic behavior for
+     * anything else: devices that can't be polled, reconnections and
+     * retries of writes. A busy UART waking the poller must not hold that
+     * off, so the period is checked whatever poll() returns.
+     */
+    uint32_t elapsed_ms = AP_HAL::millis() - _last_uart_run_ms;
+    if (elapsed_ms < APM_LINUX_UART_POLL_TIMEOUT_MS) {
+        _uart_poller.poll(APM_LINUX_UART_POLL_TIMEOUT_MS - elapsed_ms);
+        elapsed_ms = AP_HAL::millis() - _last_uart_run_ms;
+    }
+    if (elapsed_ms >= APM_LINUX_UART_POLL_TIMEOUT_MS) {
+        _run_uarts();
+    }
 #endif
 }
 
@@ -452,5 +519,12 @@ bool Scheduler::SchedulerThread::_run()
 
     _sched._wait_all_threads();
 
+    if (_period_usec == 0) {
+        /* the task blocks by itself, waiting for events */
+        while (true) {
+            _task();
+        }
+    }
+
     return PeriodicThread::_run();
 }
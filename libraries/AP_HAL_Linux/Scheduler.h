@@ -3,6 +3,7 @@
 #include <pthread.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
 #include "Semaphores.h"
 #include "Thread.h"
 
@@ -14,6 +15,10 @@
 #define AP_LINUX_SENSORS_SCHED_POLICY  SCHED_FIFO
 #define AP_LINUX_SENSORS_SCHED_PRIO 12
 
+/* rate controller threads are woken by the sensor threads and should
+ * preempt them as soon as a new sample is in */
+#define AP_LINUX_RATE_CONTROL_SCHED_PRIO 13
+
 namespace Linux {
 
 class Scheduler : public AP_HAL::Scheduler {
@@ -93,6 +98,10 @@ private:
     AP_HAL::MemberProc _io_proc[LINUX_SCHEDULER_MAX_IO_PROCS];
     uint8_t _num_io_procs;
 
+    AP_HAL::Util::perf_counter_t _perf_timers;
+    AP_HAL::Util::perf_counter_t _perf_io_timers;
+    AP_HAL::Util::perf_counter_t _perf_uarts;
+
     SchedulerThread _timer_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_timer_task, void), *this};
     SchedulerThread _io_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_io_task, void), *this};
     SchedulerThread _rcin_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_rcin_task, void), *this};
@@ -107,6 +116,7 @@ private:
 
     void _run_io();
     void _run_uarts();
+    void _setup_uart_poller();
     bool _register_timesliced_proc(AP_HAL::MemberProc, uint8_t);
 
     uint64_t _stopped_clock_usec;
@@ -114,6 +124,12 @@ private:
 
     Semaphore _timer_semaphore;
     Semaphore _io_semaphore;
+
+    /* the uart thread sleeps on this poller until there's I/O to be done */
+    Poller _uart_poller;
+    EventPollable _uart_wakeup{FUNCTOR_BIND_MEMBER(&Scheduler::_run_uarts, void)};
+    /* when _run_uarts() last serviced all the UARTs */
+    uint32_t _last_uart_run_ms = 0;
 };
 
 }
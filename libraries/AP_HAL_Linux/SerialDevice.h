@@ -15,6 +15,14 @@ public:
     virtual ssize_t read(uint8_t *buf, uint16_t n) = 0;
     virtual void set_blocking(bool blocking) = 0;
     virtual void set_speed(uint32_t speed) = 0;
+
+    /*
+     * File descriptor that becomes readable when there's something to read
+     * from the device, to be waited on with a Poller. It may change after
+     * read() and close(). Returns -1 if the device can't be waited on.
+     */
+    virtual int get_fd() const { return -1; }
+
     virtual AP_HAL::UARTDriver::flow_control get_flow_control(void) { return AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE; }
     virtual void set_flow_control(AP_HAL::UARTDriver::flow_control flow_control_setting)
     {
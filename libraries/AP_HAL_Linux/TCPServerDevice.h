@@ -15,6 +15,15 @@ public:
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
 
+    /*
+     * While there's no client the listening socket is returned: it becomes
+     * readable on a new connection, which is then accepted by read().
+     */
+    virtual int get_fd() const override
+    {
+        return sock != NULL ? sock->get_fd() : listener.get_fd();
+    }
+
 private:
     SocketAPM listener{false};
     SocketAPM *sock = NULL;
@@ -43,6 +43,16 @@ UARTDriver::UARTDriver(bool default_console) :
     }
 }
 
+void UARTPollable::on_can_read()
+{
+    _uart._timer_tick();
+}
+
+void UARTPollable::on_can_write()
+{
+    _uart._timer_tick();
+}
+
 /*
   set the tty device to use for this UART
  */
@@ -51,6 +61,12 @@ void UARTDriver::set_device_path(const char *path)
     device_path = path;
 }
 
+void UARTDriver::set_poller(Poller *poller, EventPollable *wakeup)
+{
+    _poller = poller;
+    _wakeup = wakeup;
+}
+
 /*
   open the tty
  */
@@ -250,6 +266,14 @@ void UARTDriver::end()
         hal.scheduler->delay(1);
     }
 
+    if (_poller != nullptr && _pollable_sem.take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        if (_pollable.get_fd() >= 0) {
+            _poller->unregister_pollable(&_pollable);
+            _pollable.set_fd(-1);
+        }
+        _pollable_sem.give();
+    }
+
     _device->close();
     _deallocate_buffers();
 }
@@ -325,6 +349,45 @@ int16_t UARTDriver::read()
     return c;
 }
 
+uint32_t UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    uint32_t ret = 0;
+
+    // at most two runs, before and after the end of the ring
+    while (ret < count) {
+        uint32_t n = count - ret;
+        const uint8_t *data = peek_span(n);
+        if (data == nullptr) {
+            break;
+        }
+        memcpy(&buffer[ret], data, n);
+        consume(n);
+        ret += n;
+    }
+    return ret;
+}
+
+const uint8_t *UARTDriver::peek_span(uint32_t &count)
+{
+    if (!_initialised || _readbuf == NULL) {
+        count = 0;
+        return nullptr;
+    }
+    uint16_t head = _readbuf_head;
+    uint16_t tail = _readbuf_tail;
+    uint32_t n = (tail >= head) ? tail - head : _readbuf_size - head;
+    count = MIN(count, n);
+    return count > 0 ? &_readbuf[head] : nullptr;
+}
+
+void UARTDriver::consume(uint32_t count)
+{
+    if (!_initialised || _readbuf == NULL) {
+        return;
+    }
+    BUF_ADVANCEHEAD(_readbuf, count);
+}
+
 /* Linux implementations of Print virtual methods */
 size_t UARTDriver::write(uint8_t c)
 {
@@ -339,8 +402,12 @@ size_t UARTDriver::write(uint8_t c)
         }
         hal.scheduler->delay(1);
     }
+    const bool was_empty = BUF_EMPTY(_writebuf);
     _writebuf[_writebuf_tail] = c;
     BUF_ADVANCETAIL(_writebuf, 1);
+    if (was_empty && _wakeup != nullptr) {
+        _wakeup->signal();
+    }
     return 1;
 }
 
@@ -372,11 +439,15 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     if (size > space) {
         size = space;
     }
+    const bool was_empty = BUF_EMPTY(_writebuf);
     if (_writebuf_tail < _head) {
         // perform as single memcpy
         assert(_writebuf_tail+size <= _writebuf_size);
         memcpy(&_writebuf[_writebuf_tail], buffer, size);
         BUF_ADVANCETAIL(_writebuf, size);
+        if (was_empty && _wakeup != nullptr) {
+            _wakeup->signal();
+        }
         return size;
     }
 
@@ -393,6 +464,9 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
         memcpy(&_writebuf[_writebuf_tail], buffer, n);
         BUF_ADVANCETAIL(_writebuf, n);
     }
+    if (was_empty && _wakeup != nullptr) {
+        _wakeup->signal();
+    }
     return size;
 }
 
@@ -535,14 +609,13 @@ bool UARTDriver::_write_pending_bytes(void)
 }
 
 /*
-  push any pending bytes to/from the serial port. This is called at
-  1kHz in the timer thread. Doing it this way reduces the system call
-  overhead in the main task enormously.
+  push any pending bytes to/from the serial port. This is called from
+  the uart thread, either periodically or when the device is ready for
+  I/O if it's registered with a poller. Doing it this way reduces the
+  system call overhead in the main task enormously.
  */
 void UARTDriver::_timer_tick(void)
 {
-    uint16_t n;
-
     if (!_initialised) return;
 
     _in_timer = true;
@@ -552,24 +625,68 @@ void UARTDriver::_timer_tick(void)
         num_send--;
     }
 
-    // try to fill the read buffer
+    _fill_read_buffer();
+
+    _update_pollable();
+
+    _in_timer = false;
+}
+
+/*
+  try to fill the read buffer. When the device is registered with a poller
+  we are only notified again on new data (edge-triggered), so keep reading
+  until the device is drained or the buffer is full
+ */
+void UARTDriver::_fill_read_buffer()
+{
+    const bool drain = _pollable.get_fd() >= 0;
     uint16_t _head;
-    n = BUF_SPACE(_readbuf);
-    if (n > 0) {
+    uint16_t n;
+
+    while ((n = BUF_SPACE(_readbuf)) > 0) {
         uint16_t n1 = _readbuf_size - _readbuf_tail;
+        int ret;
         if (n1 >= n) {
             // one read will do
             assert(_readbuf_tail+n <= _readbuf_size);
-            _read_fd(&_readbuf[_readbuf_tail], n);
+            ret = _read_fd(&_readbuf[_readbuf_tail], n);
+            n1 = n;
         } else {
             assert(_readbuf_tail+n1 <= _readbuf_size);
-            int ret = _read_fd(&_readbuf[_readbuf_tail], n1);
+            ret = _read_fd(&_readbuf[_readbuf_tail], n1);
             if (ret == n1 && n > n1) {
                 assert(_readbuf_tail+(n-n1) <= _readbuf_size);
-                _read_fd(&_readbuf[_readbuf_tail], n - n1);
+                ret = _read_fd(&_readbuf[_readbuf_tail], n - n1);
+                n1 = n - n1;
             }
         }
+        if (!drain || ret < n1) {
+            break;
+        }
     }
+}
 
-    _in_timer = false;
+/*
+  keep the poller registration in sync with the device's file
+  descriptor, which changes on (re)connection of network devices
+ */
+void UARTDriver::_update_pollable()
+{
+    if (_poller == nullptr || !_pollable_sem.take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return;
+    }
+
+    int fd = _connected ? _device->get_fd() : -1;
+    if (fd != _pollable.get_fd()) {
+        if (_pollable.get_fd() >= 0) {
+            _poller->unregister_pollable(&_pollable);
+        }
+        _pollable.set_fd(fd);
+        if (fd >= 0 && !_poller->register_pollable(&_pollable,
+                                                   EPOLLIN | EPOLLOUT | EPOLLET)) {
+            _pollable.set_fd(-1);
+        }
+    }
+
+    _pollable_sem.give();
 }
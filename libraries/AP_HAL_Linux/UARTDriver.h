@@ -3,10 +3,32 @@
 #include <AP_HAL/utility/OwnPtr.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
+#include "Semaphores.h"
 #include "SerialDevice.h"
 
 namespace Linux {
 
+class UARTDriver;
+
+/*
+ * Pollable for the file descriptor of a UARTDriver's SerialDevice. The file
+ * descriptor is owned by the device, so it's never closed here.
+ */
+class UARTPollable : public Pollable {
+public:
+    UARTPollable(UARTDriver &uart) : _uart(uart) { }
+    ~UARTPollable() { _fd = -1; }
+
+    void set_fd(int fd) { _fd = fd; }
+
+    void on_can_read() override;
+    void on_can_write() override;
+
+private:
+    UARTDriver &_uart;
+};
+
 class UARTDriver : public AP_HAL::UARTDriver {
 public:
     UARTDriver(bool default_console);
@@ -28,6 +50,9 @@ public:
     uint32_t available() override;
     uint32_t txspace() override;
     int16_t read() override;
+    uint32_t read(uint8_t *buffer, uint32_t count) override;
+    const uint8_t *peek_span(uint32_t &count) override;
+    void consume(uint32_t count) override;
 
     /* Linux implementations of Print virtual methods */
     size_t write(uint8_t c);
@@ -38,6 +63,14 @@ public:
     bool _write_pending_bytes(void);
     virtual void _timer_tick(void);
 
+    /*
+     * Service this UART from the thread polling @poller rather than only
+     * periodically: the device's file descriptor is registered for
+     * edge-triggered read and write readiness and @wakeup is signaled when
+     * new bytes are queued for transmission.
+     */
+    void set_poller(Poller *poller, EventPollable *wakeup);
+
     virtual enum flow_control get_flow_control(void) override
     {
         return _device->get_flow_control();
@@ -65,6 +98,16 @@ private:
     AP_HAL::OwnPtr<SerialDevice> _parseDevicePath(const char *arg);
     uint64_t _last_write_time;
 
+    void _update_pollable();
+    void _fill_read_buffer();
+
+    Poller *_poller = nullptr;
+    EventPollable *_wakeup = nullptr;
+    UARTPollable _pollable{*this};
+    // held while the poller registration is changed, which is done by
+    // the uart thread and by end()
+    Semaphore _pollable_sem;
+
 protected:
     const char *device_path;
     volatile bool _initialised;
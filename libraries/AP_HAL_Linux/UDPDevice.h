@@ -14,6 +14,7 @@ public:
     virtual void set_speed(uint32_t speed) override;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
+    virtual int get_fd() const override { return socket.get_fd(); }
 private:
     SocketAPM socket{true};
     const char *_ip;
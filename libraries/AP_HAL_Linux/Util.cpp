@@ -40,6 +40,8 @@ void Util::init(int argc, char * const *argv) {
 #else
     _heat = new Linux::Heat();
 #endif // #ifdef
+
+    Perf::get_instance()->init();
 }
 
 // set current IMU temperatue in degrees C
@@ -91,6 +91,11 @@ public:
         return Perf::get_instance()->count(perf);
     }
 
+    bool perf_get_stats(uint16_t idx, perf_counter_stats &stats) override
+    {
+        return Perf::get_instance()->get_stats(idx, stats);
+    }
+
     // create a new semaphore
     AP_HAL::Semaphore *new_semaphore(void) override { return new Semaphore; }
 
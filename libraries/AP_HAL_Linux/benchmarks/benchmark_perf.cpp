@@ -0,0 +1,37 @@
+#include <AP_gbenchmark.h>
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <AP_HAL_Linux/Util.h>
+
+static void BM_PerfBeginEnd(benchmark::State& state)
+{
+    Linux::Perf *perf = Linux::Perf::get_instance();
+    AP_HAL::Util::perf_counter_t pc =
+        perf->add(AP_HAL::Util::PC_ELAPSED, "bm_begin_end");
+
+    while (state.KeepRunning()) {
+        perf->begin(pc);
+        perf->end(pc);
+    }
+}
+
+BENCHMARK(BM_PerfBeginEnd)->ThreadRange(1, 4);
+
+static void BM_PerfCount(benchmark::State& state)
+{
+    Linux::Perf *perf = Linux::Perf::get_instance();
+    AP_HAL::Util::perf_counter_t pc =
+        perf->add(AP_HAL::Util::PC_COUNT, "bm_count");
+
+    while (state.KeepRunning()) {
+        perf->count(pc);
+    }
+}
+
+BENCHMARK(BM_PerfCount)->ThreadRange(1, 4);
+
+#endif
+
+BENCHMARK_MAIN()
@@ -0,0 +1,53 @@
+#include <AP_gbenchmark.h>
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX && \
+    CONFIG_HAL_BOARD_SUBTYPE != HAL_BOARD_SUBTYPE_LINUX_QFLIGHT
+
+#include <string.h>
+
+#include <AP_HAL_Linux/PWM_Sysfs.h>
+
+/*
+ * PWM_Sysfs_Base backed by /dev/null rather than sysfs attributes, so the
+ * per-update cost of the hot path can be measured on any machine. On a real
+ * board the kernel side of the write adds to these numbers.
+ */
+class PWM_Sysfs_Null : public Linux::PWM_Sysfs_Base {
+public:
+    PWM_Sysfs_Null()
+        : PWM_Sysfs_Base(strdup("/dev/null"), strdup("/dev/null"),
+                         strdup("/dev/null"), strdup("/dev/null"),
+                         strdup("/dev/null"), 0)
+    {
+    }
+};
+
+static void BM_PWMSysfsSetDutyCycle(benchmark::State& state)
+{
+    PWM_Sysfs_Null pwm;
+    uint32_t duty = 1000000;
+
+    while (state.KeepRunning()) {
+        pwm.set_duty_cycle(duty);
+        duty = duty == 1000000 ? 2000000 : 1000000;
+    }
+}
+
+BENCHMARK(BM_PWMSysfsSetDutyCycle);
+
+static void BM_PWMSysfsSetDutyCycleUnchanged(benchmark::State& state)
+{
+    PWM_Sysfs_Null pwm;
+
+    while (state.KeepRunning()) {
+        bool r = pwm.set_duty_cycle(1500000);
+        gbenchmark_escape(&r);
+    }
+}
+
+BENCHMARK(BM_PWMSysfsSetDutyCycleUnchanged);
+
+#endif
+
+BENCHMARK_MAIN()
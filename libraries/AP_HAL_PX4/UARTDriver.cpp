@@ -283,6 +283,60 @@ int16_t PX4UARTDriver::read()
 	return c;
 }
 
+/*
+   read a block of bytes from the buffer
+ */
+uint32_t PX4UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    uint32_t ret = 0;
+
+    // at most two runs, before and after the end of the ring
+    while (ret < count) {
+        uint32_t n = count - ret;
+        const uint8_t *data = peek_span(n);
+        if (data == nullptr) {
+            break;
+        }
+        memcpy(&buffer[ret], data, n);
+        consume(n);
+        ret += n;
+    }
+    return ret;
+}
+
+/*
+   return the next contiguous run of received bytes without consuming them
+ */
+const uint8_t *PX4UARTDriver::peek_span(uint32_t &count)
+{
+    if (_uart_owner_pid != getpid()) {
+        count = 0;
+        return nullptr;
+    }
+    if (!_initialised) {
+        try_initialise();
+        count = 0;
+        return nullptr;
+    }
+    if (_readbuf == NULL) {
+        count = 0;
+        return nullptr;
+    }
+    uint16_t head = _readbuf_head;
+    uint16_t tail = _readbuf_tail;
+    uint32_t n = (tail >= head) ? tail - head : _readbuf_size - head;
+    count = MIN(count, n);
+    return count > 0 ? &_readbuf[head] : nullptr;
+}
+
+void PX4UARTDriver::consume(uint32_t count)
+{
+    if (!_initialised || _readbuf == NULL) {
+        return;
+    }
+    BUF_ADVANCEHEAD(_readbuf, count);
+}
+
 /* 
    write one byte to the buffer
  */
@@ -12,6 +12,7 @@ class ADCSource;
 class RCInput;
 class Util;
 class Semaphore;
+class Perf;
 class GPIO;
 class DigitalSource;
 }
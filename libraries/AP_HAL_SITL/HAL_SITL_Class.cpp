@@ -5,6 +5,11 @@
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 
 #include <assert.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "AP_HAL_SITL.h"
 #include "AP_HAL_SITL_Namespace.h"
@@ -18,6 +23,7 @@
 #include "GPIO.h"
 #include "SITL_State.h"
 #include "Util.h"
+#include "Perf.h"
 
 #include <AP_HAL_Empty/AP_HAL_Empty.h>
 #include <AP_HAL_Empty/AP_HAL_Empty_Private.h>
@@ -46,6 +52,88 @@ static UARTDriver sitlUart5Driver(5, &sitlState);
 
 static Util utilInstance(&sitlState);
 
+static volatile sig_atomic_t exit_requested;
+
+static void _sig_exit(int signum)
+{
+    // a second signal terminates immediately, e.g. if the loop is stuck
+    if (exit_requested) {
+        _exit(1);
+    }
+    exit_requested = 1;
+}
+
+// print the perf counters however the process ends, except on crashes
+static void _perf_report_at_exit(void)
+{
+    fprintf(stderr, "Perf counters:\n");
+    utilInstance.perf_report(stderr);
+}
+
+/*
+ * With --benchmark the main loop runs a fixed number of times and the CPU
+ * time of each iteration, less the time spent stepping the simulation, is
+ * collected so runs of the same vehicle can be compared.
+ */
+static struct {
+    Perf::histogram loop_cpu;
+    uint64_t sim_cpu;
+    uint64_t wall_start;
+    uint64_t wall_end;
+} benchmark;
+
+static void _benchmark_report_at_exit(void)
+{
+    const Perf::histogram &h = benchmark.loop_cpu;
+    if (h.count == 0) {
+        return;
+    }
+
+    const double wall_sec = (benchmark.wall_end - benchmark.wall_start) * 1.0e-9;
+
+    fprintf(stderr, "Benchmark: %" PRIu64 " loops in %.3fs, simulation took %.3fs of CPU\n",
+            h.count, wall_sec, benchmark.sim_cpu * 1.0e-9);
+    fprintf(stderr, "loop CPU us: avg %.3f min %.3f p50 %.3f p99 %.3f p99.9 %.3f max %.3f\n",
+            h.total / (h.count * 1000.0),
+            h.min / 1000.0,
+            h.percentile(0.5f) / 1000.0,
+            h.percentile(0.99f) / 1000.0,
+            h.percentile(0.999f) / 1000.0,
+            h.max / 1000.0);
+    fprintf(stderr, "loop throughput: %.1f loops per CPU second\n",
+            h.count / (h.total * 1.0e-9));
+}
+
+static uint64_t wall_nsec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_nsec + (ts.tv_sec * 1000000000ULL);
+}
+
+static void _run_benchmark(AP_HAL::HAL::Callbacks *callbacks,
+                           SITL_State *sitl_state)
+{
+    const uint32_t loops = sitl_state->benchmark_loops();
+
+    benchmark.wall_start = wall_nsec();
+
+    for (uint32_t i = 0; i < loops && !exit_requested; i++) {
+        const uint64_t cpu_start = Perf::thread_cpu_nsec();
+        const uint64_t sim_start = sitl_state->sim_cpu_nsec();
+
+        callbacks->loop();
+
+        const uint64_t sim = sitl_state->sim_cpu_nsec() - sim_start;
+        const uint64_t cpu = Perf::thread_cpu_nsec() - cpu_start;
+
+        benchmark.loop_cpu.add(cpu > sim ? cpu - sim : 0);
+        benchmark.sim_cpu += sim;
+    }
+
+    benchmark.wall_end = wall_nsec();
+}
+
 HAL_SITL::HAL_SITL() :
     AP_HAL::HAL(
         &sitlUart0Driver,  /* uartA */
@@ -85,9 +173,29 @@ void HAL_SITL::run(int argc, char * const argv[], Callbacks* callbacks) const
     callbacks->setup();
     scheduler->system_initialized();
 
-    for (;;) {
-        callbacks->loop();
+    /*
+     * Leave the main loop on SIGINT/SIGTERM so the exit handlers run between
+     * two iterations of the vehicle code. The benchmark summary is printed
+     * after the per-task perf counters.
+     */
+    atexit(_benchmark_report_at_exit);
+    atexit(_perf_report_at_exit);
+
+    struct sigaction sa_exit = {};
+    sigemptyset(&sa_exit.sa_mask);
+    sa_exit.sa_handler = _sig_exit;
+    sigaction(SIGINT, &sa_exit, nullptr);
+    sigaction(SIGTERM, &sa_exit, nullptr);
+
+    if (_sitl_state->benchmark_loops() != 0) {
+        _run_benchmark(callbacks, _sitl_state);
+    } else {
+        while (!exit_requested) {
+            callbacks->loop();
+        }
     }
+
+    exit(0);
 }
 
 const AP_HAL::HAL& AP_HAL::get_HAL() {
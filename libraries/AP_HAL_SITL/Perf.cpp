@@ -0,0 +1,193 @@
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+
+#include <AP_Math/AP_Math.h>
+
+#include "Perf.h"
+
+using namespace HALSITL;
+
+static inline uint64_t wall_nsec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_nsec + (ts.tv_sec * 1000000000ULL);
+}
+
+uint64_t Perf::thread_cpu_nsec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_nsec + (ts.tv_sec * 1000000000ULL);
+}
+
+void Perf::histogram::add(uint64_t elapsed)
+{
+    if (count == 0 || elapsed < min) {
+        min = elapsed;
+    }
+    if (elapsed > max) {
+        max = elapsed;
+    }
+    count++;
+    total += elapsed;
+    buckets[PerfHistogram::bucket(elapsed)]++;
+}
+
+uint64_t Perf::histogram::percentile(float fraction) const
+{
+    return PerfHistogram::percentile(buckets, count, fraction, max);
+}
+
+AP_HAL::Util::perf_counter_t Perf::add(AP_HAL::Util::perf_counter_type type,
+                                       const char *name)
+{
+    if (_num_counters >= SITL_PERF_MAX_COUNTERS ||
+        (type != AP_HAL::Util::PC_COUNT && type != AP_HAL::Util::PC_ELAPSED)) {
+        return nullptr;
+    }
+
+    struct counter &c = _counters[_num_counters++];
+    c.name = name;
+    c.type = type;
+    c.wall_min = UINT64_MAX;
+
+    /* handles are offset by one so nullptr is never a valid counter */
+    return (AP_HAL::Util::perf_counter_t)(uintptr_t)_num_counters;
+}
+
+struct Perf::counter *Perf::_get_counter(AP_HAL::Util::perf_counter_t pc,
+                                         AP_HAL::Util::perf_counter_type type)
+{
+    uintptr_t idx = (uintptr_t)pc;
+
+    if (idx == 0 || idx > _num_counters) {
+        return nullptr;
+    }
+
+    struct counter *c = &_counters[idx - 1];
+    if (c->type != type) {
+        return nullptr;
+    }
+
+    return c;
+}
+
+void Perf::begin(AP_HAL::Util::perf_counter_t pc)
+{
+    struct counter *c = _get_counter(pc, AP_HAL::Util::PC_ELAPSED);
+    if (c == nullptr) {
+        return;
+    }
+
+    c->started = true;
+    c->sim_start = AP_HAL::micros64();
+    c->cpu_start = thread_cpu_nsec();
+    c->wall_start = wall_nsec();
+}
+
+void Perf::end(AP_HAL::Util::perf_counter_t pc)
+{
+    uint64_t wall_now = wall_nsec();
+    uint64_t cpu_now = thread_cpu_nsec();
+
+    struct counter *c = _get_counter(pc, AP_HAL::Util::PC_ELAPSED);
+    if (c == nullptr || !c->started) {
+        return;
+    }
+
+    const uint64_t wall_elapsed = wall_now - c->wall_start;
+    const uint64_t sim_elapsed = AP_HAL::micros64() - c->sim_start;
+
+    c->started = false;
+    c->count++;
+
+    c->wall_total += wall_elapsed;
+    if (wall_elapsed < c->wall_min) {
+        c->wall_min = wall_elapsed;
+    }
+    if (wall_elapsed > c->wall_max) {
+        c->wall_max = wall_elapsed;
+    }
+
+    c->cpu.add(cpu_now - c->cpu_start);
+
+    c->sim_total += sim_elapsed;
+    if (sim_elapsed > c->sim_max) {
+        c->sim_max = sim_elapsed;
+    }
+}
+
+void Perf::count(AP_HAL::Util::perf_counter_t pc)
+{
+    struct counter *c = _get_counter(pc, AP_HAL::Util::PC_COUNT);
+    if (c == nullptr) {
+        return;
+    }
+
+    c->count++;
+}
+
+bool Perf::get_stats(uint16_t idx, AP_HAL::Util::perf_counter_stats &stats)
+{
+    if (idx >= _num_counters) {
+        return false;
+    }
+
+    const struct counter &c = _counters[idx];
+
+    stats.name = c.name;
+    stats.type = c.type;
+    stats.count = c.count;
+
+    if (c.type != AP_HAL::Util::PC_ELAPSED || c.count == 0) {
+        stats.min = stats.max = stats.avg = 0;
+        stats.p50 = stats.p99 = stats.p999 = 0;
+        return true;
+    }
+
+    stats.min = c.cpu.min;
+    stats.max = c.cpu.max;
+    stats.avg = c.cpu.total / c.count;
+    stats.p50 = c.cpu.percentile(0.5f);
+    stats.p99 = c.cpu.percentile(0.99f);
+    stats.p999 = c.cpu.percentile(0.999f);
+
+    return true;
+}
+
+void Perf::report(FILE *stream)
+{
+    fprintf(stream, "%-30s %10s %12s %12s %12s %12s %12s %12s %12s %12s %12s\n",
+            "counter", "count", "wall_avg_us", "wall_min_us", "wall_max_us",
+            "cpu_avg_us", "cpu_p50_us", "cpu_p99_us", "cpu_max_us",
+            "sim_avg_us", "sim_max_us");
+
+    for (uint16_t i = 0; i < _num_counters; i++) {
+        const struct counter &c = _counters[i];
+
+        if (c.type != AP_HAL::Util::PC_ELAPSED || c.count == 0) {
+            fprintf(stream, "%-30s %10" PRIu64 "\n", c.name, c.count);
+            continue;
+        }
+
+        fprintf(stream, "%-30s %10" PRIu64 " %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12" PRIu64 "\n",
+                c.name, c.count,
+                c.wall_total / (c.count * 1000.0),
+                c.wall_min / 1000.0,
+                c.wall_max / 1000.0,
+                c.cpu.total / (c.count * 1000.0),
+                c.cpu.percentile(0.5f) / 1000.0,
+                c.cpu.percentile(0.99f) / 1000.0,
+                c.cpu.max / 1000.0,
+                c.sim_total / (double)c.count,
+                c.sim_max);
+    }
+}
+
+#endif // CONFIG_HAL_BOARD
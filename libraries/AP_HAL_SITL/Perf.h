@@ -0,0 +1,87 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#include <stdio.h>
+
+#include <AP_HAL/utility/PerfHistogram.h>
+
+#include "AP_HAL_SITL_Namespace.h"
+
+#define SITL_PERF_MAX_COUNTERS 128
+
+/*
+ * Perf counters for SITL. Elapsed counters are measured with the wall clock,
+ * i.e. how long the host took to run the code, with the CPU time of the
+ * calling thread, which doesn't depend on what else the host is doing, and
+ * with the simulated clock, i.e. how long the vehicle code saw it taking.
+ *
+ * The class doesn't need a constructor so it can be used by other static
+ * objects while the HAL itself is still being constructed.
+ */
+class HALSITL::Perf {
+public:
+    /*
+     * distribution of durations in nanoseconds; a zeroed histogram is
+     * empty
+     */
+    struct histogram {
+        void add(uint64_t elapsed);
+        uint64_t percentile(float fraction) const;
+
+        uint64_t count;
+        uint64_t total;
+        uint64_t min;
+        uint64_t max;
+        uint32_t buckets[AP_PERF_HISTOGRAM_BUCKETS];
+    };
+
+    /* CPU time used so far by the calling thread, in nanoseconds */
+    static uint64_t thread_cpu_nsec();
+
+    AP_HAL::Util::perf_counter_t add(AP_HAL::Util::perf_counter_type type,
+                                     const char *name);
+
+    void begin(AP_HAL::Util::perf_counter_t pc);
+    void end(AP_HAL::Util::perf_counter_t pc);
+    void count(AP_HAL::Util::perf_counter_t pc);
+
+    /* stats use the thread CPU times, in nanoseconds */
+    bool get_stats(uint16_t idx, AP_HAL::Util::perf_counter_stats &stats);
+
+    /* print a table with all the counters */
+    void report(FILE *stream);
+
+private:
+    struct counter {
+        const char *name;
+        AP_HAL::Util::perf_counter_type type;
+        uint64_t count;
+
+        /* wall clock, in nanoseconds */
+        uint64_t wall_start;
+        uint64_t wall_total;
+        uint64_t wall_min;
+        uint64_t wall_max;
+
+        /* thread CPU time */
+        uint64_t cpu_start;
+        struct histogram cpu;
+
+        /* simulated clock, in microseconds */
+        uint64_t sim_start;
+        uint64_t sim_total;
+        uint64_t sim_max;
+
+        bool started;
+    };
+
+    struct counter *_get_counter(AP_HAL::Util::perf_counter_t pc,
+                                 AP_HAL::Util::perf_counter_type type);
+
+    struct counter _counters[SITL_PERF_MAX_COUNTERS];
+    uint16_t _num_counters;
+};
+
+#endif // CONFIG_HAL_BOARD
@@ -9,6 +9,7 @@
 #include "HAL_SITL_Class.h"
 #include "UARTDriver.h"
 #include "Scheduler.h"
+#include "Perf.h"
 
 #include <stdio.h>
 #include <signal.h>
@@ -188,11 +189,22 @@ void SITL_State::_fdm_input_step(void)
 }
 
 
+/*
+  in benchmark mode the CPU time of the simulation steps is accounted
+  separately. This includes the timer callbacks, which real boards run in
+  their own thread rather than in the main loop
+ */
 void SITL_State::wait_clock(uint64_t wait_time_usec)
 {
+    const uint64_t cpu_start = _benchmark_loops ? Perf::thread_cpu_nsec() : 0;
+
     while (AP_HAL::micros64() < wait_time_usec) {
         _fdm_input_step();
     }
+
+    if (_benchmark_loops) {
+        _sim_cpu_nsec += Perf::thread_cpu_nsec() - cpu_start;
+    }
 }
 
 #ifndef HIL_MODE
@@ -269,8 +281,10 @@ void SITL_State::_fdm_input_local(void)
 {
     SITL::Aircraft::sitl_input input;
 
-    // check for direct RC input
-    _fdm_input();
+    // check for direct RC input, which benchmarks keep fixed
+    if (_benchmark_loops == 0) {
+        _fdm_input();
+    }
 
     // construct servos structure for FDM
     _simulator_servos(input);
@@ -55,6 +55,17 @@ public:
     bool use_rtscts(void) const {
         return _use_rtscts;
     }
+
+    // number of main loops to run with --benchmark, 0 for a normal run
+    uint32_t benchmark_loops(void) const {
+        return _benchmark_loops;
+    }
+
+    // CPU time spent stepping the simulation in benchmark mode, which
+    // is not part of the vehicle's own cost
+    uint64_t sim_cpu_nsec(void) const {
+        return _sim_cpu_nsec;
+    }
     
     // simulated airspeed, sonar and battery monitor
     uint16_t sonar_pin_value;    // pin 0
@@ -171,6 +182,9 @@ private:
     bool _synthetic_clock_mode;
 
     bool _use_rtscts;
+
+    uint32_t _benchmark_loops;
+    uint64_t _sim_cpu_nsec;
     
     const char *_fdm_address;
 
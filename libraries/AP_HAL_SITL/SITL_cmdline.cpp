@@ -59,6 +59,8 @@ void SITL_State::_usage(void)
            "\t--uartD device     set device string for UARTD\n"
            "\t--uartE device     set device string for UARTE\n"
            "\t--defaults path    set path to defaults file\n"
+           "\t--benchmark LOOPS  run LOOPS main loops as fast as possible with fixed\n"
+           "\t                   inputs, then report the loop and task CPU times\n"
         );
 }
 
@@ -146,7 +148,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_UARTE,
         CMDLINE_UARTF,
         CMDLINE_RTSCTS,
-        CMDLINE_DEFAULTS
+        CMDLINE_DEFAULTS,
+        CMDLINE_BENCHMARK
     };
 
     const struct GetOptLong::option options[] = {
@@ -170,6 +173,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"autotest-dir",    true,   0, CMDLINE_AUTOTESTDIR},
         {"defaults",        true,   0, CMDLINE_DEFAULTS},
         {"rtscts",          false,  0, CMDLINE_RTSCTS},
+        {"benchmark",       true,   0, CMDLINE_BENCHMARK},
         {0, false, 0, 0}
     };
 
@@ -228,6 +232,9 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_DEFAULTS:
             defaults_path = strdup(gopt.optarg);
             break;
+        case CMDLINE_BENCHMARK:
+            _benchmark_loops = strtoul(gopt.optarg, NULL, 0);
+            break;
 
         case CMDLINE_UARTA:
         case CMDLINE_UARTB:
@@ -249,12 +256,27 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         exit(1);
     }
 
+    if (_benchmark_loops) {
+        // same noise on every run
+        srandom(1);
+        srand(1);
+        // don't wait for a GCS to connect
+        if (strcmp(_uart_path[0], "tcp:0:wait") == 0) {
+            _uart_path[0] = "tcp:0";
+        }
+        // get per-task perf counters from the scheduler
+        AP_Param::set_default_by_name("SCHED_DEBUG", 4);
+    }
+
     for (uint8_t i=0; i < ARRAY_SIZE(model_constructors); i++) {
         if (strncasecmp(model_constructors[i].name, model_str, strlen(model_constructors[i].name)) == 0) {
             sitl_model = model_constructors[i].constructor(home_str, model_str);
             sitl_model->set_speedup(speedup);
             sitl_model->set_instance(_instance);
             sitl_model->set_autotest_dir(autotest_dir);
+            if (_benchmark_loops) {
+                sitl_model->disable_time_sync();
+            }
             _synthetic_clock_mode = true;
             printf("Started model %s at %s at speed %.1f\n", model_str, home_str, speedup);
             break;
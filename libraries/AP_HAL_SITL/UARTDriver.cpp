@@ -132,6 +132,30 @@ int16_t UARTDriver::read(void)
     return c;
 }
 
+uint32_t UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    if (available() <= 0) {
+        return 0;
+    }
+    return _readbuffer.read(buffer, count);
+}
+
+const uint8_t *UARTDriver::peek_span(uint32_t &count)
+{
+    uint32_t n = 0;
+    const uint8_t *data = nullptr;
+    if (count > 0 && available() > 0) {
+        data = _readbuffer.readptr(n);
+    }
+    count = MIN(count, n);
+    return count > 0 ? data : nullptr;
+}
+
+void UARTDriver::consume(uint32_t count)
+{
+    _readbuffer.advance(count);
+}
+
 void UARTDriver::flush(void)
 {
 }
@@ -2,6 +2,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include "AP_HAL_SITL_Namespace.h"
+#include "Perf.h"
 #include "Semaphores.h"
 
 class HALSITL::Util : public AP_HAL::Util {
@@ -24,10 +25,24 @@ public:
     // create a new semaphore
     AP_HAL::Semaphore *new_semaphore(void) override { return new HALSITL::Semaphore; }
 
+    perf_counter_t perf_alloc(perf_counter_type t, const char *name) override {
+        return _perf.add(t, name);
+    }
+    void perf_begin(perf_counter_t h) override { _perf.begin(h); }
+    void perf_end(perf_counter_t h) override { _perf.end(h); }
+    void perf_count(perf_counter_t h) override { _perf.count(h); }
+    bool perf_get_stats(uint16_t idx, perf_counter_stats &stats) override {
+        return _perf.get_stats(idx, stats);
+    }
+
+    // print all perf counters
+    void perf_report(FILE *stream) { _perf.report(stream); }
+
     // get path to custom defaults file for AP_Param
     const char* get_custom_defaults_file() const override {
         return sitlState->defaults_path;
     }
 private:
     SITL_State *sitlState;
+    Perf _perf;
 };
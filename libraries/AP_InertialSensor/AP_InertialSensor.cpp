@@ -320,6 +320,15 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
     // @User: Advanced
     // @Values: 1:IMU 1,2:IMU 2,3:IMU 3
     AP_GROUPINFO("ACC_BODYFIX", 26, AP_InertialSensor, _acc_body_aligned, 2),
+
+    // @Group: NOTCH_
+    // @Path: ../Filter/NotchFilterParams.cpp
+    AP_SUBGROUPINFO(_notch_filter[0], "NOTCH_", 27, AP_InertialSensor, NotchFilterParams),
+
+    // @Group: NTCH2_
+    // @Path: ../Filter/NotchFilterParams.cpp
+    AP_SUBGROUPINFO(_notch_filter[1], "NTCH2_", 28, AP_InertialSensor, NotchFilterParams),
+
     /*
       NOTE: parameter indexes have gaps above. When adding new
       parameters check for conflicts carefully
@@ -346,7 +355,8 @@ AP_InertialSensor::AP_InertialSensor() :
     _dataflash(NULL),
     _accel_cal_requires_reboot(false),
     _startup_error_counts_set(false),
-    _startup_ms(0)
+    _startup_ms(0),
+    _correction_seq(0)
 {
     if (_s_instance) {
         AP_HAL::panic("Too many inertial sensors");
@@ -377,7 +387,15 @@ AP_InertialSensor::AP_InertialSensor() :
 
         _accel_startup_error_count[i] = 0;
         _gyro_startup_error_count[i] = 0;
+
+        for (uint8_t c=0; c<2; c++) {
+            _accel_correction[c][i].m.identity();
+            _accel_correction[c][i].offset.zero();
+            _gyro_correction[c][i].m.identity();
+            _gyro_correction[c][i].offset.zero();
+        }
     }
+    _correction_source.valid = false;
     for (uint8_t i=0; i<INS_VIBRATION_CHECK_INSTANCES; i++) {
         _accel_vibe_floor_filter[i].set_cutoff_frequency(AP_INERTIAL_SENSOR_ACCEL_VIBE_FLOOR_FILT_HZ);
         _accel_vibe_filter[i].set_cutoff_frequency(AP_INERTIAL_SENSOR_ACCEL_VIBE_FILT_HZ);
@@ -480,6 +498,7 @@ AP_InertialSensor::init(uint16_t sample_rate)
             _accel_scale[i].set(Vector3f(1,1,1));
         }
     }
+    _update_corrections();
 
     // calibrate gyros unless gyro calibration has been disabled
     if (gyro_calibration_timing() != GYRO_CAL_NEVER) {
@@ -930,6 +949,83 @@ void AP_InertialSensor::_save_parameters()
 /*
   update gyro and accel values from backends
  */
+/*
+  fold the accel offsets and scaling, gyro offsets and board rotation into
+  one transform per instance. Calibration is done in sensor frame, so the
+  offsets and scaling come before the rotation:
+
+    accel: R * S * (raw - offset)  =  (R * S) * raw - (R * S) * offset
+    gyro:  R * (raw - offset)      =  R * raw - R * offset
+ */
+void AP_InertialSensor::_update_corrections(void)
+{
+    if (_correction_source.valid && _correction_source.orientation == _board_orientation) {
+        bool changed = false;
+        for (uint8_t i=0; i<INS_MAX_INSTANCES && !changed; i++) {
+            changed = _correction_source.accel_scale[i] != _accel_scale[i].get() ||
+                      _correction_source.accel_offset[i] != _accel_offset[i].get() ||
+                      _correction_source.gyro_offset[i] != _gyro_offset[i].get();
+        }
+        if (!changed) {
+            return;
+        }
+    }
+
+    // columns of the board rotation are the rotated unit vectors
+    Vector3f ex(1, 0, 0), ey(0, 1, 0), ez(0, 0, 1);
+    ex.rotate(_board_orientation);
+    ey.rotate(_board_orientation);
+    ez.rotate(_board_orientation);
+    const Matrix3f rot(ex.x, ey.x, ez.x,
+                       ex.y, ey.y, ez.y,
+                       ex.z, ey.z, ez.z);
+
+    const uint32_t seq = _correction_seq.load(std::memory_order_relaxed);
+    const uint8_t next = (seq + 1) & 1;
+
+    // readers that loaded the sequence from before the last rebuild may
+    // still be copying the slot we are about to overwrite. Order the
+    // last sequence store before our writes, so they see it changed
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        const Vector3f &scale = _accel_scale[i].get();
+        const Matrix3f scaled_rot(rot.a.x * scale.x, rot.a.y * scale.y, rot.a.z * scale.z,
+                                  rot.b.x * scale.x, rot.b.y * scale.y, rot.b.z * scale.z,
+                                  rot.c.x * scale.x, rot.c.y * scale.y, rot.c.z * scale.z);
+        _accel_correction[next][i].m = scaled_rot;
+        _accel_correction[next][i].offset = -(scaled_rot * _accel_offset[i].get());
+
+        _gyro_correction[next][i].m = rot;
+        _gyro_correction[next][i].offset = -(rot * _gyro_offset[i].get());
+
+        _correction_source.accel_scale[i] = scale;
+        _correction_source.accel_offset[i] = _accel_offset[i].get();
+        _correction_source.gyro_offset[i] = _gyro_offset[i].get();
+    }
+    _correction_source.orientation = _board_orientation;
+    _correction_source.valid = true;
+
+    _correction_seq.store(seq + 1, std::memory_order_release);
+}
+
+/*
+  copy out the live correction of an instance. The main thread only
+  writes the slot that isn't live, so a copy can only mix two builds
+  if a rebuild was published while it was being made; it is retried
+  then. The reader never waits on a rebuild in progress
+ */
+void AP_InertialSensor::_copy_correction(const struct sensor_correction (&correction)[2][INS_MAX_INSTANCES],
+                                         const uint8_t instance, struct sensor_correction &c) const
+{
+    uint32_t seq;
+    do {
+        seq = _correction_seq.load(std::memory_order_acquire);
+        c = correction[seq & 1][instance];
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (seq != _correction_seq.load(std::memory_order_relaxed));
+}
+
 void AP_InertialSensor::update(void)
 {
     // during initialisation update() may be called without
@@ -937,6 +1033,9 @@ void AP_InertialSensor::update(void)
     wait_for_sample();
 
     if (!_hil_mode) {
+        // pick up calibration, parameter and orientation changes
+        _update_corrections();
+
         for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
             // mark sensors unhealthy and let update() in each backend
             // mark them healthy via _publish_gyro() and
@@ -950,13 +1049,8 @@ void AP_InertialSensor::update(void)
             _backends[i]->update();
         }
 
-        // clear accumulators
-        for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
-            _delta_velocity_acc[i].zero();
-            _delta_velocity_acc_dt[i] = 0;
-            _delta_angle_acc[i].zero();
-            _delta_angle_acc_dt[i] = 0;
-        }
+        // accumulators are cleared by the backends as they publish, while
+        // holding the lock shared with their sampling threads
 
         if (!_startup_error_counts_set) {
             for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
@@ -16,13 +16,17 @@
 #define INS_MAX_INSTANCES 3
 #define INS_MAX_BACKENDS  6
 #define INS_VIBRATION_CHECK_INSTANCES 2
+#define INS_MAX_NOTCHES 2
 
+#include <atomic>
 #include <stdint.h>
 
 #include <AP_AccelCal/AP_AccelCal.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <Filter/LowPassFilter2p.h>
+#include <Filter/LowPassFilter2pBank.h>
+#include <Filter/NotchFilterParams.h>
 #include <Filter/LowPassFilter.h>
 
 class AP_InertialSensor_Backend;
@@ -181,6 +185,17 @@ public:
     uint8_t get_primary_accel(void) const { return _primary_accel; }
     uint8_t get_primary_gyro(void) const { return _primary_gyro; }
 
+    // return the raw sample rate of a gyro in Hz
+    uint16_t get_gyro_raw_sample_rate(uint8_t instance) const { return _gyro_raw_sample_rates[instance]; }
+
+    /*
+      register a function to be called with each new filtered, corrected
+      sample (or block of samples) from the primary gyro. It is called
+      from the sensor thread, so must not block
+     */
+    FUNCTOR_TYPEDEF(GyroSampleCb, void, const Vector3f &);
+    void register_gyro_sample_cb(GyroSampleCb cb) { _gyro_sample_cb = cb; }
+
     // enable HIL mode
     void set_hil_mode(void) { _hil_mode = true; }
 
@@ -293,8 +308,10 @@ private:
     float _delta_velocity_acc_dt[INS_MAX_INSTANCES];
 
     // Low Pass filters for gyro and accel
-    LowPassFilter2pVector3f _accel_filter[INS_MAX_INSTANCES];
-    LowPassFilter2pVector3f _gyro_filter[INS_MAX_INSTANCES];
+    LowPassFilter2pVector3fBank<INS_MAX_INSTANCES> _accel_filter;
+    LowPassFilter2pVector3fBank<INS_MAX_INSTANCES> _gyro_filter;
+    // notch stages applied to the gyro samples ahead of the low pass
+    CascadedBiquadFilter<Vector3f, INS_MAX_NOTCHES> _gyro_notch[INS_MAX_INSTANCES];
     Vector3f _accel_filtered[INS_MAX_INSTANCES];
     Vector3f _gyro_filtered[INS_MAX_INSTANCES];
     bool _new_accel_data[INS_MAX_INSTANCES];
@@ -334,12 +351,49 @@ private:
     AP_Int8     _gyro_filter_cutoff;
     AP_Int8     _gyro_cal_timing;
 
+    // gyro notch filter settings
+    NotchFilterParams _notch_filter[INS_MAX_NOTCHES];
+
     // use for attitude, velocity, position estimates
     AP_Int8     _use[INS_MAX_INSTANCES];
 
     // board orientation from AHRS
     enum Rotation _board_orientation;
 
+    /*
+      offsets, scaling and board rotation folded into a single transform
+      per instance, applied to every raw sample by the backends:
+      corrected = m * raw + offset
+     */
+    struct sensor_correction {
+        Matrix3f m;
+        Vector3f offset;
+    };
+
+    // two copies so the sampling threads can keep reading one while the
+    // main thread rebuilds the other. The low bit of _correction_seq
+    // selects the live one, and it is bumped on each rebuild so readers
+    // can tell a copy overlapped a second rebuild
+    struct sensor_correction _accel_correction[2][INS_MAX_INSTANCES];
+    struct sensor_correction _gyro_correction[2][INS_MAX_INSTANCES];
+    std::atomic<uint32_t> _correction_seq;
+
+    // copy out the live correction of an instance, from any thread
+    void _copy_correction(const struct sensor_correction (&correction)[2][INS_MAX_INSTANCES],
+                          uint8_t instance, struct sensor_correction &c) const;
+
+    // the values the live corrections were built from
+    struct {
+        Vector3f accel_scale[INS_MAX_INSTANCES];
+        Vector3f accel_offset[INS_MAX_INSTANCES];
+        Vector3f gyro_offset[INS_MAX_INSTANCES];
+        enum Rotation orientation;
+        bool valid;
+    } _correction_source;
+
+    // rebuild the corrections if any of their inputs have changed
+    void _update_corrections(void);
+
     // calibrated_ok flags
     bool _gyro_cal_ok[INS_MAX_INSTANCES];
 
@@ -347,6 +401,9 @@ private:
     uint8_t _primary_gyro;
     uint8_t _primary_accel;
 
+    // called with each new filtered primary gyro sample
+    GyroSampleCb _gyro_sample_cb;
+
     // has wait_for_sample() found a sample?
     bool _have_sample:1;
 
@@ -11,34 +11,33 @@ const extern AP_HAL::HAL& hal;
 AP_InertialSensor_Backend::AP_InertialSensor_Backend(AP_InertialSensor &imu) :
     _imu(imu),
     _product_id(AP_PRODUCT_ID_NONE)
-{}
+{
+    _sem = hal.util->new_semaphore();
+    if (_sem == nullptr) {
+        AP_HAL::panic("AP_InertialSensor_Backend: failed to create semaphore");
+    }
+    memset(_last_notch, 0, sizeof(_last_notch));
+}
 
 void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vector3f &accel) 
 {
     /*
       accel calibration is always done in sensor frame with this
       version of the code. That means we apply the rotation after the
-      offsets and scaling.
+      offsets and scaling. All three are folded into one transform by
+      AP_InertialSensor::_update_corrections()
      */
-
-    // apply offsets
-    accel -= _imu._accel_offset[instance];
-
-    // apply scaling
-    const Vector3f &accel_scale = _imu._accel_scale[instance].get();
-    accel.x *= accel_scale.x;
-    accel.y *= accel_scale.y;
-    accel.z *= accel_scale.z;
-
-    // rotate to body frame
-    accel.rotate(_imu._board_orientation);
+    AP_InertialSensor::sensor_correction c;
+    _imu._copy_correction(_imu._accel_correction, instance, c);
+    accel = c.m * accel + c.offset;
 }
 
 void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro) 
 {
     // gyro calibration is always assumed to have been done in sensor frame
-    gyro -= _imu._gyro_offset[instance];
-    gyro.rotate(_imu._board_orientation);
+    AP_InertialSensor::sensor_correction c;
+    _imu._copy_correction(_imu._gyro_correction, instance, c);
+    gyro = c.m * gyro + c.offset;
 }
 
 /*
@@ -57,66 +56,109 @@ void AP_InertialSensor_Backend::_publish_gyro(uint8_t instance, const Vector3f &
     _imu._delta_angle[instance] = _imu._delta_angle_acc[instance];
     _imu._delta_angle_dt[instance] = _imu._delta_angle_acc_dt[instance];
     _imu._delta_angle_valid[instance] = true;
+
+    // start a new integration period
+    _imu._delta_angle_acc[instance].zero();
+    _imu._delta_angle_acc_dt[instance] = 0;
 }
 
 void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
                                                             const Vector3f &gyro,
                                                             uint64_t sample_us)
+{
+    _notify_new_gyro_raw_samples(instance, &gyro, 1, sample_us);
+}
+
+/*
+  integrate and filter a block of consecutive gyro samples, taking the
+  frontend lock only once for the whole block
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance,
+                                                             const Vector3f *gyro,
+                                                             uint8_t n_samples,
+                                                             uint64_t sample_us)
 {
     float dt;
 
-    if (_imu._gyro_raw_sample_rates[instance] <= 0) {
+    if (_imu._gyro_raw_sample_rates[instance] <= 0 || n_samples == 0) {
         return;
     }
 
     dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
 
-    // call gyro_sample hook if any
-    AP_Module::call_hook_gyro_sample(instance, dt, gyro);
-    
-    // compute delta angle
-    Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * dt;
-
-    // compute coning correction
-    // see page 26 of:
-    // Tian et al (2010) Three-loop Integration of GPS and Strapdown INS with Coning and Sculling Compensation
-    // Available: http://www.sage.unsw.edu.au/snap/publications/tian_etal2010b.pdf
-    // see also examples/coning.py
-    Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
-                             _imu._last_delta_angle[instance] * (1.0f / 6.0f));
-    delta_coning = delta_coning % delta_angle;
-    delta_coning *= 0.5f;
-
-    // integrate delta angle accumulator
-    // the angles and coning corrections are accumulated separately in the
-    // referenced paper, but in simulation little difference was found between
-    // integrating together and integrating separately (see examples/coning.py)
-    _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
-    _imu._delta_angle_acc_dt[instance] += dt;
-
-    // save previous delta angle for coning correction
-    _imu._last_delta_angle[instance] = delta_angle;
-    _imu._last_raw_gyro[instance] = gyro;
-
-    _imu._gyro_filtered[instance] = _imu._gyro_filter[instance].apply(gyro);
-    if (_imu._gyro_filtered[instance].is_nan() || _imu._gyro_filtered[instance].is_inf()) {
-        _imu._gyro_filter[instance].reset();
+    _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
+
+    Vector3f delta_angle_acc = _imu._delta_angle_acc[instance];
+    Vector3f last_delta_angle = _imu._last_delta_angle[instance];
+    Vector3f last_raw_gyro = _imu._last_raw_gyro[instance];
+    Vector3f gyro_filtered;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        // call gyro_sample hook if any
+        AP_Module::call_hook_gyro_sample(instance, dt, gyro[i]);
+
+        // compute delta angle
+        Vector3f delta_angle = (gyro[i] + last_raw_gyro) * 0.5f * dt;
+
+        // compute coning correction
+        // see page 26 of:
+        // Tian et al (2010) Three-loop Integration of GPS and Strapdown INS with Coning and Sculling Compensation
+        // Available: http://www.sage.unsw.edu.au/snap/publications/tian_etal2010b.pdf
+        // see also examples/coning.py
+        Vector3f delta_coning = (delta_angle_acc +
+                                 last_delta_angle * (1.0f / 6.0f));
+        delta_coning = delta_coning % delta_angle;
+        delta_coning *= 0.5f;
+
+        // integrate delta angle accumulator
+        // the angles and coning corrections are accumulated separately in the
+        // referenced paper, but in simulation little difference was found between
+        // integrating together and integrating separately (see examples/coning.py)
+        delta_angle_acc += delta_angle + delta_coning;
+
+        // save previous delta angle for coning correction
+        last_delta_angle = delta_angle;
+        last_raw_gyro = gyro[i];
+
+        gyro_filtered = _imu._gyro_filter.apply(instance, _imu._gyro_notch[instance].apply(gyro[i]));
+    }
+
+    _imu._delta_angle_acc[instance] = delta_angle_acc;
+    _imu._delta_angle_acc_dt[instance] += dt * n_samples;
+    _imu._last_delta_angle[instance] = last_delta_angle;
+    _imu._last_raw_gyro[instance] = last_raw_gyro;
+
+    _imu._gyro_filtered[instance] = gyro_filtered;
+    if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
+        _imu._gyro_filter.reset(instance);
+        _imu._gyro_notch[instance].reset();
     }
 
     _imu._new_gyro_data[instance] = true;
 
+    _sem->give();
+
+    if (instance == _imu._primary_gyro && _imu._gyro_sample_cb) {
+        _imu._gyro_sample_cb(gyro_filtered);
+    }
+
     DataFlash_Class *dataflash = get_dataflash();
     if (dataflash != NULL) {
         uint64_t now = AP_HAL::micros64();
-        struct log_GYRO pkt = {
-            LOG_PACKET_HEADER_INIT((uint8_t)(LOG_GYR1_MSG+instance)),
-            time_us   : now,
-            sample_us : sample_us?sample_us:now,
-            GyrX      : gyro.x,
-            GyrY      : gyro.y,
-            GyrZ      : gyro.z
-        };
-        dataflash->WriteBlock(&pkt, sizeof(pkt));
+        uint64_t last_sample_us = sample_us ? sample_us : now;
+        uint32_t dt_us = 1000000UL / _imu._gyro_raw_sample_rates[instance];
+
+        for (uint8_t i = 0; i < n_samples; i++) {
+            struct log_GYRO pkt = {
+                LOG_PACKET_HEADER_INIT((uint8_t)(LOG_GYR1_MSG+instance)),
+                time_us   : now,
+                sample_us : last_sample_us - (uint64_t)(n_samples - 1 - i) * dt_us,
+                GyrX      : gyro[i].x,
+                GyrY      : gyro[i].y,
+                GyrZ      : gyro[i].z
+            };
+            dataflash->WriteBlock(&pkt, sizeof(pkt));
+        }
     }
 }
 
@@ -137,6 +179,9 @@ void AP_InertialSensor_Backend::_publish_accel(uint8_t instance, const Vector3f
     _imu._delta_velocity_dt[instance] = _imu._delta_velocity_acc_dt[instance];
     _imu._delta_velocity_valid[instance] = true;
 
+    // start a new integration period
+    _imu._delta_velocity_acc[instance].zero();
+    _imu._delta_velocity_acc_dt[instance] = 0;
 
     if (_imu._accel_calibrator != NULL && _imu._accel_calibrator[instance].get_status() == ACCEL_CAL_COLLECTING_SAMPLE) {
         Vector3f cal_sample = _imu._delta_velocity[instance];
@@ -161,45 +206,76 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
                                                              const Vector3f &accel,
                                                              uint64_t sample_us,
                                                              bool fsync_set)
+{
+    _notify_new_accel_raw_samples(instance, &accel, 1, sample_us, &fsync_set);
+}
+
+/*
+  integrate and filter a block of consecutive accel samples, taking the
+  frontend lock only once for the whole block
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance,
+                                                              const Vector3f *accel,
+                                                              uint8_t n_samples,
+                                                              uint64_t sample_us,
+                                                              const bool *fsync_set)
 {
     float dt;
 
-    if (_imu._accel_raw_sample_rates[instance] <= 0) {
+    if (_imu._accel_raw_sample_rates[instance] <= 0 || n_samples == 0) {
         return;
     }
 
     dt = 1.0f / _imu._accel_raw_sample_rates[instance];
 
-    // call gyro_sample hook if any
-    AP_Module::call_hook_accel_sample(instance, dt, accel, fsync_set);
-    
-    _imu.calc_vibration_and_clipping(instance, accel, dt);
+    _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
+
+    Vector3f delta_velocity_acc = _imu._delta_velocity_acc[instance];
+    Vector3f accel_filtered;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        // call gyro_sample hook if any
+        AP_Module::call_hook_accel_sample(instance, dt, accel[i],
+                                          fsync_set != nullptr && fsync_set[i]);
 
-    // delta velocity
-    _imu._delta_velocity_acc[instance] += accel * dt;
-    _imu._delta_velocity_acc_dt[instance] += dt;
+        _imu.calc_vibration_and_clipping(instance, accel[i], dt);
 
-    _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
-    if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
-        _imu._accel_filter[instance].reset();
+        // delta velocity
+        delta_velocity_acc += accel[i] * dt;
+
+        accel_filtered = _imu._accel_filter.apply(instance, accel[i]);
+        _imu.set_accel_peak_hold(instance, accel_filtered);
     }
 
-    _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+    _imu._delta_velocity_acc[instance] = delta_velocity_acc;
+    _imu._delta_velocity_acc_dt[instance] += dt * n_samples;
+
+    _imu._accel_filtered[instance] = accel_filtered;
+    if (accel_filtered.is_nan() || accel_filtered.is_inf()) {
+        _imu._accel_filter.reset(instance);
+    }
 
     _imu._new_accel_data[instance] = true;
 
+    _sem->give();
+
     DataFlash_Class *dataflash = get_dataflash();
     if (dataflash != NULL) {
         uint64_t now = AP_HAL::micros64();
-        struct log_ACCEL pkt = {
-            LOG_PACKET_HEADER_INIT((uint8_t)(LOG_ACC1_MSG+instance)),
-            time_us   : now,
-            sample_us : sample_us?sample_us:now,
-            AccX      : accel.x,
-            AccY      : accel.y,
-            AccZ      : accel.z
-        };
-        dataflash->WriteBlock(&pkt, sizeof(pkt));
+        uint64_t last_sample_us = sample_us ? sample_us : now;
+        uint32_t dt_us = 1000000UL / _imu._accel_raw_sample_rates[instance];
+
+        for (uint8_t i = 0; i < n_samples; i++) {
+            struct log_ACCEL pkt = {
+                LOG_PACKET_HEADER_INIT((uint8_t)(LOG_ACC1_MSG+instance)),
+                time_us   : now,
+                sample_us : last_sample_us - (uint64_t)(n_samples - 1 - i) * dt_us,
+                AccX      : accel[i].x,
+                AccY      : accel[i].y,
+                AccZ      : accel[i].z
+            };
+            dataflash->WriteBlock(&pkt, sizeof(pkt));
+        }
     }
 }
 
@@ -246,7 +322,7 @@ void AP_InertialSensor_Backend::_publish_temperature(uint8_t instance, float tem
  */
 void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
 {    
-    hal.scheduler->suspend_timer_procs();
+    _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
 
     if (_imu._new_gyro_data[instance]) {
         _publish_gyro(instance, _imu._gyro_filtered[instance]);
@@ -255,11 +331,45 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
 
     // possibly update filter frequency
     if (_last_gyro_filter_hz[instance] != _gyro_filter_cutoff()) {
-        _imu._gyro_filter[instance].set_cutoff_frequency(_gyro_raw_sample_rate(instance), _gyro_filter_cutoff());
+        _imu._gyro_filter.set_cutoff_frequency(instance, _gyro_raw_sample_rate(instance), _gyro_filter_cutoff());
         _last_gyro_filter_hz[instance] = _gyro_filter_cutoff();
     }
 
-    hal.scheduler->resume_timer_procs();
+    // possibly update notch filters
+    for (uint8_t stage = 0; stage < INS_MAX_NOTCHES; stage++) {
+        _update_gyro_notch(instance, stage);
+    }
+
+    _sem->give();
+}
+
+/*
+  recompute the coefficients of a gyro notch stage when its parameters
+  change. Called with _sem held
+ */
+void AP_InertialSensor_Backend::_update_gyro_notch(uint8_t instance, uint8_t stage)
+{
+    const NotchFilterParams &params = _imu._notch_filter[stage];
+    struct notch_config &last = _last_notch[instance][stage];
+
+    if (last.enabled == params.enabled() &&
+        is_equal(last.center_freq_hz, params.center_freq_hz()) &&
+        is_equal(last.bandwidth_hz, params.bandwidth_hz()) &&
+        is_equal(last.attenuation_dB, params.attenuation_dB())) {
+        return;
+    }
+
+    last.enabled = params.enabled();
+    last.center_freq_hz = params.center_freq_hz();
+    last.bandwidth_hz = params.bandwidth_hz();
+    last.attenuation_dB = params.attenuation_dB();
+
+    BiquadCoefficients coefficients;
+    if (params.get_coefficients(_gyro_raw_sample_rate(instance), coefficients)) {
+        _imu._gyro_notch[instance].set_stage(stage, coefficients);
+    } else {
+        _imu._gyro_notch[instance].disable_stage(stage);
+    }
 }
 
 /*
@@ -267,7 +377,7 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
  */
 void AP_InertialSensor_Backend::update_accel(uint8_t instance)
 {    
-    hal.scheduler->suspend_timer_procs();
+    _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
 
     if (_imu._new_accel_data[instance]) {
         _publish_accel(instance, _imu._accel_filtered[instance]);
@@ -276,9 +386,9 @@ void AP_InertialSensor_Backend::update_accel(uint8_t instance)
     
     // possibly update filter frequency
     if (_last_accel_filter_hz[instance] != _accel_filter_cutoff()) {
-        _imu._accel_filter[instance].set_cutoff_frequency(_accel_raw_sample_rate(instance), _accel_filter_cutoff());
+        _imu._accel_filter.set_cutoff_frequency(instance, _accel_raw_sample_rate(instance), _accel_filter_cutoff());
         _last_accel_filter_hz[instance] = _accel_filter_cutoff();
     }
 
-    hal.scheduler->resume_timer_procs();
+    _sem->give();
 }
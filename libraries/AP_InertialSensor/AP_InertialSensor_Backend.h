@@ -88,6 +88,10 @@ protected:
     // be rotated and corrected (_rotate_and_correct_gyro)
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0);
 
+    // same as _notify_new_gyro_raw_sample() for a block of consecutive
+    // samples, e.g. read from a FIFO; sample_us is the time of the last one
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n_samples, uint64_t sample_us=0);
+
     // rotate accel vector, scale, offset and publish
     void _publish_accel(uint8_t instance, const Vector3f &accel);
 
@@ -97,6 +101,10 @@ protected:
     // be rotated and corrected (_rotate_and_correct_accel)
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false);
 
+    // same as _notify_new_accel_raw_sample() for a block of consecutive
+    // samples, e.g. read from a FIFO; sample_us is the time of the last one
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n_samples, uint64_t sample_us=0, const bool *fsync_set=nullptr);
+
     // set accelerometer max absolute offset for calibration
     void _set_accel_max_abs_offset(uint8_t instance, float offset);
 
@@ -145,10 +153,25 @@ protected:
     // common accel update function for all backends
     void update_accel(uint8_t instance);
 
+    // protects the frontend accumulators from concurrent access by the
+    // thread sampling the sensor and the thread publishing its data
+    AP_HAL::Semaphore *_sem;
+
     // support for updating filter at runtime
     int8_t _last_accel_filter_hz[INS_MAX_INSTANCES];
     int8_t _last_gyro_filter_hz[INS_MAX_INSTANCES];
 
+    // notch settings each gyro notch stage was last configured with
+    struct notch_config {
+        bool enabled;
+        float center_freq_hz;
+        float bandwidth_hz;
+        float attenuation_dB;
+    } _last_notch[INS_MAX_INSTANCES][INS_MAX_NOTCHES];
+
+    // reconfigure a gyro notch stage if its parameters have changed
+    void _update_gyro_notch(uint8_t instance, uint8_t stage);
+
     // note that each backend is also expected to have a static detect()
     // function which instantiates an instance of the backend sensor
     // driver if the sensor is available
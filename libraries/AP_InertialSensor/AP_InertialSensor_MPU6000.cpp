@@ -208,13 +208,14 @@ extern const AP_HAL::HAL& hal;
 
 #define MPU6000_SAMPLE_SIZE 14
 
-#if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BH
-#define MPU6000_MAX_FIFO_SAMPLES 6
-#else
-#define MPU6000_MAX_FIFO_SAMPLES 3
-#endif
+/* The whole FIFO is drained on each read */
+#define MPU6000_FIFO_SIZE 1024
+#define MPU6000_MAX_FIFO_SAMPLES (MPU6000_FIFO_SIZE / MPU6000_SAMPLE_SIZE)
 #define MAX_DATA_READ (MPU6000_MAX_FIFO_SAMPLES * MPU6000_SAMPLE_SIZE)
 
+/* Samples are converted and handed to the frontend in blocks of this size */
+#define MPU6000_NOTIFY_BATCH 8
+
 #define int16_val(v, idx) ((int16_t)(((uint16_t)v[2*idx] << 8) | v[2*idx+1]))
 #define uint16_val(v, idx)(((uint16_t)v[2*idx] << 8) | v[2*idx+1])
 
@@ -245,6 +246,7 @@ AP_InertialSensor_MPU6000::AP_InertialSensor_MPU6000(AP_InertialSensor &imu,
 AP_InertialSensor_MPU6000::~AP_InertialSensor_MPU6000()
 {
     delete _auxiliary_bus;
+    delete[] _fifo_buffer;
 }
 
 AP_InertialSensor_Backend *AP_InertialSensor_MPU6000::probe(AP_InertialSensor &imu,
@@ -333,6 +335,10 @@ void AP_InertialSensor_MPU6000::start()
     hal.scheduler->delay(1);
 
     if (_use_fifo) {
+        _fifo_buffer = new uint8_t[MAX_DATA_READ];
+        if (_fifo_buffer == nullptr) {
+            AP_HAL::panic("MPU6000: Unable to allocate FIFO buffer");
+        }
         _fifo_enable();
     }
 
@@ -389,6 +395,16 @@ void AP_InertialSensor_MPU6000::start()
 
     hal.scheduler->resume_timer_procs();
 
+    /*
+     * Prefer reading samples from the thread of the bus the sensor is
+     * attached to so it doesn't compete with the other sensors in the timer
+     * thread. Fallback to the timer process on HALs that don't provide it.
+     */
+    if (_dev->register_periodic_callback(1000,
+            FUNCTOR_BIND_MEMBER(&AP_InertialSensor_MPU6000::_poll_data_periodic, bool)) != nullptr) {
+        return;
+    }
+
     // start the timer process to read samples
     hal.scheduler->register_timer_process(
         FUNCTOR_BIND_MEMBER(&AP_InertialSensor_MPU6000::_poll_data, void));
@@ -444,72 +460,102 @@ void AP_InertialSensor_MPU6000::_poll_data()
         return;
     }
 
+    _poll_data_periodic();
+
+    _dev->get_semaphore()->give();
+}
+
+/*
+ * Periodic callback from the bus thread: the bus semaphore is already held.
+ */
+bool AP_InertialSensor_MPU6000::_poll_data_periodic()
+{
     if (_use_fifo) {
         _read_fifo();
     } else if (_data_ready()) {
         _read_sample();
     }
 
-    _dev->get_semaphore()->give();
+    return true;
 }
 
 void AP_InertialSensor_MPU6000::_accumulate(uint8_t *samples, uint8_t n_samples)
 {
+    const uint64_t now = AP_HAL::micros64();
+    const uint32_t rate_hz = _accel_raw_sample_rate(_accel_instance);
+    const uint32_t period_us = rate_hz > 0 ? 1000000UL / rate_hz : 0;
+
+    while (n_samples > 0) {
+        uint8_t n = MIN(n_samples, MPU6000_NOTIFY_BATCH);
+
+        // the last sample read is the newest; date each batch by the
+        // samples still queued behind it
+        _accumulate_batch(samples, n, now - (uint64_t)(n_samples - n) * period_us);
+
+        samples += n * MPU6000_SAMPLE_SIZE;
+        n_samples -= n;
+    }
+}
+
+void AP_InertialSensor_MPU6000::_accumulate_batch(uint8_t *samples, uint8_t n_samples,
+                                                  uint64_t sample_us)
+{
+    Vector3f accel[MPU6000_NOTIFY_BATCH];
+    Vector3f gyro[MPU6000_NOTIFY_BATCH];
+    bool fsync_set[MPU6000_NOTIFY_BATCH];
+
     for (uint8_t i = 0; i < n_samples; i++) {
         uint8_t *data = samples + MPU6000_SAMPLE_SIZE * i;
-        Vector3f accel, gyro;
         float temp;
-        bool fsync_set = false;
 
+        fsync_set[i] = false;
 #if MPU6000_EXT_SYNC_ENABLE
-        fsync_set = (int16_val(data, 2) & 1U) != 0;
+        fsync_set[i] = (int16_val(data, 2) & 1U) != 0;
 #endif
-        
-        accel = Vector3f(int16_val(data, 1),
-                         int16_val(data, 0),
-                         -int16_val(data, 2));
-        accel *= MPU6000_ACCEL_SCALE_1G;
 
-        gyro = Vector3f(int16_val(data, 5),
-                        int16_val(data, 4),
-                        -int16_val(data, 6));
-        gyro *= GYRO_SCALE;
+        accel[i] = Vector3f(int16_val(data, 1),
+                            int16_val(data, 0),
+                            -int16_val(data, 2));
+        accel[i] *= MPU6000_ACCEL_SCALE_1G;
+
+        gyro[i] = Vector3f(int16_val(data, 5),
+                           int16_val(data, 4),
+                           -int16_val(data, 6));
+        gyro[i] *= GYRO_SCALE;
 
         temp = int16_val(data, 3);
         /* scaling/offset values from the datasheet */
         temp = temp/340 + 36.53;
 
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_PXF
-        accel.rotate(ROTATION_PITCH_180_YAW_90);
-        gyro.rotate(ROTATION_PITCH_180_YAW_90);
+        accel[i].rotate(ROTATION_PITCH_180_YAW_90);
+        gyro[i].rotate(ROTATION_PITCH_180_YAW_90);
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
-        accel.rotate(ROTATION_YAW_270);
-        gyro.rotate(ROTATION_YAW_270);
+        accel[i].rotate(ROTATION_YAW_270);
+        gyro[i].rotate(ROTATION_YAW_270);
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_DISCO
-        accel.rotate(ROTATION_PITCH_180_YAW_90);
-        gyro.rotate(ROTATION_PITCH_180_YAW_90);
+        accel[i].rotate(ROTATION_PITCH_180_YAW_90);
+        gyro[i].rotate(ROTATION_PITCH_180_YAW_90);
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_MINLURE
-        accel.rotate(ROTATION_YAW_90);
-        gyro.rotate(ROTATION_YAW_90);
+        accel[i].rotate(ROTATION_YAW_90);
+        gyro[i].rotate(ROTATION_YAW_90);
 #endif
 
-        _rotate_and_correct_accel(_accel_instance, accel);
-        _rotate_and_correct_gyro(_gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(_accel_instance, accel, AP_HAL::micros64(), fsync_set);
-        _notify_new_gyro_raw_sample(_gyro_instance, gyro);
+        _rotate_and_correct_accel(_accel_instance, accel[i]);
+        _rotate_and_correct_gyro(_gyro_instance, gyro[i]);
 
         _temp_filtered = _temp_filter.apply(temp);
     }
+
+    _notify_new_accel_raw_samples(_accel_instance, accel, n_samples, sample_us, fsync_set);
+    _notify_new_gyro_raw_samples(_gyro_instance, gyro, n_samples, sample_us);
 }
 
 void AP_InertialSensor_MPU6000::_read_fifo()
 {
     uint8_t n_samples;
     uint16_t bytes_read;
-    uint8_t rx[MAX_DATA_READ];
-
-    static_assert(MAX_DATA_READ <= 100, "Too big to keep on stack");
+    uint8_t *rx = _fifo_buffer;
 
     if (!_block_read(MPUREG_FIFO_COUNTH, rx, 2)) {
         hal.console->printf("MPU60x0: error in fifo read\n");
@@ -517,22 +563,24 @@ void AP_InertialSensor_MPU6000::_read_fifo()
     }
 
     bytes_read = uint16_val(rx, 0);
-    n_samples = bytes_read / MPU6000_SAMPLE_SIZE;
 
-    if (n_samples == 0) {
-        /* Not enough data in FIFO */
+    if (bytes_read >= MPU6000_FIFO_SIZE) {
+        hal.console->printf("MPU60x0: FIFO overflow with %u bytes, dropping samples\n",
+                            bytes_read);
+
+        /* Samples are no longer aligned on the FIFO, do a FIFO RESET */
+        _fifo_reset();
         return;
     }
 
-    if (n_samples > MPU6000_MAX_FIFO_SAMPLES) {
-        hal.console->printf("bytes_read = %u, n_samples %u > %u, dropping samples\n",
-                            bytes_read, n_samples, MPU6000_MAX_FIFO_SAMPLES);
+    n_samples = bytes_read / MPU6000_SAMPLE_SIZE;
 
-        /* Too many samples, do a FIFO RESET */
-        _fifo_reset();
+    if (n_samples == 0) {
+        /* Not enough data in FIFO */
         return;
     }
 
+    /* Drain all the available samples in a single burst */
     if (!_block_read(MPUREG_FIFO_R_W, rx, n_samples * MPU6000_SAMPLE_SIZE)) {
         hal.console->printf("MPU60x0: error in fifo read %u bytes\n",
                             n_samples * MPU6000_SAMPLE_SIZE);
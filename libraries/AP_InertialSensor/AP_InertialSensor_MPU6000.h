@@ -80,6 +80,9 @@ private:
     /* Poll for new data (non-blocking) */
     void _poll_data();
 
+    /* Poll for new data with the bus semaphore already taken */
+    bool _poll_data_periodic();
+
     /* Read and write functions taking the differences between buses into
      * account */
     bool _block_read(uint8_t reg, uint8_t *buf, uint32_t size);
@@ -87,6 +90,7 @@ private:
     void _register_write(uint8_t reg, uint8_t val );
 
     void _accumulate(uint8_t *samples, uint8_t n_samples);
+    void _accumulate_batch(uint8_t *samples, uint8_t n_samples, uint64_t sample_us);
 
     // instance numbers of accel and gyro data
     uint8_t _gyro_instance;
@@ -101,6 +105,9 @@ private:
 
     AP_HAL::DigitalSource *_drdy_pin;
     AP_HAL::OwnPtr<AP_HAL::Device> _dev;
+
+    /* buffer to drain the whole FIFO at once, only allocated if it's used */
+    uint8_t *_fifo_buffer = nullptr;
     AP_MPU6000_AuxiliaryBus *_auxiliary_bus;
 };
 
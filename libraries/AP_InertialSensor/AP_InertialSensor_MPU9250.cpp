@@ -331,6 +331,16 @@ void AP_InertialSensor_MPU9250::start()
 
     hal.scheduler->resume_timer_procs();
 
+    /*
+     * Prefer reading samples from the thread of the bus the sensor is
+     * attached to so it doesn't compete with the other sensors in the timer
+     * thread. Fallback to the timer process on HALs that don't provide it.
+     */
+    if (_dev->register_periodic_callback(1000,
+            FUNCTOR_BIND_MEMBER(&AP_InertialSensor_MPU9250::_poll_data_periodic, bool)) != nullptr) {
+        return;
+    }
+
     // start the timer process to read samples
     hal.scheduler->register_timer_process(
         FUNCTOR_BIND_MEMBER(&AP_InertialSensor_MPU9250::_poll_data, void));
@@ -388,6 +398,15 @@ void AP_InertialSensor_MPU9250::_poll_data()
     _dev->get_semaphore()->give();
 }
 
+/*
+ * Periodic callback from the bus thread: the bus semaphore is already held.
+ */
+bool AP_InertialSensor_MPU9250::_poll_data_periodic()
+{
+    _read_sample();
+    return true;
+}
+
 void AP_InertialSensor_MPU9250::_accumulate(uint8_t *rx)
 {
     Vector3f accel, gyro;
@@ -653,6 +672,12 @@ AP_HAL::Semaphore *AP_MPU9250_AuxiliaryBus::get_semaphore()
     return AP_InertialSensor_MPU9250::from(_ins_backend)._dev->get_semaphore();
 }
 
+AP_HAL::Device::PeriodicHandle AP_MPU9250_AuxiliaryBus::register_periodic_callback(uint32_t period_usec,
+                                                                                   AP_HAL::Device::PeriodicCb cb)
+{
+    return AP_InertialSensor_MPU9250::from(_ins_backend)._dev->register_periodic_callback(period_usec, cb);
+}
+
 AuxiliaryBusSlave *AP_MPU9250_AuxiliaryBus::_instantiate_slave(uint8_t addr, uint8_t instance)
 {
     /* Enable slaves on MPU9250 if this is the first time */
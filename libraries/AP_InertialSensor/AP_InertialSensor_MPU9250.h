@@ -72,6 +72,9 @@ private:
     /* Poll for new data (non-blocking) */
     void _poll_data();
 
+    /* Poll for new data with the bus semaphore already taken */
+    bool _poll_data_periodic();
+
     /* Read and write functions taking the differences between buses into
      * account */
     bool _block_read(uint8_t reg, uint8_t *buf, uint32_t size);
@@ -121,6 +124,8 @@ class AP_MPU9250_AuxiliaryBus : public AuxiliaryBus
 
 public:
     AP_HAL::Semaphore *get_semaphore() override;
+    AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec,
+                                                              AP_HAL::Device::PeriodicCb cb) override;
 
 protected:
     AP_MPU9250_AuxiliaryBus(AP_InertialSensor_MPU9250 &backend);
@@ -20,6 +20,8 @@
 
 #include <inttypes.h>
 
+#include <AP_HAL/Device.h>
+
 class AuxiliaryBus;
 class AP_InertialSensor_Backend;
 
@@ -114,6 +116,19 @@ public:
      */
     virtual AP_HAL::Semaphore *get_semaphore() = 0;
 
+    /*
+     * Run a callback periodically from the thread of the bus this sensor
+     * is on, with the semaphore above taken, as for
+     * AP_HAL::Device::register_periodic_callback(). Returns nullptr if the
+     * sensor exposing the AuxiliaryBus doesn't support it, in which case
+     * the slave driver has to poll from a timer process.
+     */
+    virtual AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec,
+                                                                      AP_HAL::Device::PeriodicCb cb)
+    {
+        return nullptr;
+    }
+
 protected:
     /* Only AP_InertialSensor_Backend is able to create a bus */
     AuxiliaryBus(AP_InertialSensor_Backend &backend, uint8_t max_slaves);
@@ -0,0 +1,86 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+/*
+ * location math is called many times per loop by the navigation
+ * controllers, mostly between the current position and a nearby waypoint
+ */
+static Location make_location(int32_t lat, int32_t lng)
+{
+    Location loc {};
+    loc.lat = lat;
+    loc.lng = lng;
+    return loc;
+}
+
+static const Location loc1 = make_location(-353632620, 1491652300);
+static const Location loc2 = make_location(-353628950, 1491659640);
+
+static void BM_LocationGetDistance(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        float d = get_distance(loc1, loc2);
+        gbenchmark_escape(&d);
+    }
+}
+
+BENCHMARK(BM_LocationGetDistance);
+
+static void BM_LocationGetBearing(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        int32_t b = get_bearing_cd(loc1, loc2);
+        gbenchmark_escape(&b);
+    }
+}
+
+BENCHMARK(BM_LocationGetBearing);
+
+static void BM_LocationDiff(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        Vector2f v = location_diff(loc1, loc2);
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_LocationDiff);
+
+static void BM_LocationUpdate(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        Location loc = loc1;
+        location_update(loc, 45.0f, 100.0f);
+        gbenchmark_escape(&loc);
+    }
+}
+
+BENCHMARK(BM_LocationUpdate);
+
+static void BM_LocationOffset(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        Location loc = loc1;
+        location_offset(loc, 30.0f, -40.0f);
+        gbenchmark_escape(&loc);
+    }
+}
+
+BENCHMARK(BM_LocationOffset);
+
+static void BM_LocationLLHToECEF(benchmark::State& state)
+{
+    const Vector3d llh(radians(-35.363262), radians(149.165230), 584.0);
+
+    while (state.KeepRunning()) {
+        Vector3d ecef;
+        wgsllh2ecef(llh, ecef);
+        gbenchmark_escape(&ecef);
+    }
+}
+
+BENCHMARK(BM_LocationLLHToECEF);
+
+BENCHMARK_MAIN()
@@ -0,0 +1,59 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+/*
+ * Polygon_outside() is run against the fence on every main loop iteration
+ * by Plane and by AC_Fence, so the cost per vertex matters for large
+ * fences. The polygon is a closed regular polygon of state.range_x()
+ * vertices around CMAC, in the 1e-7 degree units used for fence points.
+ */
+static void make_polygon(Vector2l *V, unsigned n)
+{
+    const int32_t center_x = -353632620;
+    const int32_t center_y = 1491652300;
+    const float radius = 50000;
+
+    for (unsigned i = 0; i < n - 1; i++) {
+        float angle = 2 * M_PI * i / (n - 1);
+        V[i].x = center_x + radius * cosf(angle);
+        V[i].y = center_y + radius * sinf(angle);
+    }
+    V[n - 1] = V[0];
+}
+
+static void BM_PolygonOutsideInside(benchmark::State& state)
+{
+    const unsigned n = state.range_x();
+    Vector2l *V = new Vector2l[n];
+    make_polygon(V, n);
+    Vector2l P(-353632620 + 1000, 1491652300 - 1000);
+
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(P, V, n);
+        gbenchmark_escape(&outside);
+    }
+
+    delete[] V;
+}
+
+BENCHMARK(BM_PolygonOutsideInside)->Arg(8)->Arg(32)->Arg(84);
+
+static void BM_PolygonOutsideOutside(benchmark::State& state)
+{
+    const unsigned n = state.range_x();
+    Vector2l *V = new Vector2l[n];
+    make_polygon(V, n);
+    Vector2l P(-353632620 + 100000, 1491652300);
+
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(P, V, n);
+        gbenchmark_escape(&outside);
+    }
+
+    delete[] V;
+}
+
+BENCHMARK(BM_PolygonOutsideOutside)->Arg(8)->Arg(32)->Arg(84);
+
+BENCHMARK_MAIN()
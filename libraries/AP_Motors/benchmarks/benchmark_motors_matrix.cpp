@@ -0,0 +1,50 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Motors/AP_Motors.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+ * the roll/pitch/yaw/throttle mix of the matrix frames, without the spool
+ * logic and PWM output so nothing touches the HAL. The demands change every
+ * iteration and saturate on some of them, so both the plain mix and the
+ * limit handling are in the numbers.
+ */
+template <class Frame>
+class MotorsMixer : public Frame {
+public:
+    MotorsMixer() : Frame(400) {
+        this->setup_motors();
+        this->armed(true);
+    }
+
+    void mix() {
+        this->update_throttle_filter();
+        this->output_armed_stabilizing();
+        this->thrust_compensation();
+    }
+};
+
+template <class Frame>
+static void BM_MotorsMatrixMix(benchmark::State& state)
+{
+    MotorsMixer<Frame> motors;
+    uint16_t i = 0;
+
+    while (state.KeepRunning()) {
+        float phase = (i++ % 100) * 0.02f - 1.0f;
+        motors.set_roll(phase);
+        motors.set_pitch(-0.5f * phase);
+        motors.set_yaw(0.3f * phase);
+        motors.set_throttle(0.5f + 0.4f * phase);
+        motors.mix();
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MotorsMatrixMix, AP_MotorsQuad);
+BENCHMARK_TEMPLATE(BM_MotorsMatrixMix, AP_MotorsHexa);
+BENCHMARK_TEMPLATE(BM_MotorsMatrixMix, AP_MotorsOcta);
+
+BENCHMARK_MAIN()
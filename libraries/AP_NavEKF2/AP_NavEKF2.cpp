@@ -597,6 +597,13 @@ bool NavEKF2::InitialiseFilter(void)
             return false;
         }
         
+        sharedObs = new NavEKF2_SharedObs();
+        if (sharedObs == nullptr || !sharedObs->init()) {
+            _enable.set(0);
+            GCS_MAVLINK::send_statustext_all(MAV_SEVERITY_CRITICAL, "NavEKF2: allocation failed");
+            return false;
+        }
+
         core = new NavEKF2_core[num_cores];
         if (core == nullptr) {
             _enable.set(0);
@@ -641,6 +648,9 @@ void NavEKF2::UpdateFilter(void)
     
     const AP_InertialSensor &ins = _ahrs->get_ins();
 
+    // read the observations shared by the cores
+    sharedObs->update(*this);
+
     for (uint8_t i=0; i<num_cores; i++) {
         // if the previous core has only recently finished a new state prediction cycle, then
         // don't start a new cycle to allow time for fusion operations to complete if the update
@@ -715,6 +725,16 @@ int8_t NavEKF2::getPrimaryCoreIndex(void) const
     return primary;
 }
 
+// return the memory used by all the cores and their shared buffers in bytes
+uint32_t NavEKF2::get_memory_used(void) const
+{
+    uint32_t ret = sharedObs ? sharedObs->get_memory_used() : 0;
+    for (uint8_t i=0; core && i<num_cores; i++) {
+        ret += core[i].get_memory_used();
+    }
+    return ret;
+}
+
 // returns the index of the IMU of the primary core
 // return -1 if no primary core selected
 int8_t NavEKF2::getPrimaryCoreIMUIndex(void) const
@@ -31,12 +31,15 @@
 #include <AP_RangeFinder/AP_RangeFinder.h>
 
 class NavEKF2_core;
+class NavEKF2_SharedObs;
 class AP_AHRS;
 
 class NavEKF2
 {
 public:
     friend class NavEKF2_core;
+    friend class NavEKF2_SharedObs;
+    friend class NavEKF2_core_Benchmark;
     static const struct AP_Param::GroupInfo var_info[];
 
     NavEKF2(const AP_AHRS *ahrs, AP_Baro &baro, const RangeFinder &rng);
@@ -46,6 +49,9 @@ public:
         return num_cores;
     }
 
+    // return the memory used by all the cores and their shared buffers in bytes
+    uint32_t get_memory_used(void) const;
+
     // Initialise the filter
     bool InitialiseFilter(void);
 
@@ -293,6 +299,7 @@ private:
     uint8_t num_cores; // number of allocated cores
     uint8_t primary;   // current primary core
     NavEKF2_core *core = nullptr;
+    NavEKF2_SharedObs *sharedObs = nullptr; // observations read once for all the cores
     const AP_AHRS *_ahrs;
     AP_Baro &_baro;
     const RangeFinder &_rng;
@@ -207,7 +207,7 @@ void NavEKF2_core::SelectTasFusion()
     readAirSpdData();
 
     // If we haven't received airspeed data for a while, then declare the airspeed data as being timed out
-    if (imuSampleTime_ms - tasDataNew.time_ms > frontend->tasRetryTime_ms) {
+    if (imuSampleTime_ms - frontend->sharedObs->tasDataNew.time_ms > frontend->tasRetryTime_ms) {
         tasTimeout = true;
     }
 
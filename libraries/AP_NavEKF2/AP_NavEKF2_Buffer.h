@@ -2,9 +2,18 @@
 
 // EKF Buffer models
 
+// read position of one user of an observation buffer
+struct obs_reader_t {
+    uint32_t next;  // count of the oldest sample not recalled yet
+};
+
 // this buffer model is to be used for observation buffers,
 // the data is pushed into buffer like any standard ring buffer
-// return is based on the sample time provided
+// return is based on the sample time provided.
+// Samples are kept in time order so they can be recalled with a binary
+// search, and each reader has its own read position so a buffer can be
+// shared by all the cores. A buffer used by a single core can use the
+// internal reader
 template <typename element_type>
 class obs_ring_buffer_t
 {
@@ -23,93 +32,97 @@ public:
         }
         memset(buffer,0,size*sizeof(element_t));
         _size = size;
-        _head = 0;
-        _tail = 0;
-        _new_data = false;
+        _count = 0;
+        _first = 0;
+        _reader.next = 0;
         return true;
     }
 
     /*
      * Searches through a ring buffer and return the newest data that is older than the
      * time specified by sample_time_ms
-     * Zeros old data so it cannot not be used again
+     * Data older than the returned element is skipped for that reader, so it is not used again
      * Returns false if no data can be found that is less than 100msec old
     */
-
-    bool recall(element_type &element,uint32_t sample_time)
+    bool recall(obs_reader_t &reader, element_type &element, uint32_t sample_time) const
     {
-        if(!_new_data) {
-            return false;
+        // oldest sample that is still stored and hasn't been read
+        uint32_t lo = reader.next;
+        if ((int32_t)(_first - lo) > 0) {
+            lo = _first;
         }
-        bool success = false;
-        uint8_t tail = _tail, bestIndex;
-
-        if(_head == tail) {
-            if (buffer[tail].element.time_ms != 0 && buffer[tail].element.time_ms <= sample_time) {
-                // if head is equal to tail just check if the data is unused and within time horizon window
-                if (((sample_time - buffer[tail].element.time_ms) < 100)) {
-                    bestIndex = tail;
-                    success = true;
-                    _new_data = false;
-                }
-            }
-        } else {
-            while(_head != tail) {
-                // find a measurement older than the fusion time horizon that we haven't checked before
-                if (buffer[tail].element.time_ms != 0 && buffer[tail].element.time_ms <= sample_time) {
-                    // Find the most recent non-stale measurement that meets the time horizon criteria
-                    if (((sample_time - buffer[tail].element.time_ms) < 100)) {
-                        bestIndex = tail;
-                        success = true;
-                    }
-                } else if(buffer[tail].element.time_ms > sample_time){
-                    break;
-                }
-                tail = (tail+1)%_size;
+        const uint32_t first = lo;
+        uint32_t hi = _count;
+
+        // find the first sample newer than sample_time
+        while (lo != hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (at(mid).time_ms <= sample_time) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
             }
         }
 
-        if (success) {
-            element = buffer[bestIndex].element;
-            _tail = (bestIndex+1)%_size;
-            //make time zero to stop using it again, 
-            //resolves corner case of reusing the element when head == tail
-            buffer[bestIndex].element.time_ms = 0;
-            return true;
-        } else {
+        // the one before is the newest which isn't, if there is one and
+        // it is within the time horizon window
+        if (lo == first || (sample_time - at(lo - 1).time_ms) >= 100) {
             return false;
         }
+
+        element = at(lo - 1);
+        reader.next = lo;
+        return true;
+    }
+
+    bool recall(element_type &element, uint32_t sample_time)
+    {
+        return recall(_reader, element, sample_time);
     }
 
     /*
      * Writes data and timestamp to a Ring buffer and advances indices that
      * define the location of the newest and oldest data
+     * A sample older than the newest one starts the buffer over so the
+     * stored samples stay in time order
     */
     inline void push(element_type element)
     {
-        // Advance head to next available index
-        _head = (_head+1)%_size;
-        // New data is written at the head
-        buffer[_head].element = element;
-        _new_data = true;
-    }
-    // writes the same data to all elements in the ring buffer
-    inline void reset_history(element_type element, uint32_t sample_time) {
-        for (uint8_t index=0; index<_size; index++) {
-            buffer[index].element = element;
+        if (_count != _first && element.time_ms < at(_count - 1).time_ms) {
+            _first = _count;
+        }
+        buffer[_count % _size].element = element;
+        _count++;
+        if (_count - _first > _size) {
+            _first = _count - _size;
         }
     }
 
-    // zeroes all data in the ring buffer
+    // discards all the data stored so far for a reader
+    inline void reset(obs_reader_t &reader) const {
+        reader.next = _count;
+    }
+
+    // discards all the data stored so far
     inline void reset() {
-        _head = 0;
-        _tail = 0;
-        _new_data = false;
-        memset(buffer,0,_size*sizeof(element_t));
+        _first = _count;
+        _reader.next = _count;
+    }
+
+    // returns the memory allocated for the buffer in bytes
+    uint32_t get_memory_used() const {
+        return _size*sizeof(element_t);
     }
 
 private:
-    uint8_t _size,_head,_tail,_new_data;
+    const element_type &at(uint32_t count) const {
+        return buffer[count % _size].element;
+    }
+
+    uint32_t _size;
+    uint32_t _count;    // number of samples ever pushed
+    uint32_t _first;    // count of the oldest sample stored
+    obs_reader_t _reader;
 };
 
 
@@ -185,6 +198,11 @@ public:
     inline uint8_t get_youngest_index(){
         return _youngest;
     }
+
+    // returns the memory allocated for the buffer in bytes
+    uint32_t get_memory_used() const {
+        return _size*sizeof(element_t);
+    }
 private:
     uint8_t _size,_oldest,_youngest;
 };
\ No newline at end of file
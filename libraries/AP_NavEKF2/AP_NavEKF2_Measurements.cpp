@@ -473,7 +473,7 @@ void NavEKF2_core::readGpsData()
                 alignMagStateDeclination();
 
                 // Set the height of the NED origin to ‘height of baro height datum relative to GPS height datum'
-                EKF_origin.alt = gpsloc.alt - baroDataNew.hgt;
+                EKF_origin.alt = gpsloc.alt - frontend->sharedObs->baroDataNew.hgt;
 
                 // Set the uncertinty of the GPS origin height
                 ekfOriginHgtVar = sq(gpsHgtAccuracy);
@@ -513,42 +513,73 @@ bool NavEKF2_core::readDeltaAngle(uint8_t ins_index, Vector3f &dAng) {
 
 
 /********************************************************
-*                  Height Measurements                  *
+*                 Shared Measurements                   *
 ********************************************************/
 
-// check for new pressure altitude measurement data and update stored measurement if available
-void NavEKF2_core::readBaroData()
+// allocate the buffers, returns false when allocation has failed
+bool NavEKF2_SharedObs::init(void)
+{
+    if (!storedBaro.init(OBS_BUFFER_LENGTH)) {
+        return false;
+    }
+    if (!storedTAS.init(OBS_BUFFER_LENGTH)) {
+        return false;
+    }
+    return true;
+}
+
+// check for new baro and airspeed data and store it in the buffers
+void NavEKF2_SharedObs::update(NavEKF2 &frontend)
 {
+    // the cores correct for the average intersampling delay due to the filter update rate
+    const AP_InertialSensor &ins = frontend._ahrs->get_ins();
+    uint8_t filterTimeStep_ms = (uint8_t)(1000*ins.get_loop_delta_t());
+    filterTimeStep_ms = MAX(filterTimeStep_ms,10);
+
     // check to see if baro measurement has changed so we know if a new measurement has arrived
     // do not accept data at a faster rate than 14Hz to avoid overflowing the FIFO buffer
-    if (frontend->_baro.get_last_update() - lastBaroReceived_ms > 70) {
-        frontend->logging.log_baro = true;
-
-        baroDataNew.hgt = frontend->_baro.get_altitude();
+    if (frontend._baro.get_last_update() - lastBaroReceived_ms > 70) {
+        frontend.logging.log_baro = true;
 
-        // If we are in takeoff mode, the height measurement is limited to be no less than the measurement at start of takeoff
-        // This prevents negative baro disturbances due to copter downwash corrupting the EKF altitude during initial ascent
-        if (getTakeoffExpected()) {
-            baroDataNew.hgt = MAX(baroDataNew.hgt, meaHgtAtTakeOff);
-        }
+        baroDataNew.hgt = frontend._baro.get_altitude();
 
         // time stamp used to check for new measurement
-        lastBaroReceived_ms = frontend->_baro.get_last_update();
+        lastBaroReceived_ms = frontend._baro.get_last_update();
 
         // estimate of time height measurement was taken, allowing for delays
-        baroDataNew.time_ms = lastBaroReceived_ms - frontend->_hgtDelay_ms;
-
-        // Correct for the average intersampling delay due to the filter updaterate
-        baroDataNew.time_ms -= localFilterTimeStep_ms/2;
-
-        // Prevent time delay exceeding age of oldest IMU data in the buffer
-        baroDataNew.time_ms = MAX(baroDataNew.time_ms,imuDataDelayed.time_ms);
+        baroDataNew.time_ms = lastBaroReceived_ms - frontend._hgtDelay_ms - filterTimeStep_ms/2;
 
         // save baro measurement to buffer to be fused later
         storedBaro.push(baroDataNew);
     }
+
+    // if airspeed reading is valid and is set by the user to be used and has been updated then
+    // we take a new reading and convert from EAS to TAS
+    const AP_Airspeed *aspeed = frontend._ahrs->get_airspeed();
+    if (aspeed &&
+            aspeed->use() &&
+            aspeed->last_update_ms() != timeTasReceived_ms) {
+        tasDataNew.tas = aspeed->get_airspeed() * aspeed->get_EAS2TAS();
+        timeTasReceived_ms = aspeed->last_update_ms();
+        tasDataNew.time_ms = timeTasReceived_ms - frontend.tasDelay_ms - filterTimeStep_ms/2;
+
+        // Save data into the buffer to be fused when the fusion time horizon catches up with it
+        storedTAS.push(tasDataNew);
+    }
+}
+
+// return the memory used by the buffers in bytes
+uint32_t NavEKF2_SharedObs::get_memory_used(void) const
+{
+    return sizeof(*this) +
+        storedBaro.get_memory_used() +
+        storedTAS.get_memory_used();
 }
 
+/********************************************************
+*                  Height Measurements                  *
+********************************************************/
+
 // calculate filtered offset between baro height measurement and EKF height estimate
 // offset should be subtracted from baro measurement to match filter estimate
 // offset is used to enable reversion to baro from alternate height data source
@@ -606,28 +637,10 @@ void NavEKF2_core::calcFiltGpsHgtOffset()
 *                Air Speed Measurements                 *
 ********************************************************/
 
-// check for new airspeed data and update stored measurements if available
+// check the shared buffer for airspeed measurements that have been overtaken by the fusion time horizon and need to be fused
 void NavEKF2_core::readAirSpdData()
 {
-    // if airspeed reading is valid and is set by the user to be used and has been updated then
-    // we take a new reading, convert from EAS to TAS and set the flag letting other functions
-    // know a new measurement is available
-    const AP_Airspeed *aspeed = _ahrs->get_airspeed();
-    if (aspeed &&
-            aspeed->use() &&
-            aspeed->last_update_ms() != timeTasReceived_ms) {
-        tasDataNew.tas = aspeed->get_airspeed() * aspeed->get_EAS2TAS();
-        timeTasReceived_ms = aspeed->last_update_ms();
-        tasDataNew.time_ms = timeTasReceived_ms - frontend->tasDelay_ms;
-
-        // Correct for the average intersampling delay due to the filter update rate
-        tasDataNew.time_ms -= localFilterTimeStep_ms/2;
-
-        // Save data into the buffer to be fused when the fusion time horizon catches up with it
-        storedTAS.push(tasDataNew);
-    }
-    // Check the buffer for measurements that have been overtaken by the fusion time horizon and need to be fused
-    tasDataToFuse = storedTAS.recall(tasDataDelayed,imuDataDelayed.time_ms);
+    tasDataToFuse = frontend->sharedObs->storedTAS.recall(tasReader, tasDataDelayed, imuDataDelayed.time_ms);
 }
 
 #endif // HAL_CPU_CLASS
@@ -558,4 +558,16 @@ void NavEKF2_core::getOutputTrackingError(Vector3f &error) const
     error = outputTrackError;
 }
 
+// return the memory used by the core and its buffers in bytes
+uint32_t NavEKF2_core::get_memory_used(void) const
+{
+    return sizeof(*this) +
+        storedIMU.get_memory_used() +
+        storedGPS.get_memory_used() +
+        storedMag.get_memory_used() +
+        storedRange.get_memory_used() +
+        storedOutput.get_memory_used() +
+        storedOF.get_memory_used();
+}
+
 #endif // HAL_CPU_CLASS
@@ -634,9 +634,14 @@ void NavEKF2_core::selectHeightForFusion()
     readRangeFinder();
     rangeDataToFuse = storedRange.recall(rangeDataDelayed,imuDataDelayed.time_ms);
 
-    // read baro height data from the sensor and check for new data in the buffer
-    readBaroData();
-    baroDataToFuse = storedBaro.recall(baroDataDelayed, imuDataDelayed.time_ms);
+    // check for new baro height data in the buffer shared by the cores
+    baroDataToFuse = frontend->sharedObs->storedBaro.recall(baroReader, baroDataDelayed, imuDataDelayed.time_ms);
+
+    // If we are in takeoff mode, the height measurement is limited to be no less than the measurement at start of takeoff
+    // This prevents negative baro disturbances due to copter downwash corrupting the EKF altitude during initial ascent
+    if (baroDataToFuse && getTakeoffExpected()) {
+        baroDataDelayed.hgt = MAX(baroDataDelayed.hgt, meaHgtAtTakeOff);
+    }
 
     // select height source
     if (((frontend->_useRngSwHgt > 0) || (frontend->_altSource == 1)) && (imuSampleTime_ms - rngValidMeaTime_ms < 500)) {
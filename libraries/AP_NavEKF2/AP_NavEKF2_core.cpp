@@ -76,12 +76,6 @@ bool NavEKF2_core::setup_core(NavEKF2 *_frontend, uint8_t _imu_index, uint8_t _c
     if(!storedMag.init(OBS_BUFFER_LENGTH)) {
         return false;
     }
-    if(!storedBaro.init(OBS_BUFFER_LENGTH)) {
-        return false;
-    } 
-    if(!storedTAS.init(OBS_BUFFER_LENGTH)) {
-        return false;
-    }
     if(!storedOF.init(OBS_BUFFER_LENGTH)) {
         return false;
     }
@@ -117,7 +111,6 @@ void NavEKF2_core::InitialiseVariables()
     prevTasStep_ms = imuSampleTime_ms;
     prevBetaStep_ms = imuSampleTime_ms;
     lastMagUpdate_us = 0;
-    lastBaroReceived_ms = imuSampleTime_ms;
     lastVelPassTime_ms = imuSampleTime_ms;
     lastPosPassTime_ms = imuSampleTime_ms;
     lastHgtPassTime_ms = imuSampleTime_ms;
@@ -135,7 +128,6 @@ void NavEKF2_core::InitialiseVariables()
     ekfStartTime_ms = imuSampleTime_ms;
     lastGpsVelFail_ms = 0;
     lastGpsAidBadTime_ms = 0;
-    timeTasReceived_ms = 0;
     magYawResetTimer_ms = imuSampleTime_ms;
     lastPreAlignGpsCheckTime_ms = imuSampleTime_ms;
     lastPosReset_ms = 0;
@@ -274,8 +266,8 @@ void NavEKF2_core::InitialiseVariables()
     storedIMU.reset();
     storedGPS.reset();
     storedMag.reset();
-    storedBaro.reset();
-    storedTAS.reset();
+    frontend->sharedObs->storedBaro.reset(baroReader);
+    frontend->sharedObs->storedTAS.reset(tasReader);
     storedRange.reset();
     storedOutput.reset();
 }
@@ -343,8 +335,7 @@ bool NavEKF2_core::InitialiseFilterBootstrap(void)
     ResetVelocity();
     ResetPosition();
 
-    // read the barometer and set the height state
-    readBaroData();
+    // set the height state
     ResetHeight();
 
     // define Earth rotation vector in the NED navigation frame
@@ -47,8 +47,51 @@
 
 class AP_AHRS;
 
+/*
+  Observations which are the same for every core. The frontend reads them
+  once per frame and each core recalls them at its own fusion time horizon
+ */
+class NavEKF2_SharedObs
+{
+public:
+    struct baro_elements {
+        float       hgt;         // 0
+        uint32_t    time_ms;     // 1
+    };
+
+    struct tas_elements {
+        float       tas;         // 0
+        uint32_t    time_ms;     // 1
+    };
+
+    // Length of FIFO buffers used for non-IMU sensor data.
+    // Must be larger than the time period defined by IMU_BUFFER_LENGTH
+    static const uint32_t OBS_BUFFER_LENGTH = 5;
+
+    // allocate the buffers, returns false when allocation has failed
+    bool init(void);
+
+    // check for new baro and airspeed data and store it in the buffers
+    void update(NavEKF2 &frontend);
+
+    // return the memory used by the buffers in bytes
+    uint32_t get_memory_used(void) const;
+
+    obs_ring_buffer_t<baro_elements> storedBaro;
+    obs_ring_buffer_t<tas_elements> storedTAS;
+
+    baro_elements baroDataNew;      // latest baro data
+    tas_elements tasDataNew;        // latest TAS data
+
+private:
+    uint32_t lastBaroReceived_ms;   // time last time we received baro height data
+    uint32_t timeTasReceived_ms;    // time last TAS data was received (msec)
+};
+
 class NavEKF2_core
 {
+    friend class NavEKF2_core_Benchmark;
+
 public:
     // Constructor
     NavEKF2_core(void);
@@ -278,6 +321,9 @@ public:
 
     // get the IMU index
     uint8_t getIMUIndex(void) const { return imu_index; }
+
+    // return the memory used by the core and its buffers in bytes
+    uint32_t get_memory_used(void) const;
     
 private:
     // Reference to the global EKF frontend for parameters
@@ -381,20 +427,14 @@ private:
         uint32_t    time_ms;     // 3
     };
 
-    struct baro_elements {
-        float       hgt;         // 0
-        uint32_t    time_ms;     // 1
-    };
+    typedef NavEKF2_SharedObs::baro_elements baro_elements;
 
     struct range_elements {
         float       rng;         // 0
         uint32_t    time_ms;     // 1
     };
 
-    struct tas_elements {
-        float       tas;         // 0
-        uint32_t    time_ms;     // 1
-    };
+    typedef NavEKF2_SharedObs::tas_elements tas_elements;
 
     struct of_elements {
         Vector2f    flowRadXY;      // 0..1
@@ -508,13 +548,10 @@ private:
     // check for new valid GPS data and update stored measurement if available
     void readGpsData();
 
-    // check for new altitude measurement data and update stored measurement if available
-    void readBaroData();
-
     // check for new magnetometer data and update store measurements if available
     void readMagData();
 
-    // check for new airspeed data and update stored measurements if available
+    // check the shared buffer for airspeed data at the fusion time horizon
     void readAirSpdData();
 
     // determine when to perform fusion of GPS position and  velocity measurements
@@ -656,8 +693,7 @@ private:
     uint8_t effective_magCal(void) const;
     
     // Length of FIFO buffers used for non-IMU sensor data.
-    // Must be larger than the time period defined by IMU_BUFFER_LENGTH
-    static const uint32_t OBS_BUFFER_LENGTH = 5;
+    static const uint32_t OBS_BUFFER_LENGTH = NavEKF2_SharedObs::OBS_BUFFER_LENGTH;
 
     // Variables
     bool statesInitialised;         // boolean true when filter states have been initialised
@@ -684,8 +720,8 @@ private:
     imu_ring_buffer_t<imu_elements> storedIMU;      // IMU data buffer
     obs_ring_buffer_t<gps_elements> storedGPS;      // GPS data buffer
     obs_ring_buffer_t<mag_elements> storedMag;      // Magnetometer data buffer
-    obs_ring_buffer_t<baro_elements> storedBaro;    // Baro data buffer
-    obs_ring_buffer_t<tas_elements> storedTAS;      // TAS data buffer
+    obs_reader_t baroReader;        // read position in the shared baro data buffer
+    obs_reader_t tasReader;         // read position in the shared TAS data buffer
     obs_ring_buffer_t<range_elements> storedRange;
     imu_ring_buffer_t<output_elements> storedOutput;// output state buffer
     Matrix3f prevTnb;               // previous nav to body transformation used for INS earth rotation compensation
@@ -720,7 +756,6 @@ private:
     Vector3f velDotNEDfilt;         // low pass filtered velDotNED
     uint32_t imuSampleTime_ms;      // time that the last IMU value was taken
     bool tasDataToFuse;             // true when new airspeed data is waiting to be fused
-    uint32_t lastBaroReceived_ms;   // time last time we received baro height data
     uint16_t hgtRetryTime_ms;       // time allowed without use of height measurements before a height timeout is declared
     uint32_t lastVelPassTime_ms;    // time stamp when GPS velocity measurement last passed innovation consistency check (msec)
     uint32_t lastPosPassTime_ms;    // time stamp when GPS position measurement last passed innovation consistency check (msec)
@@ -772,13 +807,11 @@ private:
     Quaternion imuQuatDownSampleNew; // Quaternion obtained by rotating through the IMU delta angles since the start of the current down sampled frame
     uint8_t fifoIndexNow;           // Global index for inertial and output solution at current time horizon
     uint8_t fifoIndexDelayed;       // Global index for inertial and output solution at delayed/fusion time horizon
-    baro_elements baroDataNew;      // Baro data at the current time horizon
     baro_elements baroDataDelayed;  // Baro data at the fusion time horizon
     uint8_t baroStoreIndex;         // Baro data storage index
     range_elements rangeDataNew;    // Range finder data at the current time horizon
     range_elements rangeDataDelayed;// Range finder data at the fusion time horizon
     uint8_t rangeStoreIndex;        // Range finder data storage index
-    tas_elements tasDataNew;        // TAS data at the current time horizon
     tas_elements tasDataDelayed;    // TAS data at the fusion time horizon
     uint8_t tasStoreIndex;          // TAS data storage index
     mag_elements magDataNew;        // Magnetometer data at the current time horizon
@@ -793,7 +826,6 @@ private:
     Vector3f velErrintegral;        // integral of output predictor NED velocity tracking error (m)
     Vector3f posErrintegral;        // integral of output predictor NED position tracking error (m.sec)
     float innovYaw;                 // compass yaw angle innovation (rad)
-    uint32_t timeTasReceived_ms;    // time last TAS data was received (msec)
     bool gpsGoodToAlign;            // true when the GPS quality can be used to initialise the navigation system
     uint32_t magYawResetTimer_ms;   // timer in msec used to track how long good magnetometer data is failing innovation consistency checks
     bool consistentMagData;         // true when the magnetometers are passing consistency checks
@@ -0,0 +1,126 @@
+#include <AP_gbenchmark.h>
+
+#include <string.h>
+
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Baro/AP_Baro.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_NavEKF2/AP_NavEKF2.h>
+#include <AP_NavEKF2/AP_NavEKF2_core.h>
+#include <AP_RangeFinder/AP_RangeFinder.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+ * runs the predict and GPS fusion steps of a single EKF2 core directly,
+ * with the full 24 states active. The core is set up as after a level
+ * bootstrap and fed fixed IMU deltas for one 10ms fusion step, so the
+ * numbers don't depend on any sensor drivers being present.
+ */
+class NavEKF2_core_Benchmark {
+public:
+    NavEKF2_core_Benchmark()
+    {
+        ekf2.sharedObs = new NavEKF2_SharedObs();
+        ekf2.sharedObs->init();
+        core.setup_core(&ekf2, 0, 0);
+        core.InitialiseVariables();
+
+        core.stateStruct.quat.from_euler(0.0f, 0.0f, 0.0f);
+        core.stateStruct.velocity.zero();
+        core.stateStruct.position.zero();
+        core.stateStruct.angErr.zero();
+        core.stateStruct.gyro_bias.zero();
+        core.stateStruct.gyro_scale = Vector3f(1.0f, 1.0f, 1.0f);
+        core.stateStruct.accel_zbias = 0.0f;
+        core.stateStruct.wind_vel.zero();
+        core.stateStruct.earth_magfield = Vector3f(0.22f, 0.05f, -0.52f);
+        core.stateStruct.body_magfield.zero();
+        core.CovarianceInit();
+
+        core.imuDataDelayed.delAng = Vector3f(0.001f, -0.0005f, 0.0002f);
+        core.imuDataDelayed.delVel = Vector3f(0.01f, 0.0f, -GRAVITY_MSS * core.EKF_TARGET_DT);
+        core.imuDataDelayed.delAngDT = core.EKF_TARGET_DT;
+        core.imuDataDelayed.delVelDT = core.EKF_TARGET_DT;
+
+        core.PV_AidingMode = NavEKF2_core::AID_ABSOLUTE;
+        core.gpsDataDelayed.pos = Vector2f(0.5f, -0.3f);
+        core.gpsDataDelayed.vel = Vector3f(0.1f, 0.05f, -0.02f);
+        core.hgtMea = 0.2f;
+
+        memcpy(&saved_states, &core.statesArray, sizeof(saved_states));
+        memcpy(&saved_P, &core.P, sizeof(saved_P));
+    }
+
+    void predict()
+    {
+        core.UpdateStrapdownEquationsNED();
+        core.CovariancePrediction();
+    }
+
+    void fuse_vel_pos()
+    {
+        core.fuseVelData = true;
+        core.fusePosData = true;
+        core.fuseHgtData = true;
+        core.FuseVelPosNED();
+    }
+
+    // go back to the state at construction, so every fusion sees the
+    // same innovations and is accepted
+    void restore()
+    {
+        memcpy(&core.statesArray, &saved_states, sizeof(saved_states));
+        memcpy(&core.P, &saved_P, sizeof(saved_P));
+    }
+
+private:
+    AP_InertialSensor ins;
+    AP_Baro barometer;
+    AP_GPS gps;
+    AP_SerialManager serial_manager;
+    RangeFinder rangefinder {serial_manager};
+    AP_AHRS_DCM ahrs {ins, barometer, gps};
+    NavEKF2 ekf2 {&ahrs, barometer, rangefinder};
+    NavEKF2_core core;
+
+    NavEKF2_core::Vector28 saved_states;
+    NavEKF2_core::Matrix24 saved_P;
+};
+
+static NavEKF2_core_Benchmark &ekf()
+{
+    static NavEKF2_core_Benchmark e;
+    return e;
+}
+
+static void BM_NavEKF2Predict(benchmark::State& state)
+{
+    NavEKF2_core_Benchmark &e = ekf();
+    e.restore();
+
+    while (state.KeepRunning()) {
+        e.predict();
+    }
+}
+
+BENCHMARK(BM_NavEKF2Predict);
+
+static void BM_NavEKF2FuseVelPos(benchmark::State& state)
+{
+    NavEKF2_core_Benchmark &e = ekf();
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        e.restore();
+        state.ResumeTiming();
+        e.fuse_vel_pos();
+    }
+}
+
+BENCHMARK(BM_NavEKF2FuseVelPos);
+
+BENCHMARK_MAIN()
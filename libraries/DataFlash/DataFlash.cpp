@@ -2,13 +2,24 @@
 
 #include "DataFlash_Backend.h"
 
+extern const AP_HAL::HAL& hal;
+
+// how often the HAL perf counters are logged
+#define DATAFLASH_PERF_LOG_PERIOD_MS 10000
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define DATAFLASH_BLACKBOX_SIZE_DEFAULT 1024
+#else
+#define DATAFLASH_BLACKBOX_SIZE_DEFAULT 32
+#endif
+
 DataFlash_Class *DataFlash_Class::_instance;
 
 const AP_Param::GroupInfo DataFlash_Class::var_info[] = {
     // @Param: _BACKEND_TYPE
     // @DisplayName: DataFlash Backend Storage type
-    // @Description: 0 for None, 1 for File, 2 for dataflash mavlink, 3 for both file and dataflash
-    // @Values: 0:None,1:File,2:MAVLink,3:BothFileAndMAVLink
+    // @Description: Bitmask of the backends to log to. 0 for None, 1 for File, 2 for dataflash mavlink, 3 for both file and dataflash
+    // @Bitmask: 0:File,1:MAVLink,2:BlackBox
     // @User: Standard
     AP_GROUPINFO("_BACKEND_TYPE",  0, DataFlash_Class, _params.backend_types,       DATAFLASH_BACKEND_FILE),
 
@@ -31,6 +42,135 @@ const AP_Param::GroupInfo DataFlash_Class::var_info[] = {
     // @Values: 0:Disabled,1:Enabled
     // @User: Standard
     AP_GROUPINFO("_REPLAY",  3, DataFlash_Class, _params.log_replay,       0),
+
+    // @Param: _FILE_SYNC
+    // @DisplayName: DataFlash File Backend write mode
+    // @Description: How the DataFlash_File backend gets log data onto the card on Linux boards. Fsync calls fsync() after every block written, which can stall for hundreds of milliseconds on some eMMC and SD cards. Streaming reserves the log file in 64 megabyte extents and starts writeback of each block as it is written with sync_file_range(), only ever waiting on data written a megabyte earlier. With Streaming the log size recorded on the card may lag by a few seconds after a power loss. Takes effect on reboot
+    // @Values: 0:Fsync,1:Streaming
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_SYNC",  4, DataFlash_Class, _params.file_sync,       0),
+
+    // @Param: _FILE_RATEMAX
+    // @DisplayName: Maximum rate of each message type in the File backend
+    // @Description: Each message type written to the DataFlash_File backend is decimated to at most this rate. Messages marked critical are never decimated. 0 logs every message
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_RATEMAX",  5, DataFlash_Class, _params.file_rate_max,       0),
+
+    // @Param: _MAV_RATEMAX
+    // @DisplayName: Maximum rate of each message type in the MAVLink backend
+    // @Description: Each message type streamed by the DataFlash_MAVLink backend is decimated to at most this rate, so full rate sensor logging to the File backend does not swamp the telemetry link. Messages marked critical are never decimated. 0 sends every message
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_MAV_RATEMAX",  6, DataFlash_Class, _params.mav_rate_max,       0),
+
+    // @Param: _BBOX_SIZE
+    // @DisplayName: DataFlash black box size (in kilobytes)
+    // @Description: Size of the RAM ring the black box backend (bit 2 of LOG_BACKEND_TYPE) keeps the most recent log messages in. On a crash, EKF failsafe, main loop lockup or on request from the ground station, the ring is written to BBOXn.BIN in the log directory. How many seconds this covers depends on the logging rate. The size may be reduced depending on available memory. Takes effect on reboot
+    // @Units: kB
+    // @Range: 4 16384
+    // @User: Advanced
+    AP_GROUPINFO("_BBOX_SIZE",  7, DataFlash_Class, _params.bbox_size,       DATAFLASH_BLACKBOX_SIZE_DEFAULT),
+
+    // @Param: _FLT1_TYPE
+    // @DisplayName: Filtered message type 1
+    // @Description: Message type ID, as given in the FMT messages of a log, that LOG_FLT1_RATE and LOG_FLT1_MASK apply to. 0 disables this filter
+    // @Range: 0 255
+    // @User: Advanced
+    AP_GROUPINFO("_FLT1_TYPE",  8, DataFlash_Class, _params.filter_type[0],       0),
+
+    // @Param: _FLT1_RATE
+    // @DisplayName: Filtered message type 1 rate
+    // @Description: Maximum rate messages of type LOG_FLT1_TYPE are logged at. Messages over this rate are dropped before they are built where the code writing them allows it. -1 stops the message type being logged, 0 logs every message. Messages marked critical are never decimated. The EKF1-EKF5 and NKF1-NKF9 messages are built together, so setting a rate on some of them saves little time until all of them are rate limited or stopped. Takes effect within a second
+    // @Units: Hz
+    // @Range: -1 1000
+    // @User: Advanced
+    AP_GROUPINFO("_FLT1_RATE",  9, DataFlash_Class, _params.filter_rate[0],       0),
+
+    // @Param: _FLT1_MASK
+    // @DisplayName: Filtered message type 1 field mask
+    // @Description: Bitmask of the fields of message type LOG_FLT1_TYPE to log, bit 0 being the first field after the message header. The first field, normally the timestamp, is always logged. The FMT message for the type describes the fields logged, so log readers and Replay see a message with fewer fields. 0 logs all fields. Takes effect when the next log is started
+    // @User: Advanced
+    AP_GROUPINFO("_FLT1_MASK",  10, DataFlash_Class, _params.filter_mask[0],       0),
+
+    // @Param: _FLT2_TYPE
+    // @DisplayName: Filtered message type 2
+    // @Description: Message type ID, as given in the FMT messages of a log, that LOG_FLT2_RATE and LOG_FLT2_MASK apply to. 0 disables this filter
+    // @Range: 0 255
+    // @User: Advanced
+    AP_GROUPINFO("_FLT2_TYPE",  11, DataFlash_Class, _params.filter_type[1],       0),
+
+    // @Param: _FLT2_RATE
+    // @DisplayName: Filtered message type 2 rate
+    // @Description: Maximum rate messages of type LOG_FLT2_TYPE are logged at. Messages over this rate are dropped before they are built where the code writing them allows it. -1 stops the message type being logged, 0 logs every message. Messages marked critical are never decimated. The EKF1-EKF5 and NKF1-NKF9 messages are built together, so setting a rate on some of them saves little time until all of them are rate limited or stopped. Takes effect within a second
+    // @Units: Hz
+    // @Range: -1 1000
+    // @User: Advanced
+    AP_GROUPINFO("_FLT2_RATE",  12, DataFlash_Class, _params.filter_rate[1],       0),
+
+    // @Param: _FLT2_MASK
+    // @DisplayName: Filtered message type 2 field mask
+    // @Description: Bitmask of the fields of message type LOG_FLT2_TYPE to log, bit 0 being the first field after the message header. The first field, normally the timestamp, is always logged. The FMT message for the type describes the fields logged, so log readers and Replay see a message with fewer fields. 0 logs all fields. Takes effect when the next log is started
+    // @User: Advanced
+    AP_GROUPINFO("_FLT2_MASK",  13, DataFlash_Class, _params.filter_mask[1],       0),
+
+    // @Param: _FLT3_TYPE
+    // @DisplayName: Filtered message type 3
+    // @Description: Message type ID, as given in the FMT messages of a log, that LOG_FLT3_RATE and LOG_FLT3_MASK apply to. 0 disables this filter
+    // @Range: 0 255
+    // @User: Advanced
+    AP_GROUPINFO("_FLT3_TYPE",  14, DataFlash_Class, _params.filter_type[2],       0),
+
+    // @Param: _FLT3_RATE
+    // @DisplayName: Filtered message type 3 rate
+    // @Description: Maximum rate messages of type LOG_FLT3_TYPE are logged at. Messages over this rate are dropped before they are built where the code writing them allows it. -1 stops the message type being logged, 0 logs every message. Messages marked critical are never decimated. The EKF1-EKF5 and NKF1-NKF9 messages are built together, so setting a rate on some of them saves little time until all of them are rate limited or stopped. Takes effect within a second
+    // @Units: Hz
+    // @Range: -1 1000
+    // @User: Advanced
+    AP_GROUPINFO("_FLT3_RATE",  15, DataFlash_Class, _params.filter_rate[2],       0),
+
+    // @Param: _FLT3_MASK
+    // @DisplayName: Filtered message type 3 field mask
+    // @Description: Bitmask of the fields of message type LOG_FLT3_TYPE to log, bit 0 being the first field after the message header. The first field, normally the timestamp, is always logged. The FMT message for the type describes the fields logged, so log readers and Replay see a message with fewer fields. 0 logs all fields. Takes effect when the next log is started
+    // @User: Advanced
+    AP_GROUPINFO("_FLT3_MASK",  16, DataFlash_Class, _params.filter_mask[2],       0),
+
+    // @Param: _FLT4_TYPE
+    // @DisplayName: Filtered message type 4
+    // @Description: Message type ID, as given in the FMT messages of a log, that LOG_FLT4_RATE and LOG_FLT4_MASK apply to. 0 disables this filter
+    // @Range: 0 255
+    // @User: Advanced
+    AP_GROUPINFO("_FLT4_TYPE",  17, DataFlash_Class, _params.filter_type[3],       0),
+
+    // @Param: _FLT4_RATE
+    // @DisplayName: Filtered message type 4 rate
+    // @Description: Maximum rate messages of type LOG_FLT4_TYPE are logged at. Messages over this rate are dropped before they are built where the code writing them allows it. -1 stops the message type being logged, 0 logs every message. Messages marked critical are never decimated. The EKF1-EKF5 and NKF1-NKF9 messages are built together, so setting a rate on some of them saves little time until all of them are rate limited or stopped. Takes effect within a second
+    // @Units: Hz
+    // @Range: -1 1000
+    // @User: Advanced
+    AP_GROUPINFO("_FLT4_RATE",  18, DataFlash_Class, _params.filter_rate[3],       0),
+
+    // @Param: _FLT4_MASK
+    // @DisplayName: Filtered message type 4 field mask
+    // @Description: Bitmask of the fields of message type LOG_FLT4_TYPE to log, bit 0 being the first field after the message header. The first field, normally the timestamp, is always logged. The FMT message for the type describes the fields logged, so log readers and Replay see a message with fewer fields. 0 logs all fields. Takes effect when the next log is started
+    // @User: Advanced
+    AP_GROUPINFO("_FLT4_MASK",  19, DataFlash_Class, _params.filter_mask[3],       0),
+
+    // @Param: _FILE_DROP
+    // @DisplayName: Filtered message types not logged to the File backend
+    // @Description: Bitmask of the filtered message types, as set by LOG_FLTn_TYPE, that are never written to the DataFlash_File backend. The other backends still log them. Takes effect on reboot
+    // @Bitmask: 0:LOG_FLT1_TYPE,1:LOG_FLT2_TYPE,2:LOG_FLT3_TYPE,3:LOG_FLT4_TYPE
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_DROP",  20, DataFlash_Class, _params.file_drop,       0),
+
+    // @Param: _MAV_DROP
+    // @DisplayName: Filtered message types not sent to the MAVLink backend
+    // @Description: Bitmask of the filtered message types, as set by LOG_FLTn_TYPE, that are never streamed by the DataFlash_MAVLink backend, e.g. to keep full rate sensor data off the telemetry link. The other backends still log them. Takes effect on reboot
+    // @Bitmask: 0:LOG_FLT1_TYPE,1:LOG_FLT2_TYPE,2:LOG_FLT3_TYPE,3:LOG_FLT4_TYPE
+    // @User: Advanced
+    AP_GROUPINFO("_MAV_DROP",  21, DataFlash_Class, _params.mav_drop,       0),
     
     AP_GROUPEND
 };
@@ -78,15 +218,60 @@ void DataFlash_Class::set_mission(const AP_Mission *mission) {
 
 // start functions pass straight through to backend:
 void DataFlash_Class::WriteBlock(const void *pBuffer, uint16_t size) {
-    FOR_EACH_BACKEND(WriteBlock(pBuffer, size));
+    WritePrioritisedBlock(pBuffer, size, false);
 }
 
 void DataFlash_Class::WriteCriticalBlock(const void *pBuffer, uint16_t size) {
-    FOR_EACH_BACKEND(WriteCriticalBlock(pBuffer, size));
+    WritePrioritisedBlock(pBuffer, size, true);
+}
+
+static inline bool msg_type_bit_set(const uint32_t *mask, const uint8_t msg_type)
+{
+    return mask[msg_type / 32] & (1U << (msg_type % 32));
 }
 
+// blocks start with a LOG_PACKET_HEADER, so the message type is the
+// third byte
 void DataFlash_Class::WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) {
-    FOR_EACH_BACKEND(WritePrioritisedBlock(pBuffer, size, is_critical));
+    const uint8_t msg_type = ((const uint8_t *)pBuffer)[2];
+    if (msg_type_bit_set(_msg_filter_types, msg_type) &&
+        !msg_filter_pass(msg_type, is_critical)) {
+        return;
+    }
+    if (msg_type_bit_set(_msg_trim_types, msg_type)) {
+        const struct msg_trim *trim = msg_trim_for_type(msg_type);
+        // only messages laid out as the LogStructure says are trimmed
+        if (trim != nullptr && size == trim->full_len) {
+            uint8_t buf[trim->msg_len];
+            memcpy(buf, pBuffer, LOG_PACKET_HEADER_LEN);
+            uint8_t ofs = LOG_PACKET_HEADER_LEN;
+            for (uint8_t i=0; i<trim->num_fields; i++) {
+                memcpy(&buf[ofs], &((const uint8_t *)pBuffer)[trim->field_ofs[i]], trim->field_len[i]);
+                ofs += trim->field_len[i];
+            }
+            WriteBackendsBlock(buf, trim->msg_len, msg_type, is_critical);
+            return;
+        }
+    }
+    WriteBackendsBlock(pBuffer, size, msg_type, is_critical);
+}
+
+// backends filtering msg_type never see the block
+void DataFlash_Class::WriteBackendsBlock(const void *pBuffer, uint16_t size, uint8_t msg_type, bool is_critical) {
+    for (uint8_t i=0; i<_next_backend; i++) {
+        if (backends[i]->filter_message(msg_type, is_critical)) {
+            backends[i]->WritePrioritisedBlock(pBuffer, size, is_critical);
+        }
+    }
+}
+
+void DataFlash_Class::set_msg_type_enabled(DataFlash_Backend_Type type, uint8_t msg_type, bool enabled)
+{
+    for (uint8_t i=0; i<_next_backend; i++) {
+        if (_backend_type[i] == type) {
+            backends[i]->set_msg_type_enabled(msg_type, enabled);
+        }
+    }
 }
 
 // change me to "DoTimeConsumingPreparations"?
@@ -145,6 +330,12 @@ int16_t DataFlash_Class::get_log_data(uint16_t log_num, uint16_t page, uint32_t
     }
     return backends[0]->get_log_data(log_num, page, offset, len, data);
 }
+void DataFlash_Class::end_log_data(void) {
+    if (_next_backend == 0) {
+        return;
+    }
+    backends[0]->end_log_data();
+}
 uint16_t DataFlash_Class::get_num_logs(void) {
     if (_next_backend == 0) {
         return 0;
@@ -207,6 +398,17 @@ void DataFlash_Class::remote_log_block_status_msg(mavlink_channel_t chan,
 
 void DataFlash_Class::periodic_tasks() {
      FOR_EACH_BACKEND(periodic_tasks());
+
+     uint32_t now = AP_HAL::millis();
+     if (now - _last_msg_filter_update_ms >= 1000) {
+         _last_msg_filter_update_ms = now;
+         msg_filters_update();
+     }
+     if (now - _last_perf_log_ms >= DATAFLASH_PERF_LOG_PERIOD_MS &&
+         logging_started()) {
+         _last_perf_log_ms = now;
+         Log_Write_Perf();
+     }
 }
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
@@ -216,6 +418,11 @@ void DataFlash_Class::flush(void) {
 }
 #endif
 
+void DataFlash_Class::blackbox_trigger(void)
+{
+    FOR_EACH_BACKEND(blackbox_trigger());
+}
+
 
 void DataFlash_Class::Log_Write_EntireMission(const AP_Mission &mission)
 {
@@ -274,7 +481,15 @@ void DataFlash_Class::Log_Write(const char *name, const char *labels, const char
         return;
     }
 
+    if (msg_type_bit_set(_msg_filter_types, f->msg_type) &&
+        !msg_filter_pass(f->msg_type, false)) {
+        return;
+    }
+
     for (uint8_t i=0; i<_next_backend; i++) {
+        if (!backends[i]->filter_message(f->msg_type, false)) {
+            continue;
+        }
         if (!(f->sent_mask & (1U<<i))) {
             if (!backends[i]->Log_Write_Emit_FMT(f->msg_type)) {
                 continue;
@@ -288,6 +503,34 @@ void DataFlash_Class::Log_Write(const char *name, const char *labels, const char
 }
 
 
+/*
+  log the HAL perf counters so latency tails can be looked at after a
+  flight. Times are in microseconds.
+ */
+void DataFlash_Class::Log_Write_Perf(void)
+{
+    static const char *name = "PRF";
+    AP_HAL::Util::perf_counter_stats stats;
+    uint64_t now = AP_HAL::micros64();
+
+    for (uint16_t i = 0; hal.util->perf_get_stats(i, stats); i++) {
+        // the N format is a fixed-size, not necessarily terminated, string
+        char counter_name[16] {};
+        strncpy(counter_name, stats.name, sizeof(counter_name));
+
+        Log_Write(name, "TimeUS,Name,Count,Min,Avg,P50,P99,P999,Max", "QNIIIIIII",
+                  now,
+                  counter_name,
+                  (uint32_t)stats.count,
+                  (uint32_t)(stats.min / 1000),
+                  (uint32_t)(stats.avg / 1000),
+                  (uint32_t)(stats.p50 / 1000),
+                  (uint32_t)(stats.p99 / 1000),
+                  (uint32_t)(stats.p999 / 1000),
+                  (uint32_t)(stats.max / 1000));
+    }
+}
+
 DataFlash_Class::log_write_fmt *DataFlash_Class::msg_fmt_for_name(const char *name, const char *labels, const char *fmt)
 {
     struct log_write_fmt *f;
@@ -322,8 +565,16 @@ DataFlash_Class::log_write_fmt *DataFlash_Class::msg_fmt_for_name(const char *na
     f->msg_len = tmp;
 
     // add to front of list
+    if (_log_write_fmts_sem != nullptr &&
+        !_log_write_fmts_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        free(f);
+        return nullptr;
+    }
     f->next = log_write_fmts;
     log_write_fmts = f;
+    if (_log_write_fmts_sem != nullptr) {
+        _log_write_fmts_sem->give();
+    }
 
     return f;
 }
@@ -363,6 +614,11 @@ int16_t DataFlash_Class::find_free_msg_type() const
 
 bool DataFlash_Class::fill_log_write_logstructure(struct LogStructure &logstruct, const uint8_t msg_type) const
 {
+    if (_log_write_fmts_sem != nullptr &&
+        !_log_write_fmts_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return false;
+    }
+
     // find log structure information corresponding to msg_type:
     struct log_write_fmt *f;
     for (f = log_write_fmts; f; f=f->next) {
@@ -371,52 +627,283 @@ bool DataFlash_Class::fill_log_write_logstructure(struct LogStructure &logstruct
         }
     }
 
-    if (!f) {
-        return false;
+    if (f) {
+        logstruct.msg_type = msg_type;
+        strncpy((char*)logstruct.name, f->name, sizeof(logstruct.name)); /* cast away the "const" (*gulp*) */
+        strncpy((char*)logstruct.format, f->fmt, sizeof(logstruct.format));
+        strncpy((char*)logstruct.labels, f->labels, sizeof(logstruct.labels));
+        logstruct.msg_len = f->msg_len;
     }
-
-    logstruct.msg_type = msg_type;
-    strncpy((char*)logstruct.name, f->name, sizeof(logstruct.name)); /* cast away the "const" (*gulp*) */
-    strncpy((char*)logstruct.format, f->fmt, sizeof(logstruct.format));
-    strncpy((char*)logstruct.labels, f->labels, sizeof(logstruct.labels));
-    logstruct.msg_len = f->msg_len;
-    return true;
+    if (_log_write_fmts_sem != nullptr) {
+        _log_write_fmts_sem->give();
+    }
+    return f != nullptr;
 }
 
 /* calculate the length of output of a format string.  Note that this
  * returns an int16_t; if it returns -1 then an error has occurred.
  * This was mechanically converted from init_field_types in
  * Tools/Replay/MsgHandler.cpp */
+/* the length of a field of a message from its format character, or
+ * -1 if the character is not a known format */
+static int8_t Log_Write_field_len(const char c)
+{
+    switch(c) {
+    case 'b' : return sizeof(int8_t);
+    case 'c' : return sizeof(int16_t);
+    case 'd' : return sizeof(double);
+    case 'e' : return sizeof(int32_t);
+    case 'f' : return sizeof(float);
+    case 'h' : return sizeof(int16_t);
+    case 'i' : return sizeof(int32_t);
+    case 'n' : return sizeof(char[4]);
+    case 'B' : return sizeof(uint8_t);
+    case 'C' : return sizeof(uint16_t);
+    case 'E' : return sizeof(uint32_t);
+    case 'H' : return sizeof(uint16_t);
+    case 'I' : return sizeof(uint32_t);
+    case 'L' : return sizeof(int32_t);
+    case 'M' : return sizeof(uint8_t);
+    case 'N' : return sizeof(char[16]);
+    case 'Z' : return sizeof(char[64]);
+    case 'q' : return sizeof(int64_t);
+    case 'Q' : return sizeof(uint64_t);
+    default: return -1;
+    }
+}
+
 int16_t DataFlash_Class::Log_Write_calc_msg_len(const char *fmt) const
 {
     uint8_t len =  LOG_PACKET_HEADER_LEN;
     for (uint8_t i=0; i<strlen(fmt); i++) {
-        switch(fmt[i]) {
-        case 'b' : len += sizeof(int8_t); break;
-        case 'c' : len += sizeof(int16_t); break;
-        case 'd' : len += sizeof(double); break;
-        case 'e' : len += sizeof(int32_t); break;
-        case 'f' : len += sizeof(float); break;
-        case 'h' : len += sizeof(int16_t); break;
-        case 'i' : len += sizeof(int32_t); break;
-        case 'n' : len += sizeof(char[4]); break;
-        case 'B' : len += sizeof(uint8_t); break;
-        case 'C' : len += sizeof(uint16_t); break;
-        case 'E' : len += sizeof(uint32_t); break;
-        case 'H' : len += sizeof(uint16_t); break;
-        case 'I' : len += sizeof(uint32_t); break;
-        case 'L' : len += sizeof(int32_t); break;
-        case 'M' : len += sizeof(uint8_t); break;
-        case 'N' : len += sizeof(char[16]); break;
-        case 'Z' : len += sizeof(char[64]); break;
-        case 'q' : len += sizeof(int64_t); break;
-        case 'Q' : len += sizeof(uint64_t); break;
-        default: return -1;
+        const int8_t field_len = Log_Write_field_len(fmt[i]);
+        if (field_len == -1) {
+            return -1;
         }
+        len += field_len;
     }
     return len;
 }
 
 /* End of Log_Write support */
 
+/*
+ * support for per message type decimation and field masks
+ */
+
+const struct LogStructure *DataFlash_Class::structure_for_msg_type(const uint8_t msg_type) const
+{
+    for (uint16_t i=0; i<_num_types; i++) {
+        if (structure(i)->msg_type == msg_type) {
+            return structure(i);
+        }
+    }
+    return nullptr;
+}
+
+// stop the message types selected by LOG_FILE_DROP and LOG_MAV_DROP
+// reaching their backend
+void DataFlash_Class::msg_drops_init(void)
+{
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        const int16_t msg_type = _params.filter_type[i];
+        if (msg_type <= 0 || msg_type > 255) {
+            continue;
+        }
+        if (_params.file_drop & (1U<<i)) {
+            set_msg_type_enabled(DATAFLASH_BACKEND_FILE, msg_type, false);
+        }
+        if (_params.mav_drop & (1U<<i)) {
+            set_msg_type_enabled(DATAFLASH_BACKEND_MAVLINK, msg_type, false);
+        }
+    }
+}
+
+void DataFlash_Class::msg_filters_update(void)
+{
+    memset(_msg_filter_types, 0, sizeof(_msg_filter_types));
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        struct msg_filter &f = _msg_filters[i];
+        const int16_t msg_type = _params.filter_type[i];
+        const int16_t rate = _params.filter_rate[i];
+        if (msg_type <= 0 || msg_type > 255 || rate == 0) {
+            f.msg_type = 0;
+            continue;
+        }
+        f.msg_type = msg_type;
+        f.disabled = (rate < 0);
+        f.interval_us = (rate > 0) ? 1000000UL / rate : 0;
+        _msg_filter_types[msg_type / 32] |= (1U << (msg_type % 32));
+    }
+}
+
+bool DataFlash_Class::msg_filter_pass(const uint8_t msg_type, const bool is_critical)
+{
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        struct msg_filter &f = _msg_filters[i];
+        if (f.msg_type != msg_type) {
+            continue;
+        }
+        if (f.disabled) {
+            return false;
+        }
+        if (is_critical) {
+            return true;
+        }
+        const uint32_t now = AP_HAL::micros();
+        const uint32_t elapsed = now - f.last_us;
+        if (elapsed < f.interval_us) {
+            return false;
+        }
+        // hold the configured rate when the caller's timing jitters,
+        // unless we have fallen a whole interval behind
+        f.last_us = (elapsed < 2 * f.interval_us) ? f.last_us + f.interval_us : now;
+        return true;
+    }
+    return true;
+}
+
+bool DataFlash_Class::msg_type_due(const uint8_t msg_type) const
+{
+    if (!msg_type_bit_set(_msg_filter_types, msg_type)) {
+        return true;
+    }
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        const struct msg_filter &f = _msg_filters[i];
+        if (f.msg_type == msg_type) {
+            return !f.disabled && AP_HAL::micros() - f.last_us >= f.interval_us;
+        }
+    }
+    return true;
+}
+
+bool DataFlash_Class::msg_type_any_due(const uint8_t *msg_types, const uint8_t count) const
+{
+    for (uint8_t i=0; i<count; i++) {
+        if (msg_type_due(msg_types[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  work out where the fields kept by field_mask are in a message laid
+  out as s describes, and the format and labels of the trimmed message
+ */
+bool DataFlash_Class::msg_trim_init(struct msg_trim &trim, const struct LogStructure &s, uint32_t field_mask) const
+{
+    // the first field, normally TimeUS, is always kept
+    field_mask |= 1;
+
+    memset(&trim, 0, sizeof(trim));
+    trim.msg_len = LOG_PACKET_HEADER_LEN;
+
+    uint8_t ofs = LOG_PACKET_HEADER_LEN;
+    uint8_t label = 0;
+    uint8_t labels_len = 0;
+    for (uint8_t i=0; i<sizeof(s.format) && s.format[i] != 0; i++) {
+        const int8_t field_len = Log_Write_field_len(s.format[i]);
+        if (field_len == -1) {
+            return false;
+        }
+        // labels are comma separated
+        uint8_t label_end = label;
+        while (label_end < sizeof(s.labels) && s.labels[label_end] != ',' && s.labels[label_end] != 0) {
+            label_end++;
+        }
+        if (field_mask & (1U << i)) {
+            trim.field_ofs[trim.num_fields] = ofs;
+            trim.field_len[trim.num_fields] = field_len;
+            trim.format[trim.num_fields] = s.format[i];
+            if (trim.num_fields != 0) {
+                trim.labels[labels_len++] = ',';
+            }
+            memcpy(&trim.labels[labels_len], &s.labels[label], label_end - label);
+            labels_len += label_end - label;
+            trim.msg_len += field_len;
+            trim.num_fields++;
+        }
+        ofs += field_len;
+        label = label_end + 1;
+    }
+    if (ofs != s.msg_len) {
+        // the format string does not match the structure
+        return false;
+    }
+    trim.full_len = s.msg_len;
+    trim.msg_type = s.msg_type;
+    return true;
+}
+
+void DataFlash_Class::msg_trims_update(void)
+{
+    bool changed = false;
+    memset(_msg_trim_types, 0, sizeof(_msg_trim_types));
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        const int16_t msg_type = _params.filter_type[i];
+        const struct LogStructure *s = nullptr;
+        if (msg_type > 0 && msg_type <= 255 && _params.filter_mask[i] != 0) {
+            // only messages with a LogStructure can be trimmed; Log_Write
+            // messages are serialised by the backends themselves
+            s = structure_for_msg_type(msg_type);
+        }
+        if (s == nullptr) {
+            if (_msg_trims[i] != nullptr && _msg_trims[i]->msg_type != 0) {
+                _msg_trims[i]->msg_type = 0;
+                changed = true;
+            }
+            continue;
+        }
+        if (_msg_trims[i] == nullptr) {
+            _msg_trims[i] = new msg_trim;
+            if (_msg_trims[i] == nullptr) {
+                continue;
+            }
+            memset(_msg_trims[i], 0, sizeof(*_msg_trims[i]));
+        }
+        struct msg_trim trim;
+        if (!msg_trim_init(trim, *s, _params.filter_mask[i])) {
+            if (_msg_trims[i]->msg_type != 0) {
+                _msg_trims[i]->msg_type = 0;
+                changed = true;
+            }
+            internal_error();
+            continue;
+        }
+        if (memcmp(&trim, _msg_trims[i], sizeof(trim)) != 0) {
+            *_msg_trims[i] = trim;
+            changed = true;
+        }
+        _msg_trim_types[msg_type / 32] |= (1U << (msg_type % 32));
+    }
+    if (changed) {
+        _msg_trims_generation++;
+    }
+}
+
+const struct DataFlash_Class::msg_trim *DataFlash_Class::msg_trim_for_type(const uint8_t msg_type) const
+{
+    if (!msg_type_bit_set(_msg_trim_types, msg_type)) {
+        return nullptr;
+    }
+    for (uint8_t i=0; i<DATAFLASH_MSG_FILTERS; i++) {
+        if (_msg_trims[i] != nullptr && _msg_trims[i]->msg_type == msg_type) {
+            return _msg_trims[i];
+        }
+    }
+    return nullptr;
+}
+
+void DataFlash_Class::msg_trim_fill_format(struct log_Format &pkt) const
+{
+    const struct msg_trim *trim = msg_trim_for_type(pkt.type);
+    if (trim == nullptr) {
+        return;
+    }
+    pkt.length = trim->msg_len;
+    strncpy(pkt.format, trim->format, sizeof(pkt.format));
+    strncpy(pkt.labels, trim->labels, sizeof(pkt.labels));
+}
+
 #undef FOR_EACH_BACKEND
@@ -32,13 +32,19 @@
 
 class DataFlash_Backend;
 
+// bits of LOG_BACKEND_TYPE
 enum DataFlash_Backend_Type {
     DATAFLASH_BACKEND_NONE = 0,
     DATAFLASH_BACKEND_FILE = 1,
     DATAFLASH_BACKEND_MAVLINK = 2,
     DATAFLASH_BACKEND_BOTH = 3,
+    DATAFLASH_BACKEND_BLACKBOX = 4,
 };
 
+// number of LOG_FLTn_ parameter sets, each decimating or trimming one
+// message type
+#define DATAFLASH_MSG_FILTERS 4
+
 // fwd declarations to avoid include errors
 class AC_AttitudeControl;
 class AC_PosControl;
@@ -46,6 +52,7 @@ class AC_PosControl;
 class DataFlash_Class
 {
     friend class DataFlash_Backend; // for _num_types
+    friend class DataFlash_Class_Benchmark; // for installing a backend
 
 public:
     FUNCTOR_TYPEDEF(print_mode_fn, void, AP_HAL::BetterStream*, uint8_t);
@@ -96,6 +103,7 @@ public:
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
     int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data);
     uint16_t get_num_logs(void);
+    void end_log_data(void);
     void LogReadProcess(uint16_t log_num,
                                 uint16_t start_page, uint16_t end_page, 
                                 print_mode_fn printMode,
@@ -111,10 +119,26 @@ public:
 
     void StopLogging();
 
+    // stop or resume sending one message type to the backends of a
+    // type, e.g. to keep full rate sensor data off a MAVLink backend
+    void set_msg_type_enabled(DataFlash_Backend_Type type, uint8_t msg_type, bool enabled);
+
+    // false if a msg_type message written now would be dropped by its
+    // LOG_FLTn_RATE, so the caller can skip building it
+    bool msg_type_due(uint8_t msg_type) const;
+    // true if any of a group of message types built together is due
+    bool msg_type_any_due(const uint8_t *msg_types, uint8_t count) const;
+
+    // changes whenever a new log changes the layout of a trimmed
+    // message type, so backends holding messages across logs can tell
+    // the FMT messages they would write no longer describe them
+    uint16_t msg_trims_generation() const { return _msg_trims_generation; }
+
     void Log_Write_Parameter(const char *name, float value);
     void Log_Write_GPS(const AP_GPS &gps, uint8_t instance, uint64_t time_us=0);
     void Log_Write_RFND(const RangeFinder &rangefinder);
     void Log_Write_IMU(const AP_InertialSensor &ins);
+    void Log_Write_IMU_instance(const AP_InertialSensor &ins, uint64_t time_us, uint8_t imu_instance, enum LogMessages type);
     void Log_Write_IMUDT(const AP_InertialSensor &ins, uint64_t time_us, uint8_t imu_mask);
     void Log_Write_Vibration(const AP_InertialSensor &ins);
     void Log_Write_RCIN(void);
@@ -154,6 +178,9 @@ public:
 
     void Log_Write(const char *name, const char *labels, const char *fmt, ...);
 
+    // write one PRF message per HAL perf counter
+    void Log_Write_Perf(void);
+
     // This structure provides information on the internal member data of a PID for logging purposes
     struct PID_Info {
         float desired;
@@ -173,6 +200,10 @@ public:
     void flush(void);
 #endif
 
+    // write the black box ring out to the card, e.g. on a crash. Safe
+    // to call from any thread
+    void blackbox_trigger(void);
+
     // for DataFlash_MAVLink:
     void remote_log_block_status_msg(mavlink_channel_t chan,
                                      mavlink_message_t* msg);
@@ -196,6 +227,15 @@ public:
         AP_Int8 file_bufsize; // in kilobytes
         AP_Int8 log_disarmed;
         AP_Int8 log_replay;
+        AP_Int8 file_sync;
+        AP_Int16 file_rate_max;
+        AP_Int16 mav_rate_max;
+        AP_Int16 bbox_size; // in kilobytes
+        AP_Int16 filter_type[DATAFLASH_MSG_FILTERS];
+        AP_Int16 filter_rate[DATAFLASH_MSG_FILTERS];
+        AP_Int32 filter_mask[DATAFLASH_MSG_FILTERS];
+        AP_Int8 file_drop;
+        AP_Int8 mav_drop;
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
@@ -219,13 +259,63 @@ protected:
                                bool is_critical);
 
 private:
-    #define DATAFLASH_MAX_BACKENDS 2
+    #define DATAFLASH_MAX_BACKENDS 4
     uint8_t _next_backend;
     DataFlash_Backend *backends[DATAFLASH_MAX_BACKENDS];
+    DataFlash_Backend_Type _backend_type[DATAFLASH_MAX_BACKENDS];
     const char *_firmware_string;
 
+    uint32_t _last_perf_log_ms = 0;
+
     void internal_error() const;
 
+    /*
+      per message type decimation, from the LOG_FLTn_TYPE and
+      LOG_FLTn_RATE parameters. These are re-read once a second so
+      they can be changed in flight
+     */
+    struct msg_filter {
+        uint8_t msg_type;
+        bool disabled;
+        uint32_t interval_us;
+        uint32_t last_us;
+    } _msg_filters[DATAFLASH_MSG_FILTERS];
+    // one bit per message type with a filter
+    uint32_t _msg_filter_types[8];
+    uint32_t _last_msg_filter_update_ms;
+
+    /*
+      the fields kept of message types with a LOG_FLTn_MASK. These are
+      only re-read when a log is started, as the FMT messages at the
+      start of the log describe the trimmed messages
+     */
+    struct msg_trim {
+        uint8_t msg_type;
+        uint8_t full_len;
+        uint8_t msg_len;
+        uint8_t num_fields;
+        uint8_t field_ofs[16];
+        uint8_t field_len[16];
+        char format[16];
+        char labels[64];
+    } *_msg_trims[DATAFLASH_MSG_FILTERS];
+    // one bit per message type with a trim
+    uint32_t _msg_trim_types[8];
+    volatile uint16_t _msg_trims_generation;
+
+    void msg_drops_init(void);
+    void msg_filters_update(void);
+    void msg_trims_update(void);
+    bool msg_trim_init(struct msg_trim &trim, const struct LogStructure &s, uint32_t field_mask) const;
+    const struct msg_trim *msg_trim_for_type(uint8_t msg_type) const;
+    // returns true if a msg_type message should be written now
+    bool msg_filter_pass(uint8_t msg_type, bool is_critical);
+    // describe a trimmed message type in its FMT message
+    void msg_trim_fill_format(struct log_Format &pkt) const;
+    const struct LogStructure *structure_for_msg_type(uint8_t msg_type) const;
+
+    void WriteBackendsBlock(const void *pBuffer, uint16_t size, uint8_t msg_type, bool is_critical);
+
     /*
      * support for dynamic Log_Write; user-supplies name, format,
      * labels and values in a single function call.
@@ -243,6 +333,9 @@ private:
         const char *fmt;
         const char *labels;
     } *log_write_fmts;
+    // held while adding to log_write_fmts, and by fill_log_write_logstructure(),
+    // which the black box IO thread calls while the main thread may be adding
+    AP_HAL::Semaphore *_log_write_fmts_sem = nullptr;
 
     // return (possibly allocating) a log_write_fmt for a name
     struct log_write_fmt *msg_fmt_for_name(const char *name, const char *labels, const char *fmt);
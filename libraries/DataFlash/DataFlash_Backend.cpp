@@ -66,6 +66,47 @@ void DataFlash_Backend::set_mission(const AP_Mission *mission) {
     _startup_messagewriter->set_mission(mission);
 }
 
+void DataFlash_Backend::set_msg_type_enabled(const uint8_t msg_type, const bool enabled)
+{
+    if (enabled) {
+        _msg_type_disabled[msg_type / 32] &= ~(1U << (msg_type % 32));
+    } else {
+        _msg_type_disabled[msg_type / 32] |= (1U << (msg_type % 32));
+    }
+}
+
+void DataFlash_Backend::set_rate_max(const uint16_t rate_max_hz)
+{
+    if (rate_max_hz == 0 || rate_max_hz >= 1000) {
+        _rate_min_interval_ms = 0;
+        return;
+    }
+    if (_msg_type_last_ms == nullptr) {
+        _msg_type_last_ms = new uint16_t[256]();
+        if (_msg_type_last_ms == nullptr) {
+            return;
+        }
+    }
+    _rate_min_interval_ms = 1000 / rate_max_hz;
+}
+
+bool DataFlash_Backend::filter_message(const uint8_t msg_type, const bool is_critical)
+{
+    if (_msg_type_disabled[msg_type / 32] & (1U << (msg_type % 32))) {
+        return false;
+    }
+    if (_rate_min_interval_ms == 0 || is_critical) {
+        return true;
+    }
+    // 16 bit times are fine for intervals of up to a second
+    const uint16_t now = AP_HAL::millis();
+    if ((uint16_t)(now - _msg_type_last_ms[msg_type]) < _rate_min_interval_ms) {
+        return false;
+    }
+    _msg_type_last_ms[msg_type] = now;
+    return true;
+}
+
 // this method can be overridden to do extra things with your buffer.
 // for example, in DataFlash_MAVLink we may push messages into the UART.
 void DataFlash_Backend::push_log_blocks() {
@@ -37,12 +37,26 @@ public:
 
     virtual bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) = 0;
 
+    /*
+      message filtering, applied by the frontend before a message is
+      buffered or serialised for this backend, so filtered messages cost
+      the backend nothing. Message types can be disabled, and each type
+      is separately decimated to at most rate_max_hz. Critical messages
+      are never decimated
+     */
+    void set_msg_type_enabled(uint8_t msg_type, bool enabled);
+    void set_rate_max(uint16_t rate_max_hz);
+    // returns true if the message should be written to this backend
+    bool filter_message(uint8_t msg_type, bool is_critical);
+
     // high level interface
     virtual uint16_t find_last_log() = 0;
     virtual void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page) = 0;
     virtual void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc) = 0;
     virtual int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) = 0;
     virtual uint16_t get_num_logs() = 0;
+    // a log download has finished, release anything kept for it
+    virtual void end_log_data(void) { }
     virtual void LogReadProcess(const uint16_t list_entry,
                                 uint16_t start_page, uint16_t end_page,
                                 print_mode_fn printMode,
@@ -74,12 +88,18 @@ public:
     virtual void stop_logging(void) = 0;
 
     void Log_Fill_Format(const struct LogStructure *structure, struct log_Format &pkt);
+    // fill pkt with the FMT message for msg_type, from either the
+    // vehicle's structures or the Log_Write formats
+    bool Log_Fill_Format_For_Type(uint8_t msg_type, struct log_Format &pkt);
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // currently only DataFlash_File support this:
     virtual void flush(void) { }
 #endif
 
+    // for DataFlash_BlackBox
+    virtual void blackbox_trigger() { }
+
      // for Dataflash_MAVlink
     virtual void remote_log_block_status_msg(mavlink_channel_t chan,
                                              mavlink_message_t* msg) { }
@@ -162,4 +182,11 @@ private:
 
     uint32_t _last_periodic_1Hz;
     uint32_t _last_periodic_10Hz;
+
+    // one bit per message type
+    uint32_t _msg_type_disabled[8] {};
+    uint16_t _rate_min_interval_ms = 0;
+    // time each message type was last written, only allocated once a
+    // rate limit is set
+    uint16_t *_msg_type_last_ms = nullptr;
 };
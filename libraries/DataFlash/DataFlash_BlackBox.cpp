@@ -0,0 +1,341 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+   DataFlash logging - crash "black box" variant
+
+   The ring holds every message the other backends are sent, so it
+   covers the last few seconds of flight at the full logging rate even
+   when the SD card writer has fallen behind or stalled. Nothing touches
+   the card until a trigger, and then only from the IO thread.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+
+#if HAL_OS_POSIX_IO
+#include "DataFlash_BlackBox.h"
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+extern const AP_HAL::HAL& hal;
+
+/*
+  constructor
+ */
+DataFlash_BlackBox::DataFlash_BlackBox(DataFlash_Class &front,
+                                       DFMessageWriter_DFLogStart *writer,
+                                       const char *log_directory) :
+    DataFlash_Backend(front, writer),
+    _log_directory(log_directory),
+    _initialised(false),
+    _ring(nullptr),
+    _sem(nullptr),
+    _msg_type_seen{},
+    _ring_trims_generation(0),
+    _frozen(false),
+    _flush_fd(-1),
+    _flush_buf(nullptr),
+    _perf_flush(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_bbox_flush"))
+{}
+
+// initialisation
+void DataFlash_BlackBox::Init()
+{
+    DataFlash_Backend::Init();
+
+    _sem = hal.util->new_semaphore();
+    if (_sem == nullptr) {
+        AP_HAL::panic("Failed to create DataFlash_BlackBox semaphore");
+        return;
+    }
+
+    const char* custom_dir = hal.util->get_custom_log_directory();
+    if (custom_dir != NULL){
+        _log_directory = custom_dir;
+    }
+
+    _flush_buf = (uint8_t *)malloc(DATAFLASH_BLACKBOX_FLUSH_CHUNK);
+    if (_flush_buf == nullptr) {
+        hal.console->printf("Out of memory for black box\n");
+        return;
+    }
+
+    /*
+      if we can't allocate the full ring then try reducing it until we
+      can allocate it
+     */
+    int16_t size_kb = _front._params.bbox_size;
+    if (size_kb < 4) {
+        size_kb = 4;
+    }
+    uint32_t size = size_kb * 1024UL;
+    _ring = new ByteBuffer(0);
+    if (_ring == nullptr) {
+        hal.console->printf("Out of memory for black box\n");
+        return;
+    }
+    while (size >= DATAFLASH_BLACKBOX_FLUSH_CHUNK && !_ring->set_size(size)) {
+        size /= 2;
+    }
+    if (_ring->get_size() == 0) {
+        hal.console->printf("Out of memory for black box\n");
+        return;
+    }
+    hal.console->printf("DataFlash_BlackBox: ring size=%u\n", (unsigned)_ring->get_size());
+
+    _ring_trims_generation = _front.msg_trims_generation();
+    _initialised = true;
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&DataFlash_BlackBox::_io_timer, void));
+}
+
+/*
+  the black box records whenever the other backends are logging
+ */
+uint16_t DataFlash_BlackBox::start_new_log(void)
+{
+    log_write_started = true;
+    return 0;
+}
+
+void DataFlash_BlackBox::stop_logging(void)
+{
+    log_write_started = false;
+}
+
+uint16_t DataFlash_BlackBox::bufferspace_available()
+{
+    // old records are dropped to make room, so there is always space
+    // for one message unless we are frozen
+    if (!_initialised || _frozen) {
+        return 0;
+    }
+    return UINT8_MAX;
+}
+
+/* Write a block of data at current offset */
+bool DataFlash_BlackBox::WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (!_initialised || !_writes_enabled || !log_write_started || size > UINT8_MAX) {
+        return false;
+    }
+
+    if (!_sem->take_nonblocking()) {
+        // the IO thread is writing the ring out
+        _dropped++;
+        return false;
+    }
+
+    if (_frozen) {
+        // keep the messages leading up to the trigger
+        _sem->give();
+        return false;
+    }
+
+    const uint16_t trims_generation = _front.msg_trims_generation();
+    if (trims_generation != _ring_trims_generation) {
+        // a new log changed the fields kept of some message type
+        _ring->clear();
+        memset(_msg_type_seen, 0, sizeof(_msg_type_seen));
+        _ring_trims_generation = trims_generation;
+    }
+
+    // make room by dropping the oldest records
+    while (_ring->space() < size + 1U) {
+        int16_t len = _ring->peek(0);
+        if (len < 0) {
+            break;
+        }
+        _ring->advance(len + 1);
+    }
+
+    const uint8_t len = size;
+    _ring->write(&len, 1);
+    _ring->write((const uint8_t *)pBuffer, size);
+
+    const uint8_t msg_type = ((const uint8_t *)pBuffer)[2];
+    _msg_type_seen[msg_type / 32] |= (1U << (msg_type % 32));
+
+    _sem->give();
+    return true;
+}
+
+void DataFlash_BlackBox::blackbox_trigger()
+{
+    if (!_initialised) {
+        return;
+    }
+    _frozen = true;
+}
+
+bool DataFlash_BlackBox::_flush_write(const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0) {
+        ssize_t nwritten = ::write(_flush_fd, p, len);
+        if (nwritten <= 0) {
+            return false;
+        }
+        p += nwritten;
+        len -= nwritten;
+    }
+    return true;
+}
+
+/*
+  open the first unused BBOXn.BIN. The name does not start with a
+  digit, so DataFlash_File leaves these files out of the log list and
+  never removes them
+ */
+bool DataFlash_BlackBox::_flush_start(void)
+{
+    const size_t len = strlen(_log_directory) + 16;
+    char *fname = (char *)malloc(len);
+    if (fname == nullptr) {
+        return false;
+    }
+    for (uint8_t n=1; n<=DATAFLASH_BLACKBOX_MAX_FILES; n++) {
+        snprintf(fname, len, "%s/BBOX%u.BIN", _log_directory, (unsigned)n);
+        struct stat st;
+        if (::stat(fname, &st) == -1) {
+            break;
+        }
+    }
+    _flush_fd = ::open(fname, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (_flush_fd == -1) {
+        hal.console->printf("Black box open fail for %s - %s\n",
+                            fname, strerror(errno));
+    } else {
+        hal.console->printf("Writing black box to %s\n", fname);
+    }
+    free(fname);
+    return _flush_fd != -1;
+}
+
+/*
+  write the FMT messages for every type in the ring; the FMT messages
+  written when logging started are long gone from it
+ */
+bool DataFlash_BlackBox::_flush_formats(void)
+{
+    uint32_t n = 0;
+    struct log_Format pkt;
+    if (Log_Fill_Format_For_Type(LOG_FORMAT_MSG, pkt)) {
+        memcpy(&_flush_buf[n], &pkt, sizeof(pkt));
+        n += sizeof(pkt);
+    }
+    for (uint16_t msg_type=0; msg_type<256; msg_type++) {
+        if (msg_type == LOG_FORMAT_MSG ||
+            !(_msg_type_seen[msg_type / 32] & (1U << (msg_type % 32)))) {
+            continue;
+        }
+        if (!Log_Fill_Format_For_Type(msg_type, pkt)) {
+            continue;
+        }
+        if (n + sizeof(pkt) > DATAFLASH_BLACKBOX_FLUSH_CHUNK) {
+            if (!_flush_write(_flush_buf, n)) {
+                return false;
+            }
+            n = 0;
+        }
+        memcpy(&_flush_buf[n], &pkt, sizeof(pkt));
+        n += sizeof(pkt);
+    }
+    return _flush_write(_flush_buf, n);
+}
+
+/*
+  copy whole records out of the ring, without their length bytes, and
+  write them to the file. done is set once the ring is empty
+ */
+bool DataFlash_BlackBox::_flush_records(bool &done)
+{
+    done = false;
+    for (uint8_t i=0; i<DATAFLASH_BLACKBOX_FLUSH_CHUNKS_PER_TICK && !done; i++) {
+        uint32_t n = 0;
+        _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
+        while (true) {
+            int16_t len = _ring->peek(0);
+            if (len < 0) {
+                done = true;
+                break;
+            }
+            if (n + len > DATAFLASH_BLACKBOX_FLUSH_CHUNK) {
+                break;
+            }
+            _ring->advance(1);
+            _ring->read(&_flush_buf[n], len);
+            n += len;
+        }
+        _sem->give();
+        if (n > 0 && !_flush_write(_flush_buf, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DataFlash_BlackBox::_flush_finish(bool ok)
+{
+    if (_flush_fd != -1) {
+        if (ok && ::fsync(_flush_fd) != 0) {
+            ok = false;
+        }
+        ::close(_flush_fd);
+        _flush_fd = -1;
+    }
+    hal.util->perf_end(_perf_flush);
+    hal.console->printf("Black box %s\n", ok ? "written" : "write failed");
+
+    // start recording again, so a later event is caught too
+    _sem->take(HAL_SEMAPHORE_BLOCK_FOREVER);
+    _ring->clear();
+    memset(_msg_type_seen, 0, sizeof(_msg_type_seen));
+    _frozen = false;
+    _sem->give();
+}
+
+/*
+  runs on the IO thread. Once triggered, the file is opened and the
+  formats written on one tick, then the records are written a few
+  chunks per tick so the File backend's writer still gets its turn
+ */
+void DataFlash_BlackBox::_io_timer(void)
+{
+    if (!_frozen) {
+        return;
+    }
+
+    if (_flush_fd == -1) {
+        hal.util->perf_begin(_perf_flush);
+        if (_front.msg_trims_generation() != _ring_trims_generation) {
+            // a new log has changed the layout of messages in the
+            // ring since it was frozen; there are no FMT messages
+            // that describe them any more
+            hal.console->printf("Black box dropped, log format changed\n");
+            _flush_finish(false);
+            return;
+        }
+        if (!_flush_start() || !_flush_formats() ||
+            _front.msg_trims_generation() != _ring_trims_generation) {
+            _flush_finish(false);
+        }
+        return;
+    }
+
+    bool done;
+    if (!_flush_records(done)) {
+        _flush_finish(false);
+    } else if (done) {
+        _flush_finish(true);
+    }
+}
+
+#endif // HAL_OS_POSIX_IO
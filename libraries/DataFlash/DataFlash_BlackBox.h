@@ -0,0 +1,116 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+   DataFlash logging - crash "black box" variant
+
+   - keeps the most recent log messages in a RAM ring, dropping the
+     oldest as new ones arrive
+   - on blackbox_trigger() the ring is frozen, and the IO thread writes
+     it out to BBOXn.BIN in the log directory, preceded by the FMT
+     messages needed to read it
+ */
+#pragma once
+
+#if HAL_OS_POSIX_IO
+
+#include "DataFlash_Backend.h"
+
+// largest block written to the black box file by the IO thread at a time
+#define DATAFLASH_BLACKBOX_FLUSH_CHUNK 4096
+// how many of those blocks are written on each IO thread tick
+#define DATAFLASH_BLACKBOX_FLUSH_CHUNKS_PER_TICK 4
+// black box files are numbered from 1 up to this, after which the
+// highest number is reused
+#define DATAFLASH_BLACKBOX_MAX_FILES 99
+
+class ByteBuffer;
+
+class DataFlash_BlackBox : public DataFlash_Backend
+{
+public:
+    // constructor
+    DataFlash_BlackBox(DataFlash_Class &front,
+                       DFMessageWriter_DFLogStart *writer,
+                       const char *log_directory);
+
+    // initialisation
+    void Init() override;
+    bool CardInserted(void) override { return _initialised; }
+
+    // erase handling
+    void EraseAll() override {}
+
+    bool NeedPrep() override { return false; }
+    void Prep() override { }
+
+    /* Write a block of data at current offset */
+    bool WritePrioritisedBlock(const void *pBuffer, uint16_t size,
+                               bool is_critical) override;
+    uint16_t bufferspace_available() override;
+
+    // freeze the ring and have the IO thread write it out. Safe to call
+    // from any thread
+    void blackbox_trigger() override;
+
+    // high level interface; the black box files are not part of the
+    // log list
+    uint16_t find_last_log(void) override { return 0; }
+    void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page) override {}
+    void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc) override {}
+    int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override { return 0; }
+    uint16_t get_num_logs(void) override { return 0; }
+
+    void LogReadProcess(uint16_t log_num,
+                        uint16_t start_page, uint16_t end_page,
+                        print_mode_fn printMode,
+                        AP_HAL::BetterStream *port) override {}
+    void DumpPageInfo(AP_HAL::BetterStream *port) override {}
+    void ShowDeviceInfo(AP_HAL::BetterStream *port) override {}
+    void ListAvailableLogs(AP_HAL::BetterStream *port) override {}
+
+    uint16_t start_new_log(void) override;
+    void stop_logging(void) override;
+
+    // these methods are used when reporting system status over mavlink
+    bool logging_enabled() const override { return _initialised; }
+    bool logging_failed() const override { return !_initialised; }
+
+protected:
+    bool ReadBlock(void *pkt, uint16_t size) override { return false; }
+
+private:
+    const char *_log_directory;
+    bool _initialised;
+
+    // each record in the ring is a length byte followed by the message
+    ByteBuffer *_ring;
+    AP_HAL::Semaphore *_sem;
+
+    // message types that have been written to the ring, so only their
+    // FMT messages need to go into the black box file
+    uint32_t _msg_type_seen[8];
+    // the frontend's msg_trims_generation() when the records in the
+    // ring were written. The FMT messages written on a flush describe
+    // the current layout, so older records are dropped
+    uint16_t _ring_trims_generation;
+
+    // set by blackbox_trigger(), cleared by the IO thread once the
+    // ring has been written out
+    volatile bool _frozen;
+
+    // black box file being written by the IO thread, and the
+    // staging buffer the ring is copied through
+    int _flush_fd;
+    uint8_t *_flush_buf;
+
+    void _io_timer(void);
+    bool _flush_start(void);
+    bool _flush_formats(void);
+    bool _flush_records(bool &done);
+    void _flush_finish(bool ok);
+    bool _flush_write(const void *data, uint32_t len);
+
+    AP_HAL::Util::perf_counter_t _perf_flush;
+};
+
+#endif // HAL_OS_POSIX_IO
@@ -59,7 +59,28 @@ DataFlash_File::DataFlash_File(DataFlash_Class &front,
     _initialised(false),
     _open_error(false),
     _log_directory(log_directory),
-    _cached_oldest_log(0),
+    _log_index(nullptr),
+    _log_index_count(0),
+    _log_index_space(0),
+    _log_index_valid(false),
+    _log_index_sem(nullptr),
+    _last_log_num(0),
+    _reclaim_count(0),
+    _reclaim_removing(0),
+    _reclaim_requested(false),
+    _reclaim_last_check_ms(0),
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    _prealloc_end(0),
+    _prealloc_failed(false),
+    _prealloc_unsupported(false),
+    _streaming(false),
+    _writeback_offset(0),
+#endif
+    _readahead(nullptr),
+    _readahead_ofs(0),
+    _readahead_active(false),
+    _readahead_eof(false),
+    _read_sem(nullptr),
     _writebuf(NULL),
 #if defined(CONFIG_ARCH_BOARD_PX4FMU_V1)
     // V1 gets IO errors with larger than 512 byte writes
@@ -85,7 +106,11 @@ DataFlash_File::DataFlash_File(DataFlash_Class &front,
     _perf_write(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_write")),
     _perf_fsync(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_fsync")),
     _perf_errors(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_errors")),
-    _perf_overruns(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_overruns"))
+    _perf_overruns(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_overruns")),
+    _perf_readahead_miss(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_readahead_miss"))
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    , _perf_sync_range(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_sync_range"))
+#endif
 {}
 
 
@@ -102,6 +127,16 @@ void DataFlash_File::Init()
         AP_HAL::panic("Failed to create DataFlash_File semaphore");
         return;
     }
+    _read_sem = hal.util->new_semaphore();
+    if (_read_sem == nullptr) {
+        AP_HAL::panic("Failed to create DataFlash_File read semaphore");
+        return;
+    }
+    _log_index_sem = hal.util->new_semaphore();
+    if (_log_index_sem == nullptr) {
+        AP_HAL::panic("Failed to create DataFlash_File log index semaphore");
+        return;
+    }
     
 #if CONFIG_HAL_BOARD == HAL_BOARD_PX4 || CONFIG_HAL_BOARD == HAL_BOARD_VRBRAIN
     // try to cope with an existing lowercase log directory
@@ -148,6 +183,10 @@ void DataFlash_File::Init()
     }
     _writebuf_size = bufsize * 1024;
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    _streaming = (_front._params.file_sync == 1);
+#endif
+
     /*
       if we can't allocate the full writebuf then try reducing it
       until we can allocate it
@@ -164,6 +203,8 @@ void DataFlash_File::Init()
         return;        
     }
     _writebuf_head = _writebuf_tail = 0;
+    // the IO thread is not running yet, so no need for the lock
+    _log_index_build();
     _initialised = true;
     hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&DataFlash_File::_io_timer, void));
 }
@@ -268,34 +309,55 @@ float DataFlash_File::avail_space_percent()
     return (avail/(float)space) * 100;
 }
 
-// find_oldest_log - find oldest log in _log_directory
-// returns 0 if no log was found
-uint16_t DataFlash_File::find_oldest_log()
+/*
+  take the log index lock, building the index on first use
+ */
+bool DataFlash_File::_log_index_lock(void)
 {
-#if DATAFLASH_FILE_MINIMAL
-    return 0;
-#else
-    if (_cached_oldest_log != 0) {
-        return _cached_oldest_log;
+    if (_log_index_sem == nullptr || !_log_index_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return false;
+    }
+    if (!_log_index_valid) {
+        _log_index_build();
     }
+    return true;
+}
 
-    uint16_t last_log_num = find_last_log();
-    if (last_log_num == 0) {
-        return 0;
+/*
+  position of a log in age order; the log after the newest one is the
+  oldest, and the newest is MAX_LOG_FILES
+ */
+uint16_t DataFlash_File::_log_index_age(const uint16_t log_num) const
+{
+    if (log_num > _last_log_num) {
+        return log_num - _last_log_num;
     }
+    return log_num + MAX_LOG_FILES - _last_log_num;
+}
 
-    uint16_t current_oldest_log = 0; // 0 is invalid
+/*
+  build the log index from a single scan of the log directory
+ */
+void DataFlash_File::_log_index_build(void)
+{
+    _log_index_count = 0;
+    _last_log_num = _read_lastlog();
+    _log_index_valid = true;
 
-    // We could count up to find_last_log(), but if people start
-    // relying on the min_avail_space_percent feature we could end up
-    // doing a *lot* of asprintf()s and stat()s
+#if DATAFLASH_FILE_MINIMAL
+    // no readdir() here. Log numbers run consecutively back from the
+    // newest log, so probe for them
+    uint16_t log_num = _last_log_num;
+    for (uint16_t i=0; i<MAX_LOG_FILES && log_num != 0 && log_exists(log_num); i++) {
+        _log_index_add(log_num, _get_log_size(log_num), _get_log_time(log_num));
+        log_num = (log_num == 1) ? MAX_LOG_FILES : log_num - 1;
+    }
+#else
     DIR *d = opendir(_log_directory);
     if (d == NULL) {
-        // internal_error();
-        return 0;
+        return;
     }
 
-    // we only remove files which look like xxx.BIN
     for (struct dirent *de=readdir(d); de; de=readdir(d)) {
         uint8_t length = strlen(de->d_name);
         if (length < 5) {
@@ -308,104 +370,212 @@ uint16_t DataFlash_File::find_oldest_log()
         }
 
         uint16_t thisnum = strtoul(de->d_name, NULL, 10);
-        if (thisnum > MAX_LOG_FILES) {
+        if (thisnum == 0 || thisnum > MAX_LOG_FILES) {
             // ignore files above our official maximum...
             continue;
         }
-        if (current_oldest_log == 0) {
-            current_oldest_log = thisnum;
-        } else {
-            if (current_oldest_log <= last_log_num) {
-                if (thisnum > last_log_num) {
-                    current_oldest_log = thisnum;
-                } else if (thisnum < current_oldest_log) {
-                    current_oldest_log = thisnum;
-                }
-            } else { // current_oldest_log > last_log_num
-                if (thisnum > last_log_num) {
-                    if (thisnum < current_oldest_log) {
-                        current_oldest_log = thisnum;
-                    }
-                }
-            }
+        char *fname = _log_file_name(thisnum);
+        if (fname == NULL) {
+            continue;
         }
+        struct stat st;
+        if (::stat(fname, &st) == 0) {
+            _log_index_add(thisnum, st.st_size, st.st_mtime);
+        }
+        free(fname);
     }
     closedir(d);
-    _cached_oldest_log = current_oldest_log;
-
-    return current_oldest_log;
 #endif
 }
 
-#if !DATAFLASH_FILE_MINIMAL
-void DataFlash_File::Prep_MinSpace()
+/*
+  add a log to the index, keeping it in age order
+ */
+void DataFlash_File::_log_index_add(const uint16_t log_num, const uint32_t size, const uint32_t time_utc)
 {
-    const uint16_t first_log_to_remove = find_oldest_log();
-    if (first_log_to_remove == 0) {
-        // no files to remove
-        return;
+    if (_log_index_count == _log_index_space) {
+        const uint16_t new_space = _log_index_space + 32;
+        struct log_index_entry *new_index = (struct log_index_entry *)realloc(_log_index, new_space * sizeof(_log_index[0]));
+        if (new_index == nullptr) {
+            hal.console->printf("Out of memory for log index\n");
+            return;
+        }
+        _log_index = new_index;
+        _log_index_space = new_space;
     }
 
-    _cached_oldest_log = 0;
+    // new logs are almost always the newest, so search from the end
+    const uint16_t age = _log_index_age(log_num);
+    uint16_t i = _log_index_count;
+    while (i > 0 && _log_index_age(_log_index[i-1].log_num) > age) {
+        _log_index[i] = _log_index[i-1];
+        i--;
+    }
+    _log_index[i].log_num = log_num;
+    _log_index[i].size = size;
+    _log_index[i].time_utc = time_utc;
+    _log_index_count++;
+}
 
-    uint16_t log_to_remove = first_log_to_remove;
+/*
+  remove a log from the index
+ */
+void DataFlash_File::_log_index_remove(const uint16_t log_num)
+{
+    for (uint16_t i=0; i<_log_index_count; i++) {
+        if (_log_index[i].log_num == log_num) {
+            _log_index_count--;
+            memmove(&_log_index[i], &_log_index[i+1], (_log_index_count - i) * sizeof(_log_index[0]));
+            return;
+        }
+    }
+}
 
-    uint16_t count = 0;
-    do {
-        float avail = avail_space_percent();
-        if (is_equal(avail, -1.0f)) {
-            // internal_error()
-            break;
+/*
+  update an index entry from the filesystem
+ */
+void DataFlash_File::_log_index_refresh(struct log_index_entry &entry) const
+{
+    entry.size = _get_log_size(entry.log_num);
+    entry.time_utc = _get_log_time(entry.log_num);
+}
+
+/*
+  copy out the index entry for a list entry. Returns false if there is
+  no such entry. The newest log may still be being written, so its size
+  and time are refreshed from the filesystem
+ */
+bool DataFlash_File::_log_index_lookup(const uint16_t list_entry, struct log_index_entry &entry)
+{
+    if (!_log_index_lock()) {
+        return false;
+    }
+    bool ret = false;
+    if (list_entry >= 1 && list_entry <= _log_index_count) {
+        struct log_index_entry &e = _log_index[list_entry-1];
+        if (e.log_num == _last_log_num) {
+            _log_index_refresh(e);
         }
-        if (avail >= min_avail_space_percent) {
-            break;
+        entry = e;
+        ret = true;
+    }
+    _log_index_sem->give();
+    return ret;
+}
+
+/*
+  remove a log from the reclaim queue. Returns false if it was not
+  queued. Called with _log_index_sem held
+ */
+bool DataFlash_File::_reclaim_dequeue(const uint16_t log_num)
+{
+    for (uint8_t i=0; i<_reclaim_count; i++) {
+        if (_reclaim_queue[i] == log_num) {
+            _reclaim_count--;
+            memmove(&_reclaim_queue[i], &_reclaim_queue[i+1], (_reclaim_count - i) * sizeof(_reclaim_queue[0]));
+            return true;
         }
-        if (count++ > MAX_LOG_FILES+10) {
-            // *way* too many deletions going on here.  Possible internal error.
-            // internal_error();
-            break;
+    }
+    return false;
+}
+
+/*
+  check free space and pick the oldest logs for removal if it is below
+  min_avail_space_percent, then unlink one picked log per call. Runs
+  on the IO thread. The newest log, which may be being written, and a
+  log being downloaded are never removed
+ */
+void DataFlash_File::_io_reclaim_space(void)
+{
+#if !DATAFLASH_FILE_MINIMAL
+    if (_reclaim_count > 0) {
+        if (!_log_index_sem->take_nonblocking()) {
+            return;
         }
-        char *filename_to_remove = _log_file_name(log_to_remove);
-        if (filename_to_remove == NULL) {
-            // internal_error();
-            break;
+        // mark the log as being removed, so start_new_log() leaves its
+        // number alone, then unlink it without holding the lock; an
+        // unlink of a large log can take a long time
+        const uint16_t log_to_remove = (_reclaim_count > 0) ? _reclaim_queue[_reclaim_count-1] : 0;
+        _reclaim_removing = log_to_remove;
+        _log_index_sem->give();
+        if (log_to_remove == 0) {
+            return;
         }
-        if (file_exists(filename_to_remove)) {
-            hal.console->printf("Removing (%s) for minimum-space requirements (%.2f%% < %.0f%%)\n",
-                                filename_to_remove, (double)avail, (double)min_avail_space_percent);
-            if (unlink(filename_to_remove) == -1) {
+
+        char *filename_to_remove = _log_file_name(log_to_remove);
+        if (filename_to_remove != NULL) {
+            hal.console->printf("Removing (%s) for minimum-space requirements\n", filename_to_remove);
+            if (unlink(filename_to_remove) == -1 && errno != ENOENT) {
                 hal.console->printf("Failed to remove %s: %s\n", filename_to_remove, strerror(errno));
-                free(filename_to_remove);
-                if (errno == ENOENT) {
-                    // corruption - should always have a continuous
-                    // sequence of files...  however, there may be still
-                    // files out there, so keep going.
-                } else {
-                    // internal_error();
-                    break;
-                }
-            } else {
-                free(filename_to_remove);
             }
+            free(filename_to_remove);
         }
-        log_to_remove++;
-        if (log_to_remove > MAX_LOG_FILES) {
-            log_to_remove = 1;
+
+        if (_log_index_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+            _reclaim_dequeue(log_to_remove);
+            _reclaim_removing = 0;
+            if (_reclaim_count == 0) {
+                // see how much that freed straight away
+                _reclaim_requested = true;
+            }
+            _log_index_sem->give();
         }
-    } while (log_to_remove != first_log_to_remove);
-}
-#endif
+        return;
+    }
 
-void DataFlash_File::Prep() {
-    if (hal.util->get_soft_armed()) {
-        // do not want to do any filesystem operations while we are e.g. flying
+    const uint32_t now = AP_HAL::millis();
+    if (!_reclaim_requested && now - _reclaim_last_check_ms < DATAFLASH_FILE_RECLAIM_INTERVAL_MS) {
         return;
     }
-#if !DATAFLASH_FILE_MINIMAL
-    Prep_MinSpace();
+    _reclaim_last_check_ms = now;
+
+    const int64_t avail = disk_space_avail();
+    const int64_t space = disk_space();
+    if (avail < 0 || space <= 0) {
+        _reclaim_requested = false;
+        return;
+    }
+    const int64_t target = space * min_avail_space_percent * 0.01f;
+    if (avail >= target) {
+        _reclaim_requested = false;
+        return;
+    }
+
+    if (!_log_index_sem->take_nonblocking()) {
+        // try again on the next tick
+        _reclaim_requested = true;
+        return;
+    }
+    _reclaim_requested = false;
+
+    // free a quarter more than we need so we are not back here on the
+    // next check
+    int64_t to_free = (target - avail) + target / 4;
+    const uint16_t busy_log = (_read_fd != -1) ? _read_fd_log_num : 0;
+    uint16_t i = 0;
+    while (i < _log_index_count && _reclaim_count < DATAFLASH_FILE_RECLAIM_BATCH && to_free > 0) {
+        const uint16_t log_num = _log_index[i].log_num;
+        if (log_num == _last_log_num || log_num == busy_log) {
+            i++;
+            continue;
+        }
+        to_free -= _log_index[i].size;
+        // the queue is unlinked from the back; keep oldest first
+        memmove(&_reclaim_queue[1], &_reclaim_queue[0], _reclaim_count * sizeof(_reclaim_queue[0]));
+        _reclaim_queue[0] = log_num;
+        _reclaim_count++;
+        _log_index_remove(log_num);
+    }
+    _log_index_sem->give();
 #endif
 }
 
+void DataFlash_File::Prep() {
+    // have the IO thread check free space now rather than waiting for
+    // its next periodic check
+    _reclaim_requested = true;
+}
+
 bool DataFlash_File::NeedPrep()
 {
     if (!CardInserted()) {
@@ -468,7 +638,12 @@ void DataFlash_File::EraseAll()
         free(fname);
     }
 #endif
-    _cached_oldest_log = 0;
+    if (_log_index_lock()) {
+        _log_index_count = 0;
+        _last_log_num = 0;
+        _reclaim_count = 0;
+        _log_index_sem->give();
+    }
 
     if (was_logging) {
         start_new_log();
@@ -568,6 +743,19 @@ bool DataFlash_File::ReadBlock(void *pkt, uint16_t size)
   find the highest log number
  */
 uint16_t DataFlash_File::find_last_log()
+{
+    if (!_log_index_lock()) {
+        return 0;
+    }
+    const uint16_t ret = _last_log_num;
+    _log_index_sem->give();
+    return ret;
+}
+
+/*
+  read the newest log number from LASTLOG.TXT
+ */
+uint16_t DataFlash_File::_read_lastlog(void) const
 {
     unsigned ret = 0;
     char *fname = _lastlog_file_name();
@@ -634,17 +822,15 @@ uint32_t DataFlash_File::_get_log_time(const uint16_t log_num) const
 */
 uint16_t DataFlash_File::_log_num_from_list_entry(const uint16_t list_entry)
 {
-    uint16_t oldest_log = find_oldest_log();
-    if (oldest_log == 0) {
-        // We don't have any logs...
+    if (!_log_index_lock()) {
         return 0;
     }
-
-    uint32_t log_num = oldest_log + list_entry - 1;
-    if (log_num > MAX_LOG_FILES) {
-        log_num -= MAX_LOG_FILES;
+    uint16_t ret = 0;
+    if (list_entry >= 1 && list_entry <= _log_index_count) {
+        ret = _log_index[list_entry-1].log_num;
     }
-    return (uint16_t)log_num;
+    _log_index_sem->give();
+    return ret;
 }
 
 /*
@@ -652,8 +838,8 @@ uint16_t DataFlash_File::_log_num_from_list_entry(const uint16_t list_entry)
  */
 void DataFlash_File::get_log_boundaries(const uint16_t list_entry, uint16_t & start_page, uint16_t & end_page)
 {
-    const uint16_t log_num = _log_num_from_list_entry(list_entry);
-    if (log_num == 0) {
+    struct log_index_entry entry;
+    if (!_log_index_lookup(list_entry, entry)) {
         // that failed - probably no logs
         start_page = 0;
         end_page = 0;
@@ -661,7 +847,7 @@ void DataFlash_File::get_log_boundaries(const uint16_t list_entry, uint16_t & st
     }
 
     start_page = 0;
-    end_page = _get_log_size(log_num) / DATAFLASH_PAGE_SIZE;
+    end_page = entry.size / DATAFLASH_PAGE_SIZE;
 }
 
 /*
@@ -679,7 +865,31 @@ int16_t DataFlash_File::get_log_data(const uint16_t list_entry, const uint16_t p
         return -1;
     }
 
+    const uint32_t ofs = page * (uint32_t)DATAFLASH_PAGE_SIZE + offset;
+
+    if (_readahead_active && log_num == _read_fd_log_num) {
+        int16_t ret = _readahead_read(ofs, len, data);
+        if (ret >= 0) {
+            return ret;
+        }
+        hal.util->perf_count(_perf_readahead_miss);
+    }
+
+    if (!_read_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        return -1;
+    }
+    int16_t ret = _get_log_data_direct(log_num, ofs, len, data);
+    _read_sem->give();
+    return ret;
+}
+
+/*
+  read log data straight from the file. Called with _read_sem held
+ */
+int16_t DataFlash_File::_get_log_data_direct(const uint16_t log_num, const uint32_t ofs, const uint16_t len, uint8_t *data)
+{
     if (_read_fd != -1 && log_num != _read_fd_log_num) {
+        _readahead_active = false;
         ::close(_read_fd);
         _read_fd = -1;
     }
@@ -704,8 +914,41 @@ int16_t DataFlash_File::get_log_data(const uint16_t list_entry, const uint16_t p
         _read_offset = 0;
         _read_fd_log_num = log_num;
     }
-    uint32_t ofs = page * (uint32_t)DATAFLASH_PAGE_SIZE + offset;
 
+    // a request from before the read-ahead window is the GCS asking
+    // for a range it missed. Serve it without losing the read-ahead
+    const bool resend = _readahead_active && ofs < _readahead_ofs;
+    const uint32_t resume_offset = _read_offset;
+
+    if (!_read_fd_seek(ofs, len)) {
+        _readahead_active = false;
+        close(_read_fd);
+        _read_fd = -1;
+        return -1;
+    }
+    int16_t ret = (int16_t)::read(_read_fd, data, len);
+    if (ret > 0) {
+        _read_offset += ret;
+    }
+
+    if (resend) {
+        if (!_read_fd_seek(resume_offset, 0)) {
+            _readahead_active = false;
+            close(_read_fd);
+            _read_fd = -1;
+        }
+    } else if (ret >= 0) {
+        _readahead_start();
+        _readahead_eof = (ret < len);
+    }
+    return ret;
+}
+
+/*
+  position _read_fd at ofs ready to read len bytes
+ */
+bool DataFlash_File::_read_fd_seek(const uint32_t ofs, const uint16_t len)
+{
     /*
       this rather strange bit of code is here to work around a bug
       in file offsets in NuttX. Every few hundred blocks of reads
@@ -718,75 +961,190 @@ int16_t DataFlash_File::get_log_data(const uint16_t list_entry, const uint16_t p
     if (ofs / 4096 != (ofs+len) / 4096) {
         off_t seek_current = ::lseek(_read_fd, 0, SEEK_CUR);
         if (seek_current == (off_t)-1) {
-            close(_read_fd);
-            _read_fd = -1;
-            return -1;
+            return false;
         }
         if (seek_current != (off_t)_read_offset) {
             if (::lseek(_read_fd, _read_offset, SEEK_SET) == (off_t)-1) {
-                close(_read_fd);
-                _read_fd = -1;
-                return -1;
+                return false;
             }
         }
     }
 
     if (ofs != _read_offset) {
         if (::lseek(_read_fd, ofs, SEEK_SET) == (off_t)-1) {
-            close(_read_fd);
-            _read_fd = -1;
-            return -1;
+            return false;
         }
         _read_offset = ofs;
     }
-    int16_t ret = (int16_t)::read(_read_fd, data, len);
-    if (ret > 0) {
-        _read_offset += ret;
+    return true;
+}
+
+/*
+  serve a log download read from the read-ahead buffer. Returns -1 if
+  ofs is outside the buffered window
+ */
+int16_t DataFlash_File::_readahead_read(const uint32_t ofs, const uint16_t len, uint8_t *data)
+{
+    if (ofs < _readahead_ofs || ofs > _readahead_ofs + _readahead->available()) {
+        return -1;
     }
+
+    // drop anything the GCS skipped over
+    _readahead->advance(ofs - _readahead_ofs);
+    _readahead_ofs = ofs;
+
+    if (_readahead->available() < len && !_readahead_eof) {
+        // the link is outrunning the IO thread; read ahead here rather
+        // than stall the transfer. A short reply means end of log to
+        // the GCS, so keep going until len bytes are buffered
+        if (_read_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+            while (_readahead->available() < len && !_readahead_eof) {
+                if (!_readahead_fill()) {
+                    break;
+                }
+            }
+            _read_sem->give();
+        }
+        if (_readahead->available() < len && !_readahead_eof) {
+            // read-ahead failed; let the caller read directly
+            return -1;
+        }
+    }
+
+    int16_t ret = _readahead->read(data, len);
+    _readahead_ofs += ret;
     return ret;
 }
 
+/*
+  start reading ahead from the current read offset. Called with
+  _read_sem held
+ */
+void DataFlash_File::_readahead_start(void)
+{
+    if (_readahead == nullptr) {
+        _readahead = new ByteBuffer(DATAFLASH_FILE_READAHEAD_SIZE);
+        if (_readahead == nullptr) {
+            return;
+        }
+    }
+    if (_readahead->get_size() == 0) {
+        // out of memory; downloads fall back to direct reads
+        return;
+    }
+    _readahead->clear();
+    _readahead_ofs = _read_offset;
+    _readahead_eof = false;
+    _readahead_active = true;
+}
+
+/*
+  read the next chunk of the log into the read-ahead buffer, across
+  the wrap of the ring if need be. Returns true if any data was
+  added. Called with _read_sem held
+ */
+bool DataFlash_File::_readahead_fill(void)
+{
+    if (!_readahead_active || _readahead_eof || _read_fd == -1) {
+        return false;
+    }
+
+    // keep reads aligned to the chunk size to be kind to the filesystem
+    const uint32_t nbytes = DATAFLASH_FILE_READAHEAD_CHUNK - (_read_offset % DATAFLASH_FILE_READAHEAD_CHUNK);
+    if (_readahead->space() < nbytes) {
+        return false;
+    }
+
+    ByteBuffer::IoVec vec[2];
+    const uint8_t nvec = _readahead->reserve(vec, nbytes);
+    if (nvec == 0) {
+        return false;
+    }
+
+    if (!_read_fd_seek(_read_offset, nbytes)) {
+        _readahead->commit(0);
+        _readahead_active = false;
+        return false;
+    }
+
+    uint32_t total = 0;
+    for (uint8_t i=0; i<nvec; i++) {
+        ssize_t nread = ::read(_read_fd, vec[i].data, vec[i].len);
+        if (nread < 0) {
+            hal.util->perf_count(_perf_errors);
+            _readahead_active = false;
+            break;
+        }
+        if (nread == 0) {
+            _readahead_eof = true;
+            break;
+        }
+        total += nread;
+        if ((uint32_t)nread < vec[i].len) {
+            // short read; the rest comes on the next fill
+            break;
+        }
+    }
+    _readahead->commit(total);
+    _read_offset += total;
+    return total > 0;
+}
+
+/*
+  stop the IO thread reading ahead, before _read_fd is used for
+  anything else
+ */
+void DataFlash_File::_readahead_stop(void)
+{
+    if (!_readahead_active) {
+        return;
+    }
+    if (_read_sem->take(HAL_SEMAPHORE_BLOCK_FOREVER)) {
+        _readahead_active = false;
+        _read_sem->give();
+    }
+}
+
+/*
+  free the read-ahead buffer once a download is over, it is allocated
+  again by the next download
+ */
+void DataFlash_File::end_log_data(void)
+{
+    _readahead_stop();
+    delete _readahead;
+    _readahead = nullptr;
+}
+
 /*
   find size and date of a log
  */
 void DataFlash_File::get_log_info(const uint16_t list_entry, uint32_t &size, uint32_t &time_utc)
 {
-    uint16_t log_num = _log_num_from_list_entry(list_entry);
-    if (log_num == 0) {
+    struct log_index_entry entry;
+    if (!_log_index_lookup(list_entry, entry)) {
         // that failed - probably no logs
         size = 0;
         time_utc = 0;
         return;
     }
 
-    size = _get_log_size(log_num);
-    time_utc = _get_log_time(log_num);
+    size = entry.size;
+    time_utc = entry.time_utc;
 }
 
 
 
 /*
-  get the number of logs - note that the log numbers must be consecutive
+  get the number of logs
  */
 uint16_t DataFlash_File::get_num_logs()
 {
-    uint16_t ret = 0;
-    uint16_t high = find_last_log();
-    uint16_t i;
-    for (i=high; i>0; i--) {
-        if (! log_exists(i)) {
-            break;
-        }
-        ret++;
-    }
-    if (i == 0) {
-        for (i=MAX_LOG_FILES; i>high; i--) {
-            if (! log_exists(i)) {
-                break;
-            }
-            ret++;
-        }
+    if (!_log_index_lock()) {
+        return 0;
     }
+    const uint16_t ret = _log_index_count;
+    _log_index_sem->give();
     return ret;
 }
 
@@ -799,6 +1157,14 @@ void DataFlash_File::stop_logging(void)
         int fd = _write_fd;
         _write_fd = -1;
         log_write_started = false;
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+        if (_prealloc_end > _write_offset) {
+            // give back the space reserved past the end of the log
+            if (::ftruncate(fd, _write_offset) == -1) {
+                hal.util->perf_count(_perf_errors);
+            }
+        }
+#endif
         ::close(fd);
     }
 }
@@ -819,6 +1185,7 @@ uint16_t DataFlash_File::start_new_log(void)
         return 0xFFFF;
     }
 
+    _readahead_stop();
     if (_read_fd != -1) {
         ::close(_read_fd);
         _read_fd = -1;
@@ -830,7 +1197,12 @@ uint16_t DataFlash_File::start_new_log(void)
         return 0xffff;
     }
 
-    uint16_t log_num = find_last_log();
+    // the lock is held until the new log is in the index, so the IO
+    // thread cannot pick its number for removal in between
+    if (!_log_index_lock()) {
+        return 0xFFFF;
+    }
+    uint16_t log_num = _last_log_num;
     // re-use empty logs if possible
     if (_get_log_size(log_num) > 0 || log_num == 0) {
         log_num++;
@@ -838,14 +1210,25 @@ uint16_t DataFlash_File::start_new_log(void)
     if (log_num > MAX_LOG_FILES) {
         log_num = 1;
     }
+    if (log_num == _reclaim_removing) {
+        // the IO thread is unlinking the old log with this number
+        log_num++;
+        if (log_num > MAX_LOG_FILES) {
+            log_num = 1;
+        }
+    }
+    // an old log only queued for removal is truncated by the open
+    _reclaim_dequeue(log_num);
+
     char *fname = _log_file_name(log_num);
     if (fname == NULL) {
+        _log_index_sem->give();
         return 0xFFFF;
     }
     _write_fd = ::open(fname, O_WRONLY|O_CREAT|O_TRUNC, 0666);
-    _cached_oldest_log = 0;
 
     if (_write_fd == -1) {
+        _log_index_sem->give();
         _initialised = false;
         _open_error = true;
         int saved_errno = errno;
@@ -857,7 +1240,23 @@ uint16_t DataFlash_File::start_new_log(void)
         return 0xFFFF;
     }
     free(fname);
+
+    // record the final size of the previous log, then add the new
+    // one. A wrapped log number replaces the oldest log
+    if (_log_index_count > 0 && _log_index[_log_index_count-1].log_num == _last_log_num) {
+        _log_index_refresh(_log_index[_log_index_count-1]);
+    }
+    _log_index_remove(log_num);
+    _last_log_num = log_num;
+    _log_index_add(log_num, 0, 0);
+    _log_index_sem->give();
+
     _write_offset = 0;
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    _prealloc_end = 0;
+    _prealloc_failed = false;
+    _writeback_offset = 0;
+#endif
     _writebuf_head = 0;
     _writebuf_tail = 0;
     log_write_started = true;
@@ -904,6 +1303,7 @@ void DataFlash_File::LogReadProcess(const uint16_t list_entry,
         return;
     }
 
+    _readahead_stop();
     if (_read_fd != -1) {
         ::close(_read_fd);
         _read_fd = -1;
@@ -1056,13 +1456,94 @@ void DataFlash_File::flush(void)
 }
 #endif
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+/*
+  keep space reserved ahead of the log writer, so writes do not have to
+  allocate blocks. FALLOC_FL_KEEP_SIZE leaves the file size alone, and
+  the reservation past the end is released in stop_logging()
+ */
+void DataFlash_File::_io_prealloc(void)
+{
+    const uint32_t size = _streaming ? DATAFLASH_FILE_STREAM_PREALLOC_SIZE : DATAFLASH_FILE_PREALLOC_SIZE;
+    if (_prealloc_unsupported || _prealloc_failed || _write_offset + size/2 < _prealloc_end) {
+        return;
+    }
+    const uint32_t ofs = MAX(_prealloc_end, _write_offset);
+    if (::fallocate(_write_fd, FALLOC_FL_KEEP_SIZE, ofs, size) == -1) {
+        if (errno == EOPNOTSUPP || errno == ENOSYS) {
+            // not supported by this filesystem
+            _prealloc_unsupported = true;
+        } else {
+            // most likely out of space; try again with the next log
+            hal.util->perf_count(_perf_errors);
+            _prealloc_failed = true;
+        }
+        return;
+    }
+    _prealloc_end = ofs + size;
+}
+
+/*
+  streaming writeback: start writing out the block just written without
+  waiting for it, and only wait for blocks written more than
+  DATAFLASH_FILE_WRITEBACK_WINDOW ago, which are normally on the card
+  already. This bounds the dirty log data in the page cache without the
+  IO thread ever waiting on a whole-file fsync()
+ */
+void DataFlash_File::_io_writeback(const uint32_t nwritten)
+{
+    if (::sync_file_range(_write_fd, _write_offset - nwritten, nwritten, SYNC_FILE_RANGE_WRITE) == -1) {
+        hal.util->perf_count(_perf_errors);
+    }
+    if (_write_offset < _writeback_offset + 2*DATAFLASH_FILE_WRITEBACK_WINDOW) {
+        return;
+    }
+    const uint32_t end = _write_offset - DATAFLASH_FILE_WRITEBACK_WINDOW;
+    hal.util->perf_begin(_perf_sync_range);
+    if (::sync_file_range(_write_fd, _writeback_offset, end - _writeback_offset,
+                          SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER) == -1) {
+        hal.util->perf_count(_perf_errors);
+    }
+    hal.util->perf_end(_perf_sync_range);
+    _writeback_offset = end;
+}
+#endif
+
+void DataFlash_File::_io_fsync(void)
+{
+#if CONFIG_HAL_BOARD != HAL_BOARD_SITL && CONFIG_HAL_BOARD_SUBTYPE != HAL_BOARD_SUBTYPE_LINUX_NONE && CONFIG_HAL_BOARD != HAL_BOARD_QURT
+    hal.util->perf_begin(_perf_fsync);
+    ::fsync(_write_fd);
+    hal.util->perf_end(_perf_fsync);
+#endif
+}
+
 void DataFlash_File::_io_timer(void)
 {
+    if (_readahead_active && _read_sem->take_nonblocking()) {
+        // keep a log download fed. Logging is stopped while
+        // downloading, so this does not compete with writes
+        for (uint8_t i=0; i<4; i++) {
+            if (!_readahead_fill()) {
+                break;
+            }
+        }
+        _read_sem->give();
+    }
+
+    if (_initialised) {
+        _io_reclaim_space();
+    }
+
     uint16_t _tail;
     if (_write_fd == -1 || !_initialised || _open_error) {
         return;
     }
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    _io_prealloc();
+#endif
+
     uint16_t nbytes = BUF_AVAILABLE(_writebuf);
     if (nbytes == 0) {
         return;
@@ -1121,8 +1602,14 @@ void DataFlash_File::_io_timer(void)
           write.
          */
         BUF_ADVANCEHEAD(_writebuf, nwritten);
-#if CONFIG_HAL_BOARD != HAL_BOARD_SITL && CONFIG_HAL_BOARD_SUBTYPE != HAL_BOARD_SUBTYPE_LINUX_NONE && CONFIG_HAL_BOARD != HAL_BOARD_QURT
-        ::fsync(_write_fd);
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+        if (_streaming) {
+            _io_writeback(nwritten);
+        } else {
+            _io_fsync();
+        }
+#else
+        _io_fsync();
 #endif
     }
     hal.util->perf_end(_perf_write);
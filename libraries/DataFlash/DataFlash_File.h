@@ -24,6 +24,33 @@
 #define DATAFLASH_FILE_MINIMAL 0
 #endif
 
+/*
+  size of the buffer the IO thread reads a log into ahead of a MAVLink
+  log download, and the size of each read
+ */
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define DATAFLASH_FILE_READAHEAD_SIZE  65536
+#else
+#define DATAFLASH_FILE_READAHEAD_SIZE  8192
+#endif
+#define DATAFLASH_FILE_READAHEAD_CHUNK 4096
+
+// how often the IO thread checks free space, and how many old logs it
+// picks for removal after each check
+#define DATAFLASH_FILE_RECLAIM_INTERVAL_MS 5000
+#define DATAFLASH_FILE_RECLAIM_BATCH 8
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+// space reserved ahead of the log writer with fallocate()
+#define DATAFLASH_FILE_PREALLOC_SIZE (4*1024*1024UL)
+// with LOG_FILE_SYNC=1, the larger extents reserved ahead of the writer,
+// and how far behind it writeback is waited for
+#define DATAFLASH_FILE_STREAM_PREALLOC_SIZE (64*1024*1024UL)
+#define DATAFLASH_FILE_WRITEBACK_WINDOW (1024*1024UL)
+#endif
+
+class ByteBuffer;
+
 class DataFlash_File : public DataFlash_Backend
 {
 public:
@@ -53,6 +80,7 @@ public:
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
     int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data);
     uint16_t get_num_logs() override;
+    void end_log_data(void) override;
     uint16_t start_new_log(void) override;
     void LogReadProcess(const uint16_t log_num,
                         uint16_t start_page, uint16_t end_page, 
@@ -81,7 +109,69 @@ private:
     volatile bool _open_error;
     const char *_log_directory;
 
-    uint16_t _cached_oldest_log;
+    /*
+      index of the logs on the card, oldest first, built from one scan
+      of the log directory and kept up to date as logs are created and
+      removed, so listing logs does not touch the filesystem. The IO
+      thread removes logs from it when reclaiming space, so it is only
+      accessed with _log_index_sem held
+     */
+    struct log_index_entry {
+        uint16_t log_num;
+        uint32_t size;
+        uint32_t time_utc;
+    };
+    struct log_index_entry *_log_index;
+    uint16_t _log_index_count;
+    uint16_t _log_index_space;
+    bool _log_index_valid;
+    AP_HAL::Semaphore *_log_index_sem;
+    // number of the newest log, as recorded in LASTLOG.TXT
+    uint16_t _last_log_num;
+
+    bool _log_index_lock(void);
+    void _log_index_build(void);
+    void _log_index_add(uint16_t log_num, uint32_t size, uint32_t time_utc);
+    void _log_index_remove(uint16_t log_num);
+    void _log_index_refresh(struct log_index_entry &entry) const;
+    uint16_t _log_index_age(uint16_t log_num) const;
+    bool _log_index_lookup(uint16_t list_entry, struct log_index_entry &entry);
+    uint16_t _read_lastlog(void) const;
+
+    /*
+      free space reclamation, done on the IO thread so it can happen
+      while armed without stalling the writer. Logs picked for removal
+      are taken out of the index and unlinked one per IO tick, without
+      _log_index_sem held. A log stays in _reclaim_queue until its
+      unlink is done, and _reclaim_removing is the one being unlinked,
+      so start_new_log() never reuses its number meanwhile
+     */
+    uint16_t _reclaim_queue[DATAFLASH_FILE_RECLAIM_BATCH];
+    uint8_t _reclaim_count;
+    uint16_t _reclaim_removing;
+    volatile bool _reclaim_requested;
+    uint32_t _reclaim_last_check_ms;
+
+    void _io_reclaim_space(void);
+    bool _reclaim_dequeue(uint16_t log_num);
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    // end of the space reserved for the log being written
+    uint32_t _prealloc_end;
+    // fallocate() failed for the current log
+    bool _prealloc_failed;
+    // the filesystem has no fallocate(), so don't try again
+    bool _prealloc_unsupported;
+
+    // LOG_FILE_SYNC=1: sync_file_range() writeback instead of fsync();
+    // everything before _writeback_offset is known to be on the card
+    bool _streaming;
+    uint32_t _writeback_offset;
+
+    void _io_prealloc(void);
+    void _io_writeback(uint32_t nwritten);
+#endif
+    void _io_fsync(void);
 
     /*
       read a block
@@ -90,9 +180,26 @@ private:
 
     uint16_t _log_num_from_list_entry(const uint16_t list_entry);
 
-    // possibly time-consuming preparations handling
-    void Prep_MinSpace();
-    uint16_t find_oldest_log();
+    /*
+      log download read-ahead. While a log is being downloaded the IO
+      thread keeps _readahead filled with the file contents following
+      _readahead_ofs, so get_log_data() is usually just a copy. The IO
+      thread only touches _read_fd while holding _read_sem and while
+      _readahead_active is set.
+     */
+    ByteBuffer *_readahead;
+    uint32_t _readahead_ofs;
+    volatile bool _readahead_active;
+    volatile bool _readahead_eof;
+    AP_HAL::Semaphore *_read_sem;
+
+    int16_t _get_log_data_direct(uint16_t log_num, uint32_t ofs, uint16_t len, uint8_t *data);
+    int16_t _readahead_read(uint32_t ofs, uint16_t len, uint8_t *data);
+    void _readahead_start(void);
+    bool _readahead_fill(void);
+    void _readahead_stop(void);
+    bool _read_fd_seek(uint32_t ofs, uint16_t len);
+
     int64_t disk_space_avail();
     int64_t disk_space();
     float avail_space_percent();
@@ -159,6 +266,10 @@ private:
     AP_HAL::Util::perf_counter_t  _perf_fsync;
     AP_HAL::Util::perf_counter_t  _perf_errors;
     AP_HAL::Util::perf_counter_t  _perf_overruns;
+    AP_HAL::Util::perf_counter_t  _perf_readahead_miss;
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    AP_HAL::Util::perf_counter_t  _perf_sync_range;
+#endif
 };
 
 #endif // HAL_OS_POSIX_IO
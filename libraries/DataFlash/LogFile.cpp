@@ -18,6 +18,7 @@
 #include "DataFlash_Block.h"
 #include "DataFlash_File.h"
 #include "DataFlash_MAVLink.h"
+#include "DataFlash_BlackBox.h"
 #include "DFMessageWriter.h"
 
 extern const AP_HAL::HAL& hal;
@@ -31,10 +32,11 @@ void DataFlash_Class::Init(const struct LogStructure *structures, uint8_t num_ty
     _num_types = num_types;
     _structures = structures;
 
-    ;
+    if (_log_write_fmts_sem == nullptr) {
+        _log_write_fmts_sem = hal.util->new_semaphore();
+    }
 #if defined(HAL_BOARD_LOG_DIRECTORY)
-    if (_params.backend_types == DATAFLASH_BACKEND_FILE ||
-        _params.backend_types == DATAFLASH_BACKEND_BOTH) {
+    if (_params.backend_types & DATAFLASH_BACKEND_FILE) {
         DFMessageWriter_DFLogStart *message_writer =
             new DFMessageWriter_DFLogStart(_firmware_string);
         if (message_writer != NULL)  {
@@ -47,14 +49,15 @@ void DataFlash_Class::Init(const struct LogStructure *structures, uint8_t num_ty
         if (backends[_next_backend] == NULL) {
             hal.console->printf("Unable to open DataFlash_File");
         } else {
+            backends[_next_backend]->set_rate_max(_params.file_rate_max);
+            _backend_type[_next_backend] = DATAFLASH_BACKEND_FILE;
             _next_backend++;
         }
     }
 #endif
 
 #if DATAFLASH_MAVLINK_SUPPORT
-    if (_params.backend_types == DATAFLASH_BACKEND_MAVLINK ||
-        _params.backend_types == DATAFLASH_BACKEND_BOTH) {
+    if (_params.backend_types & DATAFLASH_BACKEND_MAVLINK) {
         if (_next_backend == DATAFLASH_MAX_BACKENDS) {
             AP_HAL::panic("Too many backends");
             return;
@@ -68,6 +71,30 @@ void DataFlash_Class::Init(const struct LogStructure *structures, uint8_t num_ty
         if (backends[_next_backend] == NULL) {
             hal.console->printf("Unable to open DataFlash_MAVLink");
         } else {
+            backends[_next_backend]->set_rate_max(_params.mav_rate_max);
+            _backend_type[_next_backend] = DATAFLASH_BACKEND_MAVLINK;
+            _next_backend++;
+        }
+    }
+#endif
+
+#if defined(HAL_BOARD_LOG_DIRECTORY) && HAL_OS_POSIX_IO
+    if (_params.backend_types & DATAFLASH_BACKEND_BLACKBOX) {
+        if (_next_backend == DATAFLASH_MAX_BACKENDS) {
+            AP_HAL::panic("Too many backends");
+            return;
+        }
+        DFMessageWriter_DFLogStart *message_writer =
+            new DFMessageWriter_DFLogStart(_firmware_string);
+        if (message_writer != NULL)  {
+            backends[_next_backend] = new DataFlash_BlackBox(*this,
+                                                             message_writer,
+                                                             HAL_BOARD_LOG_DIRECTORY);
+        }
+        if (backends[_next_backend] == NULL) {
+            hal.console->printf("Unable to open DataFlash_BlackBox");
+        } else {
+            _backend_type[_next_backend] = DATAFLASH_BACKEND_BLACKBOX;
             _next_backend++;
         }
     }
@@ -76,6 +103,9 @@ void DataFlash_Class::Init(const struct LogStructure *structures, uint8_t num_ty
     for (uint8_t i=0; i<_next_backend; i++) {
         backends[i]->Init();
     }
+
+    msg_drops_init();
+    msg_filters_update();
 }
 
 // This function determines the number of whole or partial log files in the DataFlash
@@ -644,6 +674,10 @@ void DataFlash_Block::ListAvailableLogs(AP_HAL::BetterStream *port)
 // the format of supported messages in the log
 void DataFlash_Class::StartNewLog(void)
 {
+    // the FMT messages written at the start of the log fix which
+    // fields of each message type are logged
+    msg_filters_update();
+    msg_trims_update();
     for (uint8_t i=0; i<_next_backend; i++) {
         backends[i]->start_new_log();
     }
@@ -667,6 +701,32 @@ void DataFlash_Backend::Log_Fill_Format(const struct LogStructure *s, struct log
     strncpy(pkt.name, s->name, sizeof(pkt.name));
     strncpy(pkt.format, s->format, sizeof(pkt.format));
     strncpy(pkt.labels, s->labels, sizeof(pkt.labels));
+    // messages with fields masked out are described as they are written
+    _front.msg_trim_fill_format(pkt);
+}
+
+bool DataFlash_Backend::Log_Fill_Format_For_Type(const uint8_t msg_type, struct log_Format &pkt)
+{
+    for (uint8_t i=0; i<num_types(); i++) {
+        const struct LogStructure *s = structure(i);
+        if (s->msg_type == msg_type) {
+            Log_Fill_Format(s, pkt);
+            return true;
+        }
+    }
+    struct LogStructure logstruct = {
+        // these will be overwritten, but need to keep the compiler happy:
+        0,
+        0,
+        "IGNO",
+        "",
+        ""
+    };
+    if (!_front.fill_log_write_logstructure(logstruct, msg_type)) {
+        return false;
+    }
+    Log_Fill_Format(&logstruct, pkt);
+    return true;
 }
 
 /*
@@ -765,6 +825,9 @@ void DataFlash_Class::Log_Write_RFND(const RangeFinder &rangefinder)
 // Write an RCIN packet
 void DataFlash_Class::Log_Write_RCIN(void)
 {
+    if (!msg_type_due(LOG_RCIN_MSG)) {
+        return;
+    }
     struct log_RCIN pkt = {
         LOG_PACKET_HEADER_INIT(LOG_RCIN_MSG),
         time_us       : AP_HAL::micros64(),
@@ -789,6 +852,9 @@ void DataFlash_Class::Log_Write_RCIN(void)
 // Write an SERVO packet
 void DataFlash_Class::Log_Write_RCOUT(void)
 {
+    if (!msg_type_due(LOG_RCOUT_MSG)) {
+        return;
+    }
     struct log_RCOUT pkt = {
         LOG_PACKET_HEADER_INIT(LOG_RCOUT_MSG),
         time_us       : AP_HAL::micros64(),
@@ -871,14 +937,16 @@ void DataFlash_Class::Log_Write_Baro(AP_Baro &baro, uint64_t time_us)
     }
 }
 
-// Write an raw accel/gyro data packet
-void DataFlash_Class::Log_Write_IMU(const AP_InertialSensor &ins)
+// Write an raw accel/gyro data packet for one IMU
+void DataFlash_Class::Log_Write_IMU_instance(const AP_InertialSensor &ins, const uint64_t time_us, const uint8_t imu_instance, const enum LogMessages type)
 {
-    uint64_t time_us = AP_HAL::micros64();
-    const Vector3f &gyro = ins.get_gyro(0);
-    const Vector3f &accel = ins.get_accel(0);
+    if (!msg_type_due(type)) {
+        return;
+    }
+    const Vector3f &gyro = ins.get_gyro(imu_instance);
+    const Vector3f &accel = ins.get_accel(imu_instance);
     struct log_IMU pkt = {
-        LOG_PACKET_HEADER_INIT(LOG_IMU_MSG),
+        LOG_PACKET_HEADER_INIT(type),
         time_us : time_us,
         gyro_x  : gyro.x,
         gyro_y  : gyro.y,
@@ -886,56 +954,28 @@ void DataFlash_Class::Log_Write_IMU(const AP_InertialSensor &ins)
         accel_x : accel.x,
         accel_y : accel.y,
         accel_z : accel.z,
-        gyro_error  : ins.get_gyro_error_count(0),
-        accel_error : ins.get_accel_error_count(0),
-        temperature : ins.get_temperature(0),
-        gyro_health : (uint8_t)ins.get_gyro_health(0),
-        accel_health : (uint8_t)ins.get_accel_health(0)
+        gyro_error  : ins.get_gyro_error_count(imu_instance),
+        accel_error : ins.get_accel_error_count(imu_instance),
+        temperature : ins.get_temperature(imu_instance),
+        gyro_health : (uint8_t)ins.get_gyro_health(imu_instance),
+        accel_health : (uint8_t)ins.get_accel_health(imu_instance)
     };
     WriteBlock(&pkt, sizeof(pkt));
+}
+
+// Write an raw accel/gyro data packet
+void DataFlash_Class::Log_Write_IMU(const AP_InertialSensor &ins)
+{
+    uint64_t time_us = AP_HAL::micros64();
+    Log_Write_IMU_instance(ins, time_us, 0, LOG_IMU_MSG);
     if (ins.get_gyro_count() < 2 && ins.get_accel_count() < 2) {
         return;
     }
-
-    const Vector3f &gyro2 = ins.get_gyro(1);
-    const Vector3f &accel2 = ins.get_accel(1);
-    struct log_IMU pkt2 = {
-        LOG_PACKET_HEADER_INIT(LOG_IMU2_MSG),
-        time_us : time_us,
-        gyro_x  : gyro2.x,
-        gyro_y  : gyro2.y,
-        gyro_z  : gyro2.z,
-        accel_x : accel2.x,
-        accel_y : accel2.y,
-        accel_z : accel2.z,
-        gyro_error  : ins.get_gyro_error_count(1),
-        accel_error : ins.get_accel_error_count(1),
-        temperature : ins.get_temperature(1),
-        gyro_health : (uint8_t)ins.get_gyro_health(1),
-        accel_health : (uint8_t)ins.get_accel_health(1)
-    };
-    WriteBlock(&pkt2, sizeof(pkt2));
+    Log_Write_IMU_instance(ins, time_us, 1, LOG_IMU2_MSG);
     if (ins.get_gyro_count() < 3 && ins.get_accel_count() < 3) {
         return;
     }
-    const Vector3f &gyro3 = ins.get_gyro(2);
-    const Vector3f &accel3 = ins.get_accel(2);
-    struct log_IMU pkt3 = {
-        LOG_PACKET_HEADER_INIT(LOG_IMU3_MSG),
-        time_us : time_us,
-        gyro_x  : gyro3.x,
-        gyro_y  : gyro3.y,
-        gyro_z  : gyro3.z,
-        accel_x : accel3.x,
-        accel_y : accel3.y,
-        accel_z : accel3.z,
-        gyro_error  : ins.get_gyro_error_count(2),
-        accel_error : ins.get_accel_error_count(2),
-        temperature : ins.get_temperature(2),
-        gyro_health : (uint8_t)ins.get_gyro_health(2),
-        accel_health : (uint8_t)ins.get_accel_health(2)
-    };
-    WriteBlock(&pkt3, sizeof(pkt3));
+    Log_Write_IMU_instance(ins, time_us, 2, LOG_IMU3_MSG);
 }
 
 // Write an accel/gyro delta time data packet
@@ -1024,6 +1064,9 @@ void DataFlash_Class::Log_Write_IMUDT(const AP_InertialSensor &ins, uint64_t tim
 
 void DataFlash_Class::Log_Write_Vibration(const AP_InertialSensor &ins)
 {
+    if (!msg_type_due(LOG_VIBE_MSG)) {
+        return;
+    }
     uint64_t time_us = AP_HAL::micros64();
     Vector3f vibration = ins.get_vibration_levels();
     struct log_Vibe pkt = {
@@ -1085,6 +1128,9 @@ void DataFlash_Class::Log_Write_Power(void)
 // Write an AHRS2 packet
 void DataFlash_Class::Log_Write_AHRS2(AP_AHRS &ahrs)
 {
+    if (!msg_type_due(LOG_AHR2_MSG)) {
+        return;
+    }
     Vector3f euler;
     struct Location loc;
     if (!ahrs.get_secondary_attitude(euler) || !ahrs.get_secondary_position(loc)) {
@@ -1106,6 +1152,9 @@ void DataFlash_Class::Log_Write_AHRS2(AP_AHRS &ahrs)
 // Write a POS packet
 void DataFlash_Class::Log_Write_POS(AP_AHRS &ahrs)
 {
+    if (!msg_type_due(LOG_POS_MSG)) {
+        return;
+    }
     Location loc;
     if (!ahrs.get_position(loc)) {
         return;
@@ -1126,9 +1175,13 @@ void DataFlash_Class::Log_Write_POS(AP_AHRS &ahrs)
 #if AP_AHRS_NAVEKF_AVAILABLE
 void DataFlash_Class::Log_Write_EKF(AP_AHRS_NavEKF &ahrs, bool optFlowEnabled)
 {
+    static const uint8_t ekf_msg_types[] = {
+        LOG_EKF1_MSG, LOG_EKF2_MSG, LOG_EKF3_MSG, LOG_EKF4_MSG, LOG_EKF5_MSG
+    };
     uint64_t time_us = AP_HAL::micros64();
-    // only log EKF if enabled
-    if (ahrs.get_NavEKF().enabled()) {
+    // only log EKF if enabled. The packets are skipped as a group, as
+    // for EKF2
+    if (ahrs.get_NavEKF().enabled() && msg_type_any_due(ekf_msg_types, ARRAY_SIZE(ekf_msg_types))) {
         // Write first EKF packet
         Vector3f euler;
         Vector2f posNE;
@@ -1285,6 +1338,16 @@ void DataFlash_Class::Log_Write_EKF(AP_AHRS_NavEKF &ahrs, bool optFlowEnabled)
 
 void DataFlash_Class::Log_Write_EKF2(AP_AHRS_NavEKF &ahrs, bool optFlowEnabled)
 {
+    static const uint8_t nkf_msg_types[] = {
+        LOG_NKF1_MSG, LOG_NKF2_MSG, LOG_NKF3_MSG, LOG_NKF4_MSG, LOG_NKF5_MSG,
+        LOG_NKF6_MSG, LOG_NKF7_MSG, LOG_NKF8_MSG, LOG_NKF9_MSG
+    };
+    // the packets share their intermediate values, so they are only
+    // skipped as a group, when none of them is due. Each is still
+    // decimated or dropped separately as it is written
+    if (!msg_type_any_due(nkf_msg_types, ARRAY_SIZE(nkf_msg_types))) {
+        return;
+    }
     uint64_t time_us = AP_HAL::micros64();
 	// Write first EKF packet
     Vector3f euler;
@@ -1632,6 +1695,9 @@ void DataFlash_Class::Log_Write_Trigger(const AP_AHRS &ahrs, const AP_GPS &gps,
 // Write an attitude packet
 void DataFlash_Class::Log_Write_Attitude(AP_AHRS &ahrs, const Vector3f &targets)
 {
+    if (!msg_type_due(LOG_ATTITUDE_MSG)) {
+        return;
+    }
     struct log_Attitude pkt = {
         LOG_PACKET_HEADER_INIT(LOG_ATTITUDE_MSG),
         time_us         : AP_HAL::micros64(),
@@ -1801,6 +1867,9 @@ void DataFlash_Class::Log_Write_ESC(void)
 // Write a AIRSPEED packet
 void DataFlash_Class::Log_Write_Airspeed(AP_Airspeed &airspeed)
 {
+    if (!msg_type_due(LOG_ARSP_MSG)) {
+        return;
+    }
     float temperature;
     if (!airspeed.get_temperature(temperature)) {
         temperature = 0;
@@ -1821,6 +1890,9 @@ void DataFlash_Class::Log_Write_Airspeed(AP_Airspeed &airspeed)
 // Write a Yaw PID packet
 void DataFlash_Class::Log_Write_PID(uint8_t msg_type, const PID_Info &info)
 {
+    if (!msg_type_due(msg_type)) {
+        return;
+    }
     struct log_PID pkt = {
         LOG_PACKET_HEADER_INIT(msg_type),
         time_us         : AP_HAL::micros64(),
@@ -1850,6 +1922,9 @@ void DataFlash_Class::Log_Write_Origin(uint8_t origin_type, const Location &loc)
 
 void DataFlash_Class::Log_Write_RPM(const AP_RPM &rpm_sensor)
 {
+    if (!msg_type_due(LOG_RPM_MSG)) {
+        return;
+    }
     struct log_RPM pkt = {
         LOG_PACKET_HEADER_INIT(LOG_RPM_MSG),
         time_us     : AP_HAL::micros64(),
@@ -1865,6 +1940,9 @@ void DataFlash_Class::Log_Write_Rate(const AP_AHRS &ahrs,
                                      const AC_AttitudeControl &attitude_control,
                                      const AC_PosControl &pos_control)
 {
+    if (!msg_type_due(LOG_RATE_MSG)) {
+        return;
+    }
     const Vector3f &rate_targets = attitude_control.rate_bf_targets();
     const Vector3f &accel_target = pos_control.get_accel_target();
     struct log_Rate pkt_rate = {
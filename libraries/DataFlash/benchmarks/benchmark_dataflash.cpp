@@ -0,0 +1,190 @@
+#include <AP_gbenchmark.h>
+
+#include <string.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <DataFlash/DataFlash.h>
+#include <DataFlash/DataFlash_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+ * backend that copies every block into memory and drops it, so what is
+ * measured is the frontend and the message formatting rather than the
+ * storage
+ */
+class DataFlash_Null : public DataFlash_Backend {
+public:
+    DataFlash_Null(DataFlash_Class &front) :
+        DataFlash_Backend(front, new DFMessageWriter_DFLogStart("benchmark"))
+    {
+    }
+
+    bool CardInserted(void) override { return true; }
+    void EraseAll() override { }
+    bool NeedPrep() override { return false; }
+    void Prep() override { }
+
+    bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override {
+        memcpy(_sink, pBuffer, MIN(size, sizeof(_sink)));
+        return true;
+    }
+
+    uint16_t find_last_log() override { return 0; }
+    void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page) override { }
+    void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc) override { }
+    int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override { return 0; }
+    uint16_t get_num_logs() override { return 0; }
+    void LogReadProcess(const uint16_t list_entry,
+                        uint16_t start_page, uint16_t end_page,
+                        print_mode_fn printMode,
+                        AP_HAL::BetterStream *port) override { }
+    void DumpPageInfo(AP_HAL::BetterStream *port) override { }
+    void ShowDeviceInfo(AP_HAL::BetterStream *port) override { }
+    void ListAvailableLogs(AP_HAL::BetterStream *port) override { }
+
+    uint16_t bufferspace_available() override { return UINT16_MAX; }
+    uint16_t start_new_log(void) override { return 0; }
+    void stop_logging(void) override { }
+
+    bool logging_enabled() const override { return true; }
+    bool logging_failed() const override { return false; }
+
+protected:
+    bool ReadBlock(void *pkt, uint16_t size) override { return false; }
+
+private:
+    uint8_t _sink[256];
+};
+
+class DataFlash_Class_Benchmark {
+public:
+    static DataFlash_Class &dataflash()
+    {
+        static DataFlash_Class df("benchmark");
+        if (df._next_backend == 0) {
+            df.backends[df._next_backend++] = new DataFlash_Null(df);
+        }
+        return df;
+    }
+
+    static DataFlash_Backend *backend(DataFlash_Class &df)
+    {
+        return df.backends[0];
+    }
+
+    // log only the fields in field_mask of msg_type, 0 for all fields
+    static void set_field_mask(DataFlash_Class &df, const struct LogStructure *structures,
+                               uint8_t num_types, uint8_t msg_type, uint32_t field_mask)
+    {
+        df._structures = structures;
+        df._num_types = num_types;
+        df._params.filter_type[0].set(msg_type);
+        df._params.filter_mask[0].set(field_mask);
+        df.msg_trims_update();
+    }
+};
+
+static void BM_DataFlashLogWrite(benchmark::State& state)
+{
+    static const char *name = "BMK";
+    DataFlash_Class &df = DataFlash_Class_Benchmark::dataflash();
+    uint64_t t = 0;
+
+    while (state.KeepRunning()) {
+        df.Log_Write(name, "TimeUS,Roll,Pitch,Yaw,Alt,Mode", "QfffiB",
+                     t++, 0.1f, -0.2f, 1.5f, (int32_t)58400, (uint8_t)5);
+    }
+}
+
+BENCHMARK(BM_DataFlashLogWrite);
+
+static void BM_DataFlashWriteBlock(benchmark::State& state)
+{
+    DataFlash_Class &df = DataFlash_Class_Benchmark::dataflash();
+    struct log_Attitude pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_ATTITUDE_MSG),
+        time_us       : 0,
+        control_roll  : 100,
+        roll          : 95,
+        control_pitch : -200,
+        pitch         : -190,
+        control_yaw   : 9000,
+        yaw           : 8990,
+        error_rp      : 10,
+        error_yaw     : 5
+    };
+
+    while (state.KeepRunning()) {
+        pkt.time_us++;
+        df.WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+
+BENCHMARK(BM_DataFlashWriteBlock);
+
+/*
+ * the same block with the backend decimating the message type, which
+ * is what a rate limited MAVLink backend sees for full rate messages
+ */
+static void BM_DataFlashWriteBlockFiltered(benchmark::State& state)
+{
+    DataFlash_Class &df = DataFlash_Class_Benchmark::dataflash();
+    DataFlash_Class_Benchmark::backend(df)->set_rate_max(10);
+    struct log_Attitude pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_ATTITUDE_MSG),
+        time_us       : 0,
+        control_roll  : 100,
+        roll          : 95,
+        control_pitch : -200,
+        pitch         : -190,
+        control_yaw   : 9000,
+        yaw           : 8990,
+        error_rp      : 10,
+        error_yaw     : 5
+    };
+
+    while (state.KeepRunning()) {
+        pkt.time_us++;
+        df.WriteBlock(&pkt, sizeof(pkt));
+    }
+    DataFlash_Class_Benchmark::backend(df)->set_rate_max(0);
+}
+
+BENCHMARK(BM_DataFlashWriteBlockFiltered);
+
+/*
+ * the same block with LOG_FLT1_MASK keeping only the time and roll
+ * fields, so each message is copied down to its trimmed layout
+ */
+static void BM_DataFlashWriteBlockTrimmed(benchmark::State& state)
+{
+    static const struct LogStructure att_structure[] = {
+        { LOG_ATTITUDE_MSG, sizeof(log_Attitude),
+          "ATT", "QccccCCCC", "TimeUS,DesRoll,Roll,DesPitch,Pitch,DesYaw,Yaw,ErrRP,ErrYaw" },
+    };
+    DataFlash_Class &df = DataFlash_Class_Benchmark::dataflash();
+    DataFlash_Class_Benchmark::set_field_mask(df, att_structure, 1, LOG_ATTITUDE_MSG, 0x7);
+    struct log_Attitude pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_ATTITUDE_MSG),
+        time_us       : 0,
+        control_roll  : 100,
+        roll          : 95,
+        control_pitch : -200,
+        pitch         : -190,
+        control_yaw   : 9000,
+        yaw           : 8990,
+        error_rp      : 10,
+        error_yaw     : 5
+    };
+
+    while (state.KeepRunning()) {
+        pkt.time_us++;
+        df.WriteBlock(&pkt, sizeof(pkt));
+    }
+    DataFlash_Class_Benchmark::set_field_mask(df, nullptr, 0, 0, 0);
+}
+
+BENCHMARK(BM_DataFlashWriteBlockTrimmed);
+
+BENCHMARK_MAIN()
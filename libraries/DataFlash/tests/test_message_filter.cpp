@@ -0,0 +1,121 @@
+#include <AP_gtest.h>
+
+#include <string.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <DataFlash/DataFlash.h>
+#include <DataFlash/DataFlash_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+ * backend that drops everything written to it, for testing the message
+ * filtering the frontend asks each backend for
+ */
+class DataFlash_Null : public DataFlash_Backend {
+public:
+    DataFlash_Null(DataFlash_Class &front) :
+        DataFlash_Backend(front, new DFMessageWriter_DFLogStart("test"))
+    {
+    }
+
+    bool CardInserted(void) override { return true; }
+    void EraseAll() override { }
+    bool NeedPrep() override { return false; }
+    void Prep() override { }
+
+    bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override { return true; }
+
+    uint16_t find_last_log() override { return 0; }
+    void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page) override { }
+    void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc) override { }
+    int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override { return 0; }
+    uint16_t get_num_logs() override { return 0; }
+    void LogReadProcess(const uint16_t list_entry,
+                        uint16_t start_page, uint16_t end_page,
+                        print_mode_fn printMode,
+                        AP_HAL::BetterStream *port) override { }
+    void DumpPageInfo(AP_HAL::BetterStream *port) override { }
+    void ShowDeviceInfo(AP_HAL::BetterStream *port) override { }
+    void ListAvailableLogs(AP_HAL::BetterStream *port) override { }
+
+    uint16_t bufferspace_available() override { return UINT16_MAX; }
+    uint16_t start_new_log(void) override { return 0; }
+    void stop_logging(void) override { }
+
+    bool logging_enabled() const override { return true; }
+    bool logging_failed() const override { return false; }
+
+protected:
+    bool ReadBlock(void *pkt, uint16_t size) override { return false; }
+};
+
+static DataFlash_Class dataflash("test");
+
+// the first message of a rate limited type may be held back for up to
+// one interval, as the 16 bit time of the last message starts at zero
+static bool filter_message_within(DataFlash_Backend &backend, uint8_t msg_type, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = AP_HAL::millis();
+    do {
+        if (backend.filter_message(msg_type, false)) {
+            return true;
+        }
+    } while (AP_HAL::millis() - start_ms < timeout_ms);
+    return false;
+}
+
+TEST(DataFlash_Backend, filter_message_passes_by_default)
+{
+    DataFlash_Null backend(dataflash);
+
+    for (uint16_t msg_type=0; msg_type<256; msg_type++) {
+        EXPECT_TRUE(backend.filter_message(msg_type, false));
+        EXPECT_TRUE(backend.filter_message(msg_type, true));
+    }
+}
+
+TEST(DataFlash_Backend, filter_message_disabled_type)
+{
+    DataFlash_Null backend(dataflash);
+
+    backend.set_msg_type_enabled(31, false);
+    backend.set_msg_type_enabled(200, false);
+
+    EXPECT_FALSE(backend.filter_message(31, false));
+    EXPECT_FALSE(backend.filter_message(31, true));
+    EXPECT_FALSE(backend.filter_message(200, false));
+    // neighbouring types share the bitmap word
+    EXPECT_TRUE(backend.filter_message(30, false));
+    EXPECT_TRUE(backend.filter_message(32, false));
+    EXPECT_TRUE(backend.filter_message(201, false));
+
+    backend.set_msg_type_enabled(31, true);
+    EXPECT_TRUE(backend.filter_message(31, false));
+    EXPECT_FALSE(backend.filter_message(200, false));
+}
+
+TEST(DataFlash_Backend, filter_message_rate_max)
+{
+    DataFlash_Null backend(dataflash);
+
+    backend.set_rate_max(10);
+
+    ASSERT_TRUE(filter_message_within(backend, 5, 200));
+    // within 100ms of the last one
+    EXPECT_FALSE(backend.filter_message(5, false));
+    // critical messages are never decimated
+    EXPECT_TRUE(backend.filter_message(5, true));
+    // each type is decimated separately
+    EXPECT_TRUE(filter_message_within(backend, 6, 200));
+
+    // the next one goes out once the interval has passed
+    EXPECT_TRUE(filter_message_within(backend, 5, 200));
+
+    // 0 turns decimation off
+    backend.set_rate_max(0);
+    EXPECT_TRUE(backend.filter_message(5, false));
+    EXPECT_TRUE(backend.filter_message(5, false));
+}
+
+AP_GTEST_MAIN()
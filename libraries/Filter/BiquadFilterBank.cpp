@@ -0,0 +1,64 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BiquadFilterBank.h"
+
+bool BiquadCoefficients::lowpass(float sample_freq, float cutoff_freq, BiquadCoefficients &ret)
+{
+    if (cutoff_freq <= 0 || sample_freq <= 0 || cutoff_freq >= 0.5f * sample_freq) {
+        return false;
+    }
+
+    float fr = sample_freq/cutoff_freq;
+    float ohm = tanf(M_PI/fr);
+    float c = 1.0f+2.0f*cosf(M_PI/4.0f)*ohm + ohm*ohm;
+
+    ret.b0 = ohm*ohm/c;
+    ret.b1 = 2.0f*ret.b0;
+    ret.b2 = ret.b0;
+    ret.a1 = 2.0f*(ohm*ohm-1.0f)/c;
+    ret.a2 = (1.0f-2.0f*cosf(M_PI/4.0f)*ohm+ohm*ohm)/c;
+    return true;
+}
+
+/*
+  notch from the audio EQ cookbook, with the depth of the notch limited to
+  attenuation_dB rather than infinite so that a slightly wrong centre
+  frequency still does some good
+ */
+bool BiquadCoefficients::notch(float sample_freq, float center_freq, float bandwidth,
+                               float attenuation_dB, BiquadCoefficients &ret)
+{
+    if (center_freq <= 0 || sample_freq <= 0 || center_freq >= 0.5f * sample_freq ||
+        bandwidth <= 0 || bandwidth >= 2 * center_freq || attenuation_dB <= 0) {
+        return false;
+    }
+
+    // bandwidth in octaves gives the Q of the section
+    float octaves = log2f(center_freq / (center_freq - 0.5f * bandwidth)) * 2;
+    float q = sqrtf(powf(2, octaves)) / (powf(2, octaves) - 1);
+
+    float omega = 2 * M_PI * center_freq / sample_freq;
+    float alpha = sinf(omega) / (2 * q);
+    float a = powf(10, -attenuation_dB / 40);
+    float a0 = 1 + alpha;
+
+    ret.b0 = (1 + alpha * sq(a)) / a0;
+    ret.b1 = -2 * cosf(omega) / a0;
+    ret.b2 = (1 - alpha * sq(a)) / a0;
+    ret.a1 = ret.b1;
+    ret.a2 = (1 - alpha) / a0;
+    return true;
+}
@@ -0,0 +1,131 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file   BiquadFilterBank.h
+/// @brief  A cascade of second order sections with coefficients computed
+///         once when a stage is configured, e.g. several notches ahead of a
+///         low pass filter.
+#pragma once
+
+#include <inttypes.h>
+
+#include <AP_Math/AP_Math.h>
+
+/*
+  normalised coefficients of one second order section:
+
+    H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ */
+struct BiquadCoefficients {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+
+    // second order Butterworth low pass, as used by LowPassFilter2p
+    static bool lowpass(float sample_freq, float cutoff_freq, BiquadCoefficients &ret);
+
+    // notch of the given -3dB bandwidth, attenuating the centre frequency
+    // by attenuation_dB
+    static bool notch(float sample_freq, float center_freq, float bandwidth,
+                      float attenuation_dB, BiquadCoefficients &ret);
+};
+
+template <class T, uint8_t STAGES>
+class CascadedBiquadFilter {
+public:
+    CascadedBiquadFilter();
+
+    // set the coefficients of a stage and enable it
+    void set_stage(uint8_t stage, const BiquadCoefficients &coefficients);
+
+    // stop applying a stage; disabled stages cost nothing in apply()
+    void disable_stage(uint8_t stage);
+
+    bool stage_enabled(uint8_t stage) const { return (_enabled_mask & (1U << stage)) != 0; }
+
+    // run a sample through all enabled stages in order
+    T apply(const T &sample);
+
+    // clear the delay elements of all stages
+    void reset();
+
+private:
+    BiquadCoefficients _coefficients[STAGES];
+    uint8_t _enabled_mask;
+
+    // transposed direct form II state
+    T _z1[STAGES];
+    T _z2[STAGES];
+};
+
+template <class T, uint8_t STAGES>
+CascadedBiquadFilter<T, STAGES>::CascadedBiquadFilter() :
+    _enabled_mask(0)
+{
+    static_assert(STAGES <= 8, "stage mask is 8 bits");
+    reset();
+}
+
+template <class T, uint8_t STAGES>
+void CascadedBiquadFilter<T, STAGES>::set_stage(uint8_t stage, const BiquadCoefficients &coefficients)
+{
+    if (stage >= STAGES) {
+        return;
+    }
+    _coefficients[stage] = coefficients;
+    if (!stage_enabled(stage)) {
+        _z1[stage] = _z2[stage] = T();
+    }
+    _enabled_mask |= (1U << stage);
+}
+
+template <class T, uint8_t STAGES>
+void CascadedBiquadFilter<T, STAGES>::disable_stage(uint8_t stage)
+{
+    if (stage >= STAGES) {
+        return;
+    }
+    _enabled_mask &= ~(1U << stage);
+}
+
+template <class T, uint8_t STAGES>
+T CascadedBiquadFilter<T, STAGES>::apply(const T &sample)
+{
+    T x = sample;
+
+    for (uint8_t stage = 0; stage < STAGES; stage++) {
+        if (!stage_enabled(stage)) {
+            continue;
+        }
+        const BiquadCoefficients &c = _coefficients[stage];
+        const T y = x * c.b0 + _z1[stage];
+        _z1[stage] = x * c.b1 - y * c.a1 + _z2[stage];
+        _z2[stage] = x * c.b2 - y * c.a2;
+        x = y;
+    }
+
+    return x;
+}
+
+template <class T, uint8_t STAGES>
+void CascadedBiquadFilter<T, STAGES>::reset()
+{
+    for (uint8_t stage = 0; stage < STAGES; stage++) {
+        _z1[stage] = _z2[stage] = T();
+    }
+}
@@ -0,0 +1,122 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file   LowPassFilter2pBank.h
+/// @brief  A bank of second order low pass filters on 3-axis samples, one
+///         per sensor instance.
+///
+/// Gives the same output as one LowPassFilter2pVector3f per instance, but
+/// the coefficients and delay elements are held as arrays across the
+/// instances rather than per object, apply() is inline and a filter that
+/// is switched off is a flag instead of two float compares per sample.
+/// The low pass numerator is symmetric (b1 = 2*b0, b2 = b0), so only b0 is
+/// kept.
+#pragma once
+
+#include <string.h>
+
+#include <AP_Math/AP_Math.h>
+
+#include "LowPassFilter2p.h"
+
+template <uint8_t N>
+class LowPassFilter2pVector3fBank {
+public:
+    LowPassFilter2pVector3fBank();
+
+    // change parameters of one instance; a zero frequency passes samples
+    // through unfiltered
+    void set_cutoff_frequency(uint8_t instance, float sample_freq, float cutoff_freq);
+
+    float get_cutoff_freq(uint8_t instance) const { return _cutoff_freq[instance]; }
+    float get_sample_freq(uint8_t instance) const { return _sample_freq[instance]; }
+
+    // filter one sample of one instance
+    inline Vector3f apply(uint8_t instance, const Vector3f &sample);
+
+    // clear the delay elements of one instance
+    void reset(uint8_t instance);
+
+private:
+    float _cutoff_freq[N];
+    float _sample_freq[N];
+    bool _enabled[N];
+
+    float _b0[N];
+    float _a1[N];
+    float _a2[N];
+
+    // delay elements, axis major
+    float _delay_element_1[3][N];
+    float _delay_element_2[3][N];
+};
+
+template <uint8_t N>
+LowPassFilter2pVector3fBank<N>::LowPassFilter2pVector3fBank()
+{
+    memset(this, 0, sizeof(*this));
+}
+
+template <uint8_t N>
+void LowPassFilter2pVector3fBank<N>::set_cutoff_frequency(uint8_t instance, float sample_freq, float cutoff_freq)
+{
+    _cutoff_freq[instance] = cutoff_freq;
+    _sample_freq[instance] = sample_freq;
+    _enabled[instance] = !is_zero(cutoff_freq) && !is_zero(sample_freq);
+    if (!_enabled[instance]) {
+        return;
+    }
+
+    DigitalBiquadFilter<float>::biquad_params params;
+    DigitalBiquadFilter<float>::compute_params(sample_freq, cutoff_freq, params);
+    _b0[instance] = params.b0;
+    _a1[instance] = params.a1;
+    _a2[instance] = params.a2;
+}
+
+template <uint8_t N>
+inline Vector3f LowPassFilter2pVector3fBank<N>::apply(uint8_t instance, const Vector3f &sample)
+{
+    if (!_enabled[instance]) {
+        return sample;
+    }
+
+    const float b0 = _b0[instance];
+    const float a1 = _a1[instance];
+    const float a2 = _a2[instance];
+    const float in[3] = { sample.x, sample.y, sample.z };
+    float out[3];
+
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        const float d1 = _delay_element_1[axis][instance];
+        const float d2 = _delay_element_2[axis][instance];
+        const float d0 = in[axis] - d1 * a1 - d2 * a2;
+        out[axis] = (d0 + 2.0f * d1 + d2) * b0;
+        _delay_element_2[axis][instance] = d1;
+        _delay_element_1[axis][instance] = d0;
+    }
+
+    return Vector3f(out[0], out[1], out[2]);
+}
+
+template <uint8_t N>
+void LowPassFilter2pVector3fBank<N>::reset(uint8_t instance)
+{
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        _delay_element_1[axis][instance] = 0;
+        _delay_element_2[axis][instance] = 0;
+    }
+}
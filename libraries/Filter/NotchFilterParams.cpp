@@ -0,0 +1,60 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "NotchFilterParams.h"
+
+const AP_Param::GroupInfo NotchFilterParams::var_info[] = {
+    // @Param: ENABLE
+    // @DisplayName: Enable notch filter
+    // @Description: Enable notch filter
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("ENABLE", 0, NotchFilterParams, _enable, 0),
+
+    // @Param: FREQ
+    // @DisplayName: Notch filter center frequency
+    // @Description: Notch center frequency in Hz, typically the frequency of the motor or propeller vibration to remove
+    // @Range: 10 400
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("FREQ", 1, NotchFilterParams, _center_freq_hz, 80),
+
+    // @Param: BW
+    // @DisplayName: Notch filter bandwidth
+    // @Description: Notch bandwidth in Hz, must be less than twice the center frequency
+    // @Range: 5 100
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("BW", 2, NotchFilterParams, _bandwidth_hz, 20),
+
+    // @Param: ATT
+    // @DisplayName: Notch filter attenuation
+    // @Description: Notch attenuation in dB at the center frequency
+    // @Range: 5 30
+    // @Units: dB
+    // @User: Advanced
+    AP_GROUPINFO("ATT", 3, NotchFilterParams, _attenuation_dB, 15),
+
+    AP_GROUPEND
+};
+
+bool NotchFilterParams::get_coefficients(float sample_freq, BiquadCoefficients &ret) const
+{
+    if (!enabled()) {
+        return false;
+    }
+    return BiquadCoefficients::notch(sample_freq, _center_freq_hz, _bandwidth_hz,
+                                     _attenuation_dB, ret);
+}
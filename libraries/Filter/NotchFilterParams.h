@@ -0,0 +1,47 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <AP_Param/AP_Param.h>
+
+#include "BiquadFilterBank.h"
+
+/*
+  user settings for one notch stage of a CascadedBiquadFilter
+ */
+class NotchFilterParams {
+public:
+    NotchFilterParams(void) {
+        AP_Param::setup_object_defaults(this, var_info);
+    }
+
+    bool enabled(void) const { return _enable != 0; }
+    float center_freq_hz(void) const { return _center_freq_hz; }
+    float bandwidth_hz(void) const { return _bandwidth_hz; }
+    float attenuation_dB(void) const { return _attenuation_dB; }
+
+    // coefficients for the given sample rate; false if the notch is
+    // disabled or the settings can't be realised at that rate
+    bool get_coefficients(float sample_freq, BiquadCoefficients &ret) const;
+
+    static const struct AP_Param::GroupInfo var_info[];
+
+private:
+    AP_Int8 _enable;
+    AP_Float _center_freq_hz;
+    AP_Float _bandwidth_hz;
+    AP_Float _attenuation_dB;
+};
@@ -0,0 +1,82 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <Filter/BiquadFilterBank.h>
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/LowPassFilter2pBank.h>
+
+/*
+ * per sample cost of the filters on the IMU path, at the usual 1kHz
+ * sample rate with a 20Hz cutoff. The input alternates so the delay
+ * elements never settle.
+ */
+static const float sample_freq = 1000;
+static const float cutoff_freq = 20;
+
+static void BM_LowPassFilter2pFloat(benchmark::State& state)
+{
+    LowPassFilter2pFloat filter(sample_freq, cutoff_freq);
+    float sample = 1.0f;
+
+    while (state.KeepRunning()) {
+        float out = filter.apply(sample);
+        gbenchmark_escape(&out);
+        sample = -sample;
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2pFloat);
+
+static void BM_LowPassFilter2pVector3f(benchmark::State& state)
+{
+    LowPassFilter2pVector3f filter(sample_freq, cutoff_freq);
+    Vector3f sample(1.0f, -2.0f, 9.8f);
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply(sample);
+        gbenchmark_escape(&out);
+        sample = -sample;
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2pVector3f);
+
+static void BM_LowPassFilter2pVector3fBank(benchmark::State& state)
+{
+    LowPassFilter2pVector3fBank<3> filter;
+    for (uint8_t i = 0; i < 3; i++) {
+        filter.set_cutoff_frequency(i, sample_freq, cutoff_freq);
+    }
+    Vector3f sample(1.0f, -2.0f, 9.8f);
+
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < 3; i++) {
+            Vector3f out = filter.apply(i, sample);
+            gbenchmark_escape(&out);
+        }
+        sample = -sample;
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2pVector3fBank);
+
+static void BM_CascadedBiquadNotches(benchmark::State& state)
+{
+    CascadedBiquadFilter<Vector3f, 2> filter;
+    BiquadCoefficients coefficients;
+    BiquadCoefficients::notch(sample_freq, 80, 20, 15, coefficients);
+    filter.set_stage(0, coefficients);
+    BiquadCoefficients::notch(sample_freq, 160, 40, 15, coefficients);
+    filter.set_stage(1, coefficients);
+    Vector3f sample(1.0f, -2.0f, 9.8f);
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply(sample);
+        gbenchmark_escape(&out);
+        sample = -sample;
+    }
+}
+
+BENCHMARK(BM_CascadedBiquadNotches);
+
+BENCHMARK_MAIN()
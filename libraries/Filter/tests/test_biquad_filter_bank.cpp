@@ -0,0 +1,77 @@
+#include <AP_gtest.h>
+
+#include <Filter/BiquadFilterBank.h>
+#include <Filter/LowPassFilter2p.h>
+
+static const float sample_freq = 1000;
+
+// peak output amplitude of a filter over the last half of a sine input
+template <class F>
+static float sine_response(F &filter, float freq)
+{
+    float peak = 0;
+    for (uint16_t i = 0; i < 2000; i++) {
+        float out = filter.apply(sinf(2 * M_PI * freq * i / sample_freq));
+        if (i >= 1000) {
+            peak = MAX(peak, fabsf(out));
+        }
+    }
+    return peak;
+}
+
+TEST(BiquadFilterBankTest, LowPassMatchesLowPassFilter2p)
+{
+    CascadedBiquadFilter<float, 1> bank;
+    BiquadCoefficients c;
+    ASSERT_TRUE(BiquadCoefficients::lowpass(sample_freq, 20, c));
+    bank.set_stage(0, c);
+
+    LowPassFilter2pFloat lpf(sample_freq, 20);
+
+    for (uint16_t i = 0; i < 500; i++) {
+        float in = sinf(i * 0.1f) + (i % 7);
+        EXPECT_NEAR(lpf.apply(in), bank.apply(in), 1.0e-4f);
+    }
+}
+
+TEST(BiquadFilterBankTest, Notch)
+{
+    CascadedBiquadFilter<float, 2> bank;
+    BiquadCoefficients c;
+    ASSERT_TRUE(BiquadCoefficients::notch(sample_freq, 100, 20, 20, c));
+    bank.set_stage(1, c);
+
+    // 20dB down at the centre frequency, close to unity well away from it
+    EXPECT_NEAR(0.1f, sine_response(bank, 100), 0.01f);
+    bank.reset();
+    EXPECT_NEAR(1.0f, sine_response(bank, 10), 0.02f);
+    bank.reset();
+    EXPECT_NEAR(1.0f, sine_response(bank, 250), 0.02f);
+}
+
+TEST(BiquadFilterBankTest, DisabledStagesPassThrough)
+{
+    CascadedBiquadFilter<Vector3f, 3> bank;
+    Vector3f v(1, -2, 3);
+    EXPECT_EQ(v, bank.apply(v));
+
+    BiquadCoefficients c;
+    ASSERT_TRUE(BiquadCoefficients::notch(sample_freq, 100, 20, 20, c));
+    bank.set_stage(2, c);
+    EXPECT_TRUE(bank.stage_enabled(2));
+    bank.disable_stage(2);
+    EXPECT_FALSE(bank.stage_enabled(2));
+    EXPECT_EQ(v, bank.apply(v));
+}
+
+TEST(BiquadFilterBankTest, InvalidSettings)
+{
+    BiquadCoefficients c;
+    EXPECT_FALSE(BiquadCoefficients::lowpass(sample_freq, 0, c));
+    EXPECT_FALSE(BiquadCoefficients::lowpass(sample_freq, 600, c));
+    EXPECT_FALSE(BiquadCoefficients::notch(sample_freq, 600, 20, 20, c));
+    EXPECT_FALSE(BiquadCoefficients::notch(sample_freq, 100, 250, 20, c));
+    EXPECT_FALSE(BiquadCoefficients::notch(sample_freq, 100, 20, 0, c));
+}
+
+AP_GTEST_MAIN()
@@ -23,6 +23,12 @@
 #define CHECK_PAYLOAD_SIZE(id) if (comm_get_txspace(chan) < packet_overhead()+MAVLINK_MSG_ID_ ## id ## _LEN) return false
 #define CHECK_PAYLOAD_SIZE2(id) if (!HAVE_PAYLOAD_SPACE(chan, id)) return false
 
+// number of missed log ranges that can be queued for resending
+#define GCS_LOG_RESEND_MAX 8
+
+// log transfers smaller than this are not worth a throughput report
+#define GCS_LOG_REPORT_MIN_BYTES 65536
+
 #if HAL_CPU_CLASS <= HAL_CPU_CLASS_150 || CONFIG_HAL_BOARD == HAL_BOARD_SITL
     #define GCS_MAVLINK_PAYLOAD_STATUS_CAPACITY          5
 #else
@@ -348,6 +354,18 @@ private:
     // start page of log data
     uint16_t _log_data_page;
 
+    // ranges the GCS asked for again during a transfer, sent ahead of
+    // the rest of the log
+    struct {
+        uint32_t ofs;
+        uint32_t remaining;
+    } _log_resend[GCS_LOG_RESEND_MAX];
+    uint8_t _log_resend_count;
+
+    // transfer start time and bytes sent, for the throughput report
+    uint32_t _log_data_start_ms;
+    uint32_t _log_data_sent;
+
     // deferred message handling
     enum ap_message deferred_messages[MSG_RETRY_DEFERRED];
     uint8_t next_deferred_message;
@@ -385,6 +403,7 @@ private:
     void handle_log_request_end(mavlink_message_t *msg, DataFlash_Class &dataflash);
     void handle_log_send_listing(DataFlash_Class &dataflash);
     bool handle_log_send_data(DataFlash_Class &dataflash);
+    void handle_log_send_complete(void);
 
 
     void lock_channel(mavlink_channel_t chan, bool lock);
@@ -998,32 +998,49 @@ GCS_MAVLINK::update(run_cli_fn run_cli)
     mavlink_status_t status;
     status.packet_rx_drop_count = 0;
 
-    // process received bytes
+    // process received bytes, a contiguous run at a time
     uint16_t nbytes = comm_get_available(chan);
-    for (uint16_t i=0; i<nbytes; i++)
-    {
-        uint8_t c = comm_receive_ch(chan);
-
-        if (run_cli) {
-            /* allow CLI to be started by hitting enter 3 times, if no
-             *  heartbeat packets have been received */
-            if ((mavlink_active==0) && (AP_HAL::millis() - _cli_timeout) < 20000 && 
-                comm_is_idle(chan)) {
+    uint8_t buf[64];
+    bool cli_started = false;
+    while (nbytes > 0 && !cli_started) {
+        /* allow CLI to be started by hitting enter 3 times, if no
+         *  heartbeat packets have been received. Until then bytes are
+         *  taken one at a time, so those after the third enter are
+         *  left on the port for the CLI */
+        const bool cli_allowed = run_cli && (mavlink_active==0) &&
+            (AP_HAL::millis() - _cli_timeout) < 20000;
+        const uint8_t *data;
+        uint32_t n = _port->read_span(data, buf, cli_allowed ? 1 : MIN(nbytes, sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
+        for (uint32_t i=0; i<n; i++) {
+            uint8_t c = data[i];
+
+            if (cli_allowed && comm_is_idle(chan)) {
                 if (c == '\n' || c == '\r') {
                     crlf_count++;
                 } else {
                     crlf_count = 0;
                 }
                 if (crlf_count == 3) {
-                    run_cli(_port);
+                    cli_started = true;
+                    break;
                 }
             }
-        }
 
-        // Try to get a new message
-        if (mavlink_parse_char(chan, c, &msg, &status)) {
-            packetReceived(status, msg);
+            // Try to get a new message
+            if (mavlink_parse_char(chan, c, &msg, &status)) {
+                packetReceived(status, msg);
+            }
         }
+        _port->release_span();
+        nbytes -= n;
+    }
+
+    if (cli_started) {
+        // the CLI takes over the port
+        run_cli(_port);
     }
 
     if (!waypoint_receiving) {
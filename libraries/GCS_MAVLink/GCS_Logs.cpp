@@ -88,8 +88,23 @@ void GCS_MAVLINK::handle_log_request_data(mavlink_message_t *msg, DataFlash_Clas
     mavlink_msg_log_request_data_decode(msg, &packet);
 
     _log_listing = false;
+
+    if (_log_sending && _log_num_data == packet.id &&
+        packet.ofs < _log_data_offset &&
+        _log_resend_count < GCS_LOG_RESEND_MAX) {
+        // the GCS missed part of what we already sent. Queue that
+        // range and carry on streaming the rest of the log
+        _log_resend[_log_resend_count].ofs = packet.ofs;
+        _log_resend[_log_resend_count].remaining = MIN(packet.count, _log_data_offset - packet.ofs);
+        _log_resend_count++;
+        handle_log_send(dataflash);
+        return;
+    }
+
     if (!_log_sending || _log_num_data != packet.id) {
         _log_sending = false;
+        _log_data_start_ms = AP_HAL::millis();
+        _log_data_sent = 0;
 
         uint16_t num_logs = dataflash.get_num_logs();
         if (packet.id > num_logs || packet.id < 1) {
@@ -105,6 +120,8 @@ void GCS_MAVLINK::handle_log_request_data(mavlink_message_t *msg, DataFlash_Clas
         dataflash.get_log_boundaries(packet.id, _log_data_page, end);
     }
 
+    // ranges queued for resending are stale once the offset is rewound
+    _log_resend_count = 0;
     _log_data_offset = packet.ofs;
     if (_log_data_offset >= _log_data_size) {
         _log_data_remaining = 0;
@@ -138,6 +155,7 @@ void GCS_MAVLINK::handle_log_request_end(mavlink_message_t *msg, DataFlash_Class
     mavlink_log_request_end_t packet;
     mavlink_msg_log_request_end_decode(msg, &packet);
     _log_sending = false;
+    dataflash.end_log_data();
 }
 
 /**
@@ -152,28 +170,24 @@ void GCS_MAVLINK::handle_log_send(DataFlash_Class &dataflash)
         return;
     }
 
+    /*
+      on links that can take it we fill all the txspace on each call,
+      with the data coming from the DataFlash read-ahead buffer. Radios
+      without flow control get one packet per call so they are not
+      swamped
+     */
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     // assume USB speeds in SITL for the purposes of log download
-    const uint8_t num_sends = 40;
+    const bool streaming = true;
 #else
-    uint8_t num_sends = 1;
-    if (chan == MAVLINK_COMM_0 && hal.gpio->usb_connected()) {
-        // when on USB we can send a lot more data
-        num_sends = 40;
-    } else if (have_flow_control()) {
-    #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
-        num_sends = 80;
-    #else
-        num_sends = 10;
-    #endif
-    }
+    const bool streaming = (chan == MAVLINK_COMM_0 && hal.gpio->usb_connected()) || have_flow_control();
 #endif
 
-    for (uint8_t i=0; i<num_sends; i++) {
-        if (_log_sending) {
-            if (!handle_log_send_data(dataflash)) break;
+    do {
+        if (!handle_log_send_data(dataflash)) {
+            break;
         }
-    }
+    } while (streaming && _log_sending);
 }
 
 /**
@@ -219,14 +233,19 @@ bool GCS_MAVLINK::handle_log_send_data(DataFlash_Class &dataflash)
         return false;
     }
 
+    // missed ranges go out before the rest of the log
+    const bool resend = (_log_resend_count > 0);
+    uint32_t &ofs = resend ? _log_resend[0].ofs : _log_data_offset;
+    uint32_t &remaining = resend ? _log_resend[0].remaining : _log_data_remaining;
+
     int16_t ret = 0;
-    uint32_t len = _log_data_remaining;
+    uint32_t len = remaining;
 	mavlink_log_data_t packet;
 
     if (len > 90) {
         len = 90;
     }
-    ret = dataflash.get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
+    ret = dataflash.get_log_data(_log_num_data, _log_data_page, ofs, len, packet.data);
     if (ret < 0) {
         // report as EOF on error
         ret = 0;
@@ -235,7 +254,7 @@ bool GCS_MAVLINK::handle_log_send_data(DataFlash_Class &dataflash)
         memset(&packet.data[ret], 0, 90-ret);
     }
 
-    packet.ofs = _log_data_offset;
+    packet.ofs = ofs;
     packet.id = _log_num_data;
     packet.count = ret;
     _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LOG_DATA, (const char *)&packet, 
@@ -243,10 +262,37 @@ bool GCS_MAVLINK::handle_log_send_data(DataFlash_Class &dataflash)
                                     MAVLINK_MSG_ID_LOG_DATA_LEN,
                                     MAVLINK_MSG_ID_LOG_DATA_CRC);
 
-    _log_data_offset += len;
-    _log_data_remaining -= len;
-    if (ret < 90 || _log_data_remaining == 0) {
+    _log_data_sent += ret;
+    ofs += len;
+    remaining -= len;
+    if (ret < 90 || remaining == 0) {
+        if (resend) {
+            _log_resend_count--;
+            memmove(&_log_resend[0], &_log_resend[1], _log_resend_count * sizeof(_log_resend[0]));
+        } else {
+            _log_data_remaining = 0;
+        }
+    }
+    if (_log_data_remaining == 0 && _log_resend_count == 0) {
         _log_sending = false;
+        dataflash.end_log_data();
+        handle_log_send_complete();
     }
     return true;
 }
+
+/**
+   report the throughput of a finished log transfer
+ */
+void GCS_MAVLINK::handle_log_send_complete(void)
+{
+    if (_log_data_sent < GCS_LOG_REPORT_MIN_BYTES) {
+        return;
+    }
+    const uint32_t dt_ms = MAX(AP_HAL::millis() - _log_data_start_ms, 1U);
+    send_statustext_chan(MAV_SEVERITY_INFO, chan, "Log %u: %ukB in %ums, %ukB/s",
+                         (unsigned)_log_num_data,
+                         (unsigned)(_log_data_sent / 1024),
+                         (unsigned)dt_ms,
+                         (unsigned)((uint64_t)_log_data_sent * 1000 / 1024 / dt_ms));
+}
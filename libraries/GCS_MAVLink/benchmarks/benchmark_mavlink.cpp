@@ -0,0 +1,83 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <GCS_MAVLink/GCS_MAVLink.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+ * cost of the generated MAVLink code for two of the most frequently
+ * streamed messages: packing with the CRC, copying into a send buffer and
+ * parsing the bytes back one at a time as the GCS link does
+ */
+static void BM_MAVLinkPackAttitude(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint32_t t = 0;
+
+    while (state.KeepRunning()) {
+        uint16_t len = mavlink_msg_attitude_pack_chan(1, 1, MAVLINK_COMM_0, &msg,
+                                                      t++, 0.1f, -0.2f, 1.5f,
+                                                      0.01f, 0.02f, -0.03f);
+        gbenchmark_escape(&len);
+        gbenchmark_escape(&msg);
+    }
+}
+
+BENCHMARK(BM_MAVLinkPackAttitude);
+
+static void BM_MAVLinkPackGlobalPositionInt(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint32_t t = 0;
+
+    while (state.KeepRunning()) {
+        uint16_t len = mavlink_msg_global_position_int_pack_chan(1, 1, MAVLINK_COMM_0, &msg,
+                                                                 t++, -353632620, 1491652300,
+                                                                 584000, 10000, 120, -35, 8, 9000);
+        gbenchmark_escape(&len);
+        gbenchmark_escape(&msg);
+    }
+}
+
+BENCHMARK(BM_MAVLinkPackGlobalPositionInt);
+
+static void BM_MAVLinkToSendBuffer(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    mavlink_msg_attitude_pack_chan(1, 1, MAVLINK_COMM_0, &msg,
+                                   1000, 0.1f, -0.2f, 1.5f, 0.01f, 0.02f, -0.03f);
+
+    while (state.KeepRunning()) {
+        uint16_t len = mavlink_msg_to_send_buffer(buf, &msg);
+        gbenchmark_escape(&len);
+        gbenchmark_escape(buf);
+    }
+}
+
+BENCHMARK(BM_MAVLinkToSendBuffer);
+
+static void BM_MAVLinkParseAttitude(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    mavlink_msg_attitude_pack_chan(1, 1, MAVLINK_COMM_1, &msg,
+                                   1000, 0.1f, -0.2f, 1.5f, 0.01f, 0.02f, -0.03f);
+    uint16_t len = mavlink_msg_to_send_buffer(buf, &msg);
+
+    while (state.KeepRunning()) {
+        mavlink_message_t rx;
+        mavlink_status_t status;
+        uint8_t parsed = 0;
+        for (uint16_t i = 0; i < len; i++) {
+            parsed |= mavlink_parse_char(MAVLINK_COMM_1, buf[i], &rx, &status);
+        }
+        gbenchmark_escape(&parsed);
+        gbenchmark_escape(&rx);
+    }
+}
+
+BENCHMARK(BM_MAVLinkParseAttitude);
+
+BENCHMARK_MAIN()